@@ -12,6 +12,8 @@ class IDb {
 
   virtual bool AddUser(QString user, QString pass) = 0;
   virtual bool CheckUser(QString user, QString pass) = 0;
+
+  virtual bool GetCommsConf(QString& ip, int& port) = 0;
 };
 
 #endif  // IDB_H
@@ -0,0 +1,50 @@
+#ifndef ITRANSPORT_H
+#define ITRANSPORT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+
+class ITransport {
+ public:
+  // Called from the transport thread, once per complete inbound message.
+  using Receiver = std::function<void(std::string_view message)>;
+  // Called from the transport thread when the connection fails or drops.
+  using ClosedHandler = std::function<void(const std::string& reason)>;
+
+  // A piece of an outbound message. Shared and static pieces are written
+  // from where they are, without being copied, the owner keeping shared
+  // bytes alive until then; other pieces are copied by Send.
+  struct Segment {
+    std::string_view data;
+    std::shared_ptr<const std::string> owner;
+    bool is_static = false;
+
+    static Segment Copied(std::string_view data) { return {data, {}, false}; }
+    static Segment Static(std::string_view data) { return {data, {}, true}; }
+    static Segment Shared(std::shared_ptr<const std::string> owner) {
+      std::string_view data(*owner);
+      return {data, std::move(owner), false};
+    }
+  };
+
+  ITransport() = default;
+  virtual ~ITransport() = default;
+
+  virtual void SetReceiver(Receiver receiver) = 0;
+  virtual void SetClosedHandler(ClosedHandler handler) = 0;
+
+  virtual bool Connect(const std::string& ip, std::uint16_t port) = 0;
+  virtual void Disconnect() = 0;
+  virtual bool IsConnected() const = 0;
+
+  // Thread safe; queues the message and returns without blocking.
+  virtual bool Send(std::string_view message) = 0;
+  // Thread safe; queues the message made of the segments, in order.
+  virtual bool Send(const Segment* segments, std::size_t count) = 0;
+};
+
+#endif  // ITRANSPORT_H
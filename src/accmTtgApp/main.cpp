@@ -1,7 +1,10 @@
+#include <QCommandLineParser>
+#include <QDebug>
 #include <QGuiApplication>
 #include <QQmlApplicationEngine>
 #include <QQmlContext>
 #include <QQuickWindow>
+#include <iostream>
 #include <memory>
 
 #include "BusinessLogic.h"
@@ -17,7 +20,148 @@ int main(int argc, char *argv[]) {
 
   QQmlApplicationEngine engine;
 
-  std::shared_ptr<IBusiness> business_logic(new BusinessLogic);
+  QCommandLineParser parser;
+  parser.addHelpOption();
+  QCommandLineOption standInOption(
+      "stand-in", "Answer on the commsConf port instead of an ACCM.");
+  QCommandLineOption errorRateOption(
+      "stand-in-error-rate",
+      "Fraction of the observations rejected by the stand-in.", "rate", "0");
+  QCommandLineOption ackDelayOption(
+      "stand-in-ack-delay",
+      "Delay of the stand-in acknowledgments in microseconds.", "delay", "0");
+  QCommandLineOption errorCodeOption(
+      "stand-in-error-code",
+      "ACK.error_detail_cd of the observations rejected by the stand-in.",
+      "code", "202");
+  QCommandLineOption lossRateOption(
+      "stand-in-loss-rate",
+      "Fraction of the observations never answered by the stand-in.", "rate",
+      "0");
+  QCommandLineOption ackJitterOption(
+      "stand-in-ack-jitter",
+      "Random extra delay of the stand-in acknowledgments, up to that many"
+      " microseconds.",
+      "jitter", "0");
+  QCommandLineOption terminateOption(
+      "stand-in-terminate",
+      "Have the stand-in end the conversation once the device ends its"
+      " topic.");
+  QCommandLineOption standInValidateOption(
+      "stand-in-validate",
+      "Have the stand-in check the messages received against the POCT1-A"
+      " rules.");
+  QCommandLineOption validateOption(
+      "validate",
+      "Check the messages received from the ACCM against the POCT1-A rules.");
+  QCommandLineOption captureOption(
+      "capture", "Record the messages of the session into a file.", "file");
+  QCommandLineOption replayOption(
+      "replay", "Send the messages recorded in a capture file again.", "file");
+  QCommandLineOption replaySpeedOption(
+      "replay-speed",
+      "Speed of the replay relative to the capture; 0 for maximum speed.",
+      "factor", "1");
+  QCommandLineOption ioBackendOption(
+      "io-backend",
+      "I/O backend of the connections: epoll or io_uring (Linux 5.19 or later,"
+      " epoll otherwise).",
+      "backend", "epoll");
+  QCommandLineOption simulateOption(
+      "simulate-devices",
+      "Run that many simulated devices against the commsConf address, print"
+      " the results and the response latencies, and exit.",
+      "count");
+  QCommandLineOption observationsOption(
+      "simulate-observations", "Number of observations sent by each device.",
+      "count", "10");
+  QCommandLineOption windowOption(
+      "simulate-window",
+      "Number of observations in flight per simulated device.", "count", "1");
+  QCommandLineOption rateOption(
+      "simulate-rate",
+      "Observations per second sent by each simulated device; 0 to send them"
+      " as the window allows.",
+      "rate", "0");
+  QCommandLineOption totalRateOption(
+      "simulate-total-rate",
+      "Observations per second sent by all the simulated devices; overrides"
+      " --simulate-rate.",
+      "rate", "0");
+  QCommandLineOption ackTimeoutOption(
+      "simulate-ack-timeout",
+      "Time in microseconds a simulated device waits for a response before"
+      " sending again; 0 to wait forever.",
+      "timeout", "0");
+  QCommandLineOption taskThreadsOption(
+      "simulate-task-threads",
+      "Number of threads running the simulated conversations; 0 for one per"
+      " core.",
+      "count", "0");
+  QCommandLineOption durationOption(
+      "simulate-duration",
+      "Longest time in seconds the device simulation runs before its results"
+      " are printed as they are; 0 for no limit.",
+      "seconds", "300");
+  QCommandLineOption simulateValidateOption(
+      "simulate-validate",
+      "Have the simulated devices check the messages received against the"
+      " POCT1-A rules.");
+  parser.addOptions({standInOption, errorRateOption, ackDelayOption,
+                     errorCodeOption, lossRateOption, ackJitterOption,
+                     terminateOption, standInValidateOption, validateOption,
+                     captureOption, replayOption, replaySpeedOption,
+                     ioBackendOption, simulateOption, observationsOption,
+                     windowOption, rateOption, totalRateOption,
+                     ackTimeoutOption, taskThreadsOption, durationOption,
+                     simulateValidateOption});
+  parser.process(app);
+
+  bool valid_error_code = false;
+  int error_code = parser.value(errorCodeOption).toInt(&valid_error_code);
+  if (!valid_error_code || !accm::Ack::IsValidCode(error_code)) {
+    qDebug() << "Invalid stand-in error code "
+             << parser.value(errorCodeOption);
+    return 1;
+  }
+
+  auto *logic = new BusinessLogic;
+  if (parser.value(ioBackendOption) == "io_uring")
+    logic->SetIoBackend(EventLoop::Backend::IO_URING);
+  if (parser.isSet(standInOption)) {
+    ManagerSimulator::Policy policy;
+    policy.error_rate = parser.value(errorRateOption).toDouble();
+    policy.error_code = static_cast<accm::Ack::AckCode>(error_code);
+    policy.loss_rate = parser.value(lossRateOption).toDouble();
+    policy.ack_delay = parser.value(ackDelayOption).toUInt();
+    policy.ack_jitter = parser.value(ackJitterOption).toUInt();
+    policy.terminate_after_topic = parser.isSet(terminateOption);
+    policy.validate = parser.isSet(standInValidateOption);
+    logic->EnableStandIn(policy);
+  }
+  if (parser.isSet(validateOption)) logic->EnableValidation();
+  if (parser.isSet(captureOption) &&
+      !logic->EnableCapture(parser.value(captureOption).toStdString()))
+    qDebug() << "Cannot create the capture " << parser.value(captureOption);
+  if (parser.isSet(replayOption))
+    logic->EnableReplay(parser.value(replayOption).toStdString(),
+                        parser.value(replaySpeedOption).toDouble());
+  std::shared_ptr<IBusiness> business_logic(logic);
+  if (parser.isSet(simulateOption)) {
+    DeviceSimulator::Options options;
+    options.device_count = parser.value(simulateOption).toUInt();
+    options.observation_count = parser.value(observationsOption).toUInt();
+    options.window = parser.value(windowOption).toUInt();
+    options.rate = parser.value(rateOption).toDouble();
+    options.total_rate = parser.value(totalRateOption).toDouble();
+    options.ack_timeout = parser.value(ackTimeoutOption).toUInt();
+    options.task_thread_count = parser.value(taskThreadsOption).toUInt();
+    options.validate = parser.isSet(simulateValidateOption);
+    return logic->SimulateDevices(
+               options, parser.value(durationOption).toDouble(), std::cout)
+               ? 0
+               : 1;
+  }
   business_logic->StartUp();
 
   Dashboard dashboard(nullptr, business_logic);
@@ -0,0 +1,65 @@
+#include "AccmCode.h"
+#include <array>
+#include <mutex>
+
+namespace accm {
+namespace {
+/*!
+ * \brief Get the slot of the per-thread cache of interned texts. The codes
+ * repeated in every message are found there without locking the pool.
+ */
+const std::string*& CacheSlot(std::string_view text) {
+  thread_local std::array<const std::string*, 256> cache{};
+  return cache[std::hash<std::string_view>()(text) % cache.size()];
+}
+}  // namespace
+
+CodePool& CodePool::Instance() {
+  static CodePool pool;
+  return pool;
+}
+
+const std::string* CodePool::Intern(std::string_view text) {
+  const std::string*& slot = CacheSlot(text);
+  if (slot && *slot == text) return slot;
+
+  const std::string* interned = Find(text);
+  if (!interned) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto found = index_.find(text);
+    if (found != index_.end()) {
+      interned = &strings_[found->second];
+    } else if (strings_.size() < kCapacity) {
+      interned = &strings_.emplace_back(text);
+      index_.emplace(*interned, strings_.size() - 1);
+    } else {
+      return nullptr;
+    }
+  }
+  slot = interned;
+  return interned;
+}
+
+std::size_t CodePool::Size() const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  return strings_.size();
+}
+
+const std::string* CodePool::Find(std::string_view text) const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  auto found = index_.find(text);
+  return found == index_.end() ? nullptr : &strings_[found->second];
+}
+
+Code::Code(std::string_view text) {
+  if (text.empty()) return;
+  const std::string* interned = CodePool::Instance().Intern(text);
+  if (interned) {
+    // Aliasing an empty owner: copies do not touch any reference count.
+    text_ = std::shared_ptr<const std::string>(
+        std::shared_ptr<const std::string>(), interned);
+  } else {
+    text_ = std::make_shared<const std::string>(text);
+  }
+}
+}  // namespace accm
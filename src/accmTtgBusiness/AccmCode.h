@@ -0,0 +1,184 @@
+#pragma once
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace accm {
+/*!
+ * \brief The CodePool class interns the code values exchanged in POCT1-A
+ * messages (analyte ids, code sets, ack types, ...).
+ *
+ * Every distinct text is stored once and never released, so the pointer to
+ * an interned string identifies its text for the whole life of the process.
+ * The pool is bounded: once kCapacity texts have been interned, new texts are
+ * no longer added (see Code).
+ */
+class CodePool {
+ public:
+  /*!
+   * \brief Maximum number of interned texts.
+   */
+  static constexpr std::size_t kCapacity = 1 << 16;
+
+  /*!
+   * \brief Get the process-wide pool.
+   * \return The pool.
+   */
+  static CodePool& Instance();
+
+  /*!
+   * \brief Copy constructor is deleted.
+   */
+  CodePool(const CodePool&) = delete;
+  /*!
+   * \brief Assignment operator is deleted.
+   */
+  CodePool& operator=(const CodePool&) = delete;
+
+  /*!
+   * \brief Get the interned copy of a text, adding it if needed.
+   * \param text The text to intern. It must not be empty.
+   * \return The interned string; nullptr if the text is not interned and the
+   * pool is full.
+   */
+  const std::string* Intern(std::string_view text);
+  /*!
+   * \brief Get the number of interned texts.
+   * \return The number of interned texts.
+   */
+  std::size_t Size() const;
+
+ private:
+  CodePool() = default;
+
+  const std::string* Find(std::string_view text) const;
+
+ private:
+  mutable std::shared_mutex mutex_;
+  std::deque<std::string> strings_;
+  std::unordered_map<std::string_view, std::size_t> index_;
+};
+
+/*!
+ * \brief The Code class is an immutable text value backed by the CodePool.
+ *
+ * Copying a Code never allocates: interned texts are referenced without
+ * reference counting, and texts that did not fit in the pool are shared by
+ * all the copies. Since a text is either interned before any Code falls back
+ * to its own storage or never interned at all, two Codes are equal if and
+ * only if they point to the same interned string, unless both are
+ * non-interned.
+ */
+class Code {
+ public:
+  /*!
+   * \brief Default constructor. The code is empty.
+   */
+  Code() = default;
+  /*!
+   * \brief Constructor from a text.
+   * \param text The text of the code.
+   */
+  Code(std::string_view text);
+  /*!
+   * \brief Constructor from a text.
+   * \param text The text of the code.
+   */
+  Code(const std::string& text) : Code(std::string_view(text)) {}
+  /*!
+   * \brief Constructor from a text.
+   * \param text The null-terminated text of the code.
+   */
+  Code(const char* text) : Code(std::string_view(text)) {}
+
+  /*!
+   * \brief Get the text of the code.
+   * \return The text. It remains valid as long as this Code or a copy of it.
+   */
+  inline std::string_view View() const {
+    return text_ ? std::string_view(*text_) : std::string_view();
+  }
+  /*!
+   * \brief Get the text of the code.
+   * \return The text.
+   */
+  inline const std::string& Str() const {
+    static const std::string kEmpty;
+    return text_ ? *text_ : kEmpty;
+  }
+  /*!
+   * \brief Conversion to a text view.
+   */
+  inline operator std::string_view() const { return View(); }
+  /*!
+   * \brief Check if the text is empty.
+   * \return true if the text is empty; false otherwise.
+   */
+  inline bool empty() const { return !text_; }
+  /*!
+   * \brief Check if the text is held by the CodePool.
+   * \return true if the text is interned or empty; false otherwise.
+   */
+  inline bool IsInterned() const { return !text_ || text_.use_count() == 0; }
+
+  /*!
+   * \brief Overloading 'equal' operator.
+   * \param first The code to compare.
+   * \param second The code to compare with.
+   * \return true if both codes have the same text.
+   */
+  friend inline bool operator==(const Code& first, const Code& second) {
+    if (first.text_ == second.text_) return true;
+    if (first.IsInterned() || second.IsInterned()) return false;
+    return *first.text_ == *second.text_;
+  }
+  friend inline bool operator!=(const Code& first, const Code& second) {
+    return !(first == second);
+  }
+  /*!
+   * \brief Overloading 'less than' operator. Codes are ordered by their text,
+   * so that containers of codes keep the same order from one run to another.
+   * \param first The code to compare.
+   * \param second The code to compare with.
+   * \return true if the text of first is less than the text of second.
+   */
+  friend inline bool operator<(const Code& first, const Code& second) {
+    return first.text_ != second.text_ && first.View() < second.View();
+  }
+  friend inline bool operator==(const Code& code, std::string_view text) {
+    return code.View() == text;
+  }
+  friend inline bool operator!=(const Code& code, std::string_view text) {
+    return code.View() != text;
+  }
+  friend inline bool operator==(const Code& code, const std::string& text) {
+    return code.View() == text;
+  }
+  friend inline bool operator!=(const Code& code, const std::string& text) {
+    return code.View() != text;
+  }
+  friend inline bool operator==(const Code& code, const char* text) {
+    return code.View() == text;
+  }
+  friend inline bool operator!=(const Code& code, const char* text) {
+    return code.View() != text;
+  }
+
+ private:
+  std::shared_ptr<const std::string> text_;
+};
+}  // namespace accm
+
+namespace std {
+template <>
+struct hash<accm::Code> {
+  std::size_t operator()(const accm::Code& code) const {
+    return std::hash<std::string_view>()(code.View());
+  }
+};
+}  // namespace std
@@ -0,0 +1,146 @@
+#include "AccmDefinitions.h"
+#include "AccmReflection.h"
+
+namespace accm {
+bool Ack::IsValidType(std::string_view ack_type) {
+  AckType parsed;
+  return ParseType(ack_type, parsed);
+}
+
+bool Ack::ParseType(std::string_view code, AckType& type) {
+  return reflection::FromCode(code, type);
+}
+
+bool DeviceStaticCapabilities::ParseConnectionProfile(
+    std::string_view code, ConnectionProfileType& profile) {
+  return reflection::FromCode(code, profile);
+}
+
+bool DeviceStatus::ParseCondition(
+    std::string_view code, DeviceCondition& condition) {
+  return reflection::FromCode(code, condition);
+}
+
+bool EndOfTopic::ParseTopic(std::string_view code, Code& value) {
+  return reflection::FromCode(code, value);
+}
+
+bool Escape::IsValidCode(std::string_view esc_code) {
+  Code parsed;
+  return ParseCode(esc_code, parsed);
+}
+
+bool Escape::ParseCode(std::string_view code, Code& value) {
+  return reflection::FromCode(code, value);
+}
+
+bool Observation::IsValidMethod(std::string_view method) {
+  Method parsed;
+  return ParseMethod(method, parsed);
+}
+
+bool Observation::ParseMethod(std::string_view code, Method& method) {
+  return reflection::FromCode(code, method);
+}
+
+bool Observation::IsQualitativeValue(std::string_view value) {
+  Qualitative parsed;
+  return ParseQualitativeValue(value, parsed);
+}
+
+bool Observation::ParseQualitativeValue(
+    std::string_view code, Qualitative& value) {
+  return reflection::FromCode(code, value);
+}
+
+bool Observation::IsValidStatus(std::string_view status) {
+  Status parsed;
+  return ParseStatus(status, parsed);
+}
+
+bool Observation::ParseStatus(std::string_view code, Status& status) {
+  return reflection::FromCode(code, status);
+}
+
+bool Observation::IsValidInterpretation(std::string_view inter) {
+  Interpretation parsed;
+  return ParseInterpretation(inter, parsed);
+}
+
+bool Observation::ParseInterpretation(
+    std::string_view code, Interpretation& interpretation) {
+  return reflection::FromCode(code, interpretation);
+}
+
+bool Patient::IsValidGender(std::string_view gender) {
+  Gender parsed;
+  return ParseGender(gender, parsed);
+}
+
+bool Patient::ParseGender(std::string_view code, Gender& gender) {
+  return reflection::FromCode(code, gender);
+}
+
+bool Request::IsValidCode(std::string_view req_code) {
+  Type parsed;
+  return ParseCode(req_code, parsed);
+}
+
+bool Request::ParseCode(std::string_view code, Type& type) {
+  return reflection::FromCode(code, type);
+}
+
+bool Specimen::IsValidSource(std::string_view source) {
+  Source parsed;
+  return ParseSource(source, parsed);
+}
+
+bool Specimen::ParseSource(std::string_view code, Source& source) {
+  return reflection::FromCode(code, source);
+}
+
+bool Specimen::IsValidType(std::string_view type) {
+  Type parsed;
+  return ParseType(type, parsed);
+}
+
+bool Specimen::ParseType(std::string_view code, Type& type) {
+  return reflection::FromCode(code, type);
+}
+
+bool Service::IsValidRole(std::string_view role) {
+  Role parsed;
+  return ParseRole(role, parsed);
+}
+
+bool Service::ParseRole(std::string_view code, Role& role) {
+  return reflection::FromCode(code, role);
+}
+
+bool Service::IsValidStatus(std::string_view status) {
+  Status parsed;
+  return ParseStatus(status, parsed);
+}
+
+bool Service::ParseStatus(std::string_view code, Status& status) {
+  return reflection::FromCode(code, status);
+}
+
+bool Service::IsValidReason(std::string_view reason) {
+  Reason parsed;
+  return ParseReason(reason, parsed);
+}
+
+bool Service::ParseReason(std::string_view code, Reason& reason) {
+  return reflection::FromCode(code, reason);
+}
+
+bool Terminate::IsValidReason(std::string_view trm_reason) {
+  Reason parsed;
+  return ParseReason(trm_reason, parsed);
+}
+
+bool Terminate::ParseReason(std::string_view code, Reason& reason) {
+  return reflection::FromCode(code, reason);
+}
+}  // namespace accm
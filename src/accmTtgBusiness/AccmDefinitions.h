@@ -1,11 +1,22 @@
 #pragma once
-#include <list>
+#include <cstddef>
+#include <memory_resource>
 #include <optional>
 #include <set>
 #include <string>
+#include <string_view>
 #include <thread>
+#include <utility>
+#include <vector>
+#include "AccmCode.h"
 
 namespace accm {
+/*!
+ * \brief The allocator used by the allocator-aware structs (CE, Observation
+ * and Service) for their repeated fields.
+ */
+using Allocator = std::pmr::polymorphic_allocator<std::byte>;
+
 /*!
  * \brief The NullCode enum
  */
@@ -33,27 +44,20 @@ struct PN {
   PN() = default;
   /*!
    * \brief Copy constructor.
-   * \param pn The PN to copy.
-   */
-  PN(const PN& pn) { *this = pn; }
-  /*!
-   * \brief Overloading assignment operator.
-   * \param pn The PN's values to assign.
-   * \return PN
-   */
-  PN& operator=(const PN& pn) {
-    if (this == &pn) {
-      return *this;
-    }
-    this->value = pn.value;
-    this->given = pn.given;
-    this->middle = pn.middle;
-    this->family = pn.family;
-    this->prefix = pn.prefix;
-    this->sufix = pn.sufix;
-    this->delimiter = pn.delimiter;
-    return *this;
-  }
+   */
+  PN(const PN&) = default;
+  /*!
+   * \brief Move constructor.
+   */
+  PN(PN&&) = default;
+  /*!
+   * \brief Copy assignment operator.
+   */
+  PN& operator=(const PN&) = default;
+  /*!
+   * \brief Move assignment operator.
+   */
+  PN& operator=(PN&&) = default;
 
   /*!
    * \brief 'V' formatted-for-display version of the name
@@ -98,22 +102,20 @@ struct PQ {
   PQ() = default;
   /*!
    * \brief Copy constructor.
-   * \param pq The PQ to copy.
    */
-  PQ(const PQ& pq) { *this = pq; }
+  PQ(const PQ&) = default;
   /*!
-   * \brief Overloading assignment operator.
-   * \param pn The PQ's values to assign.
-   * \return PQ
+   * \brief Move constructor.
    */
-  PQ& operator=(const PQ& pq) {
-    if (this == &pq) {
-      return *this;
-    }
-    this->value = pq.value;
-    this->unit = pq.unit;
-    return *this;
-  }
+  PQ(PQ&&) = default;
+  /*!
+   * \brief Copy assignment operator.
+   */
+  PQ& operator=(const PQ&) = default;
+  /*!
+   * \brief Move assignment operator.
+   */
+  PQ& operator=(PQ&&) = default;
   /*!
    * \brief The string representation of the value.
    */
@@ -136,33 +138,28 @@ struct IVL {
   IVL() = default;
   /*!
    * \brief Copy constructor.
-   * \param ivl The IVL to copy.
-   */
-  IVL(const IVL& ivl) { *this = ivl; }
-  /*!
-   * \brief Overloading assignment operator.
-   * \param pn The IVL's values to assign.
-   * \return IVL
-   */
-  IVL& operator=(const IVL& ivl) {
-    if (this == &ivl) {
-      return *this;
-    }
-    this->closed_low = ivl.closed_low;
-    this->closed_high = ivl.closed_high;
-    this->value_low = ivl.value_low;
-    this->value_high = ivl.value_high;
-    this->unit = ivl.unit;
-    return *this;
-  }
+   */
+  IVL(const IVL&) = default;
+  /*!
+   * \brief Move constructor.
+   */
+  IVL(IVL&&) = default;
+  /*!
+   * \brief Copy assignment operator.
+   */
+  IVL& operator=(const IVL&) = default;
+  /*!
+   * \brief Move assignment operator.
+   */
+  IVL& operator=(IVL&&) = default;
   /*!
    * \brief true if the lower bound is closed; false otherwise.
    */
-  bool closed_low;
+  bool closed_low = false;
   /*!
    * \brief true if the upper bound is closed; false otherwise.
    */
-  bool closed_high;
+  bool closed_high = false;
   /*!
    * \brief The lower bound of the interval.
    */
@@ -190,36 +187,29 @@ struct CV {
    * \brief Constructor with a code.
    * \param The code value.
    */
-  CV(const std::string& code_value) : code(code_value) {}
+  CV(Code code_value) : code(std::move(code_value)) {}
   /*!
    * \brief Copy constructor.
-   * \param cv The CV to copy.
-   */
-  CV(const CV& cv) { *this = cv; }
-  /*!
-   * \brief Overloading assignment operator.
-   * \param cv The CV's values to assign.
-   * \return CV
-   */
-  CV& operator=(const CV& cv) {
-    if (this == &cv) {
-      return *this;
-    }
-    this->code = cv.code;
-    this->display_name = cv.display_name;
-    this->code_set_id = cv.code_set_id;
-    this->code_set_name = cv.code_set_name;
-    this->code_set_version = cv.code_set_version;
-    return *this;
-  }
+   */
+  CV(const CV&) = default;
+  /*!
+   * \brief Move constructor.
+   */
+  CV(CV&&) = default;
+  /*!
+   * \brief Copy assignment operator.
+   */
+  CV& operator=(const CV&) = default;
+  /*!
+   * \brief Move assignment operator.
+   */
+  CV& operator=(CV&&) = default;
   /*!
    * \brief Overloading 'less than' operator.
    * \param second The CV value to compare with.
    * \return true if the inner code is less than the second's code.
    */
-  bool operator<(const CV& second) const {
-    return (this->code.compare(second.code) < 0);
-  }
+  bool operator<(const CV& second) const { return this->code < second.code; }
   /*!
    * \brief Overloading 'equal' operator.
    * \param second The CV value to compare with.
@@ -236,24 +226,24 @@ struct CV {
   /*!
    * \brief V' The value code
    */
-  std::string code;
+  Code code;
   /*!
    * \brief 'DN' Intended for display
    */
-  std::optional<std::string> display_name;
+  std::optional<Code> display_name;
   /*!
    * \brief 'S' OID denoting the authority this code set is registered to.
    */
-  std::optional<std::string> code_set_id;
+  std::optional<Code> code_set_id;
   /*!
    * \brief 'SN' The name of the registering authority for this
    * code set.
    */
-  std::optional<std::string> code_set_name;
+  std::optional<Code> code_set_name;
   /*!
    * \brief 'SV' Version of this code set.
    */
-  std::optional<std::string> code_set_version;
+  std::optional<Code> code_set_version;
 };
 
 /*!
@@ -263,6 +253,11 @@ struct CV {
  * alternative codes may exist.
  */
 struct CE : public CV {
+  /*!
+   * \brief The allocator of the repeated fields (see MessageArena).
+   */
+  using allocator_type = Allocator;
+
   /*!
    * \brief Default constructor
    */
@@ -271,30 +266,49 @@ struct CE : public CV {
    * \brief Constructor with a code.
    * \param The code value.
    */
-  CE(const std::string& code_value) : CV(code_value) {}
+  CE(Code code_value) : CV(std::move(code_value)) {}
   /*!
    * \brief Copy constructor.
-   * \param ce The CE to copy.
    */
-  CE(const CE& ce) : CV(ce) { *this = ce; }
+  CE(const CE&) = default;
+  /*!
+   * \brief Move constructor.
+   */
+  CE(CE&&) = default;
+  /*!
+   * \brief Copy assignment operator.
+   */
+  CE& operator=(const CE&) = default;
+  /*!
+   * \brief Move assignment operator.
+   */
+  CE& operator=(CE&&) = default;
   /*!
-   * \brief Overloading assignment operator.
-   * \param ce The CE's values to assign.
-   * \return CE
+   * \brief Constructor using the given allocator for the repeated fields.
+   * \param alloc The allocator.
    */
-  CE& operator=(const CE& ce) {
-    if (this == &ce) {
-      return *this;
-    }
-    CV::operator=(ce);
-    this->transliterations = ce.transliterations;
-    return *this;
+  explicit CE(const allocator_type& alloc) : transliterations(alloc) {}
+  /*!
+   * \brief Copy constructor using the given allocator.
+   * \param other The CE to copy.
+   * \param alloc The allocator.
+   */
+  CE(const CE& other, const allocator_type& alloc) : CE(alloc) {
+    *this = other;
+  }
+  /*!
+   * \brief Move constructor using the given allocator.
+   * \param other The CE to move from.
+   * \param alloc The allocator.
+   */
+  CE(CE&& other, const allocator_type& alloc) : CE(alloc) {
+    *this = std::move(other);
   }
 
   /*!
    * \brief Alternate representation to be communicated.
    */
-  std::list<CV> transliterations;
+  std::pmr::vector<CV> transliterations;
 };
 
 /*!
@@ -330,25 +344,20 @@ struct AccessControl {
   AccessControl() = default;
   /*!
    * \brief Copy constructor.
-   * \param access_control The AccessControl to copy.
-   */
-  AccessControl(const AccessControl& access_control) { *this = access_control; }
-  /*!
-   * \brief Overloading assignment operator.
-   * \param access_control The AccessControl's values to assign.
-   * \return AccessControl
-   */
-  AccessControl& operator=(const AccessControl& access_control) {
-    if (this == &access_control) {
-      return *this;
-    }
-    this->method = access_control.method;
-    this->password = access_control.password;
-    this->active_date = access_control.active_date;
-    this->expiration_date = access_control.expiration_date;
-    this->permission_lvl = access_control.permission_lvl;
-    return *this;
-  }
+   */
+  AccessControl(const AccessControl&) = default;
+  /*!
+   * \brief Move constructor.
+   */
+  AccessControl(AccessControl&&) = default;
+  /*!
+   * \brief Copy assignment operator.
+   */
+  AccessControl& operator=(const AccessControl&) = default;
+  /*!
+   * \brief Move assignment operator.
+   */
+  AccessControl& operator=(AccessControl&&) = default;
 
   /*!
    * \brief The Device's analytic method(s) that should be restricted by the
@@ -415,24 +424,20 @@ struct Ack {
   Ack() = default;
   /*!
    * \brief Copy constructor.
-   * \param ack The ACK to copy.
-   */
-  Ack(const Ack& ack) { *this = ack; }
-  /*!
-   * \brief Overloading assignment operator.
-   * \param ack The ACK's values to assign.
-   * \return ACK
-   */
-  Ack& operator=(const Ack& ack) {
-    if (this == &ack) {
-      return *this;
-    }
-    this->type = ack.type;
-    this->ack_control_id = ack.ack_control_id;
-    this->note_txt = ack.note_txt;
-    this->error_detail = ack.error_detail;
-    return *this;
-  }
+   */
+  Ack(const Ack&) = default;
+  /*!
+   * \brief Move constructor.
+   */
+  Ack(Ack&&) = default;
+  /*!
+   * \brief Copy assignment operator.
+   */
+  Ack& operator=(const Ack&) = default;
+  /*!
+   * \brief Move assignment operator.
+   */
+  Ack& operator=(Ack&&) = default;
 
   /*!
    * \brief The control ID of the message send that this message is in
@@ -459,9 +464,14 @@ struct Ack {
    * \param esc_code The type to check.
    * \return true if it is a valid code; false otherwise.
    */
-  static bool IsValidType(const std::string& ack_type) {
-    return ack_type == "AA" || ack_type == "AE";
-  }
+  static bool IsValidType(std::string_view ack_type);
+  /*!
+   * \brief Get the enum value of the given ACK Type.
+   * \param code The code to parse.
+   * \param type Output value.
+   * \return true if it is a valid code; false otherwise.
+   */
+  static bool ParseType(std::string_view code, AckType& type);
 
   /*!
    * \brief Check if the given code is a valid ACK code.
@@ -504,26 +514,25 @@ struct Directive {
 
   /*!
    * \brief Copy constructor.
-   * \param directive The Directive to copy.
    */
-  Directive(const Directive& directive) { *this = directive; }
+  Directive(const Directive&) = default;
   /*!
-   * \brief Overloading assignment operator.
-   * \param directive The Directive's values to assign.
-   * \return Directive
+   * \brief Move constructor.
    */
-  Directive& operator=(const Directive& directive) {
-    if (this == &directive) {
-      return *this;
-    }
-    this->command = directive.command;
-    return *this;
-  }
+  Directive(Directive&&) = default;
+  /*!
+   * \brief Copy assignment operator.
+   */
+  Directive& operator=(const Directive&) = default;
+  /*!
+   * \brief Move assignment operator.
+   */
+  Directive& operator=(Directive&&) = default;
 
   /*!
    * \brief A coded value representing a command for the Device to peform.
    */
-  DirectivesStandard command;
+  DirectivesStandard command{};
 };
 
 /*!
@@ -537,25 +546,20 @@ struct ConnectionProfile {
   ConnectionProfile() = default;
   /*!
    * \brief Copy constructor.
-   * \param connection_profile The Device to copy.
    */
-  ConnectionProfile(const ConnectionProfile& connection_profile) {
-    *this = connection_profile;
-  }
+  ConnectionProfile(const ConnectionProfile&) = default;
   /*!
-   * \brief Overloading assignment operator.
-   * \param connection_profile The ConnectionProfile's values to assign.
-   * \return ConnectionProfile
-   */
-  ConnectionProfile& operator=(const ConnectionProfile& connection_profile) {
-    if (this == &connection_profile) {
-      return *this;
-    }
-    this->ip = connection_profile.ip;
-    this->port = connection_profile.port;
-    this->timeout = connection_profile.timeout;
-    return *this;
-  }
+   * \brief Move constructor.
+   */
+  ConnectionProfile(ConnectionProfile&&) = default;
+  /*!
+   * \brief Copy assignment operator.
+   */
+  ConnectionProfile& operator=(const ConnectionProfile&) = default;
+  /*!
+   * \brief Move assignment operator.
+   */
+  ConnectionProfile& operator=(ConnectionProfile&&) = default;
 
   /*!
    * \brief Observation reviewer's IP
@@ -569,7 +573,7 @@ struct ConnectionProfile {
    * \brief Application-level timeout the Device uses, specified in
    * milliseconds.
    */
-  std::chrono::milliseconds timeout;
+  std::chrono::milliseconds timeout{};
 };
 
 /*!
@@ -605,27 +609,21 @@ struct DeviceStaticCapabilities {
   DeviceStaticCapabilities() = default;
   /*!
    * \brief Copy constructor.
-   * \param capabilites The DeviceStaticCapabilities to copy.
    */
-  DeviceStaticCapabilities(const DeviceStaticCapabilities& capabilites) {
-    *this = capabilites;
-  }
+  DeviceStaticCapabilities(const DeviceStaticCapabilities&) = default;
   /*!
-   * \brief Overloading assignment operator.
-   * \param capabilites The DeviceStaticCapabilities's values to assign.
-   * \return DeviceStaticCapabilities.
-   */
-  DeviceStaticCapabilities& operator=(
-      const DeviceStaticCapabilities& capabilities) {
-    if (this == &capabilities) {
-      return *this;
-    }
-    this->connection_profile = capabilities.connection_profile;
-    this->topics_supported = capabilities.topics_supported;
-    this->directives_supported = capabilities.directives_supported;
-    this->max_message_size = capabilities.max_message_size;
-    return *this;
-  }
+   * \brief Move constructor.
+   */
+  DeviceStaticCapabilities(DeviceStaticCapabilities&&) = default;
+  /*!
+   * \brief Copy assignment operator.
+   */
+  DeviceStaticCapabilities& operator=(const DeviceStaticCapabilities&) =
+      default;
+  /*!
+   * \brief Move assignment operator.
+   */
+  DeviceStaticCapabilities& operator=(DeviceStaticCapabilities&&) = default;
   /*!
    * \brief CIC messaging profile the Device supports.
    */
@@ -642,6 +640,15 @@ struct DeviceStaticCapabilities {
    * \brief The maximum size message (in bytes) that the Device can handle.
    */
   std::optional<int> max_message_size;
+
+  /*!
+   * \brief Get the enum value of the given Connection Profile.
+   * \param code The code to parse.
+   * \param profile Output value.
+   * \return true if it is a valid code; false otherwise.
+   */
+  static bool ParseConnectionProfile(std::string_view code,
+                                     ConnectionProfileType& profile);
 };
 
 /*!
@@ -660,32 +667,20 @@ struct Device {
   Device(std::string id = "") : device_id(id) {}
   /*!
    * \brief Copy constructor.
-   * \param device The Device to copy.
-   */
-  Device(const Device& device) { *this = device; }
-  /*!
-   * \brief Overloading assignment operator.
-   * \param device The Device's values to assign.
-   * \return Device
-   */
-  Device& operator=(const Device& device) {
-    if (this == &device) {
-      return *this;
-    }
-    this->device_id = device.device_id;
-    this->vendor_id = device.vendor_id;
-    this->model_id = device.model_id;
-    this->serial_id = device.serial_id;
-    this->manufacturer_name = device.manufacturer_name;
-    this->hw_version = device.hw_version;
-    this->sw_version = device.sw_version;
-    this->device_name = device.device_name;
-    this->vmd_id = device.vmd_id;
-    this->vmd_name = device.vmd_name;
-    this->static_capabilities = device.static_capabilities;
-    this->connection_profile = device.connection_profile;
-    return *this;
-  }
+   */
+  Device(const Device&) = default;
+  /*!
+   * \brief Move constructor.
+   */
+  Device(Device&&) = default;
+  /*!
+   * \brief Copy assignment operator.
+   */
+  Device& operator=(const Device&) = default;
+  /*!
+   * \brief Move assignment operator.
+   */
+  Device& operator=(Device&&) = default;
   /*!
    * \brief Device identifier.
    */
@@ -757,23 +752,20 @@ struct DeviceEvent {
   DeviceEvent() = default;
   /*!
    * \brief Copy constructor.
-   * \param device_event The DeviceEvent to copy.
-   */
-  DeviceEvent(const DeviceEvent& device_event) { *this = device_event; }
-  /*!
-   * \brief Overloading assignment operator.
-   * \param device_event The DeviceEvent's values to assign.
-   * \return DeviceEvent.
-   */
-  DeviceEvent& operator=(const DeviceEvent& device_event) {
-    if (this == &device_event) {
-      return *this;
-    }
-    this->description = device_event.description;
-    this->event_dttm = device_event.event_dttm;
-    this->severity = device_event.severity;
-    return *this;
-  }
+   */
+  DeviceEvent(const DeviceEvent&) = default;
+  /*!
+   * \brief Move constructor.
+   */
+  DeviceEvent(DeviceEvent&&) = default;
+  /*!
+   * \brief Copy assignment operator.
+   */
+  DeviceEvent& operator=(const DeviceEvent&) = default;
+  /*!
+   * \brief Move assignment operator.
+   */
+  DeviceEvent& operator=(DeviceEvent&&) = default;
 
   /*!
    * \brief Free text description of the event.
@@ -782,11 +774,11 @@ struct DeviceEvent {
   /*!
    * \brief Time the event occurred.
    */
-  time_t event_dttm;
+  time_t event_dttm = 0;
   /*!
    * \brief An indication of the level of operator intervention.
    */
-  SeverityLevel severity;
+  SeverityLevel severity{};
 };
 
 /*!
@@ -816,31 +808,25 @@ struct DeviceStatus {
   DeviceStatus() = default;
   /*!
    * \brief Copy constructor.
-   * \param device_status The DeviceStatus to copy.
-   */
-  DeviceStatus(const DeviceStatus& device_status) { *this = device_status; }
-  /*!
-   * \brief Overloading assignment operator.
-   * \param terminate The Terminate's values to assign.
-   * \return Terminate.
-   */
-  DeviceStatus& operator=(const DeviceStatus& device_status) {
-    if (this == &device_status) return *this;
-    this->new_observations = device_status.new_observations;
-    this->new_events = device_status.new_events;
-    this->condition = device_status.condition;
-    this->status_timestamp = device_status.status_timestamp;
-    this->observations_update = device_status.observations_update;
-    this->events_update = device_status.events_update;
-    this->operators_update = device_status.operators_update;
-    this->patients_update = device_status.patients_update;
-    return *this;
-  }
+   */
+  DeviceStatus(const DeviceStatus&) = default;
+  /*!
+   * \brief Move constructor.
+   */
+  DeviceStatus(DeviceStatus&&) = default;
+  /*!
+   * \brief Copy assignment operator.
+   */
+  DeviceStatus& operator=(const DeviceStatus&) = default;
+  /*!
+   * \brief Move assignment operator.
+   */
+  DeviceStatus& operator=(DeviceStatus&&) = default;
 
   /*!
    * \brief The number of observations the Device has to report.
    */
-  int new_observations;
+  int new_observations = 0;
   /*!
    * \brief The number of events since the last sync.
    */
@@ -852,7 +838,7 @@ struct DeviceStatus {
   /*!
    * \brief The time that this status information was observed.
    */
-  time_t status_timestamp;
+  time_t status_timestamp = 0;
   /*!
    * \brief The time the Device last uploaded observations (i.e., successfully
    * completed the Observations Topic).
@@ -873,6 +859,14 @@ struct DeviceStatus {
    * Topic.
    */
   std::optional<time_t> patients_update;
+
+  /*!
+   * \brief Get the enum value of the given Device Condition.
+   * \param code The code to parse.
+   * \param condition Output value.
+   * \return true if it is a valid code; false otherwise.
+   */
+  static bool ParseCondition(std::string_view code, DeviceCondition& condition);
 };
 
 /*!
@@ -901,23 +895,20 @@ struct EndOfTopic {
   EndOfTopic() = default;
   /*!
    * \brief Copy constructor.
-   * \param end_of_topic The EndOfTopic to copy.
-   */
-  EndOfTopic(const EndOfTopic& end_of_topic) { *this = end_of_topic; }
-  /*!
-   * \brief Overloading assignment operator.
-   * \param end_of_topic The EndOfTopic's values to assign.
-   * \return EndOfTopic.
-   */
-  EndOfTopic& operator=(const EndOfTopic& end_of_topic) {
-    if (this == &end_of_topic) {
-      return *this;
-    }
-    this->topic = end_of_topic.topic;
-    this->update = end_of_topic.update;
-    this->eot_control = end_of_topic.eot_control;
-    return *this;
-  }
+   */
+  EndOfTopic(const EndOfTopic&) = default;
+  /*!
+   * \brief Move constructor.
+   */
+  EndOfTopic(EndOfTopic&&) = default;
+  /*!
+   * \brief Copy assignment operator.
+   */
+  EndOfTopic& operator=(const EndOfTopic&) = default;
+  /*!
+   * \brief Move assignment operator.
+   */
+  EndOfTopic& operator=(EndOfTopic&&) = default;
 
   /*!
    * \brief A coded for the Topic that has just been completed. Vendors may
@@ -936,6 +927,14 @@ struct EndOfTopic {
    * this EOT is a response.
    */
   std::optional<std::string> eot_control;
+
+  /*!
+   * \brief Get the enum value of the given End of Topic code.
+   * \param code The code to parse.
+   * \param value Output value.
+   * \return true if it is a valid code; false otherwise.
+   */
+  static bool ParseTopic(std::string_view code, Code& value);
 };
 
 /*!
@@ -957,23 +956,20 @@ struct Escape {
   Escape() = default;
   /*!
    * \brief Copy constructor.
-   * \param escape The Escape to copy.
-   */
-  Escape(const EndOfTopic& escape) { *this = escape; }
-  /*!
-   * \brief Overloading assignment operator.
-   * \param escape The Escape's values to assign.
-   * \return Escape.
-   */
-  Escape& operator=(const Escape& escape) {
-    if (this == &escape) {
-      return *this;
-    }
-    this->esc_control_id = escape.esc_control_id;
-    this->detail = escape.detail;
-    this->note = escape.note;
-    return *this;
-  }
+   */
+  Escape(const Escape&) = default;
+  /*!
+   * \brief Move constructor.
+   */
+  Escape(Escape&&) = default;
+  /*!
+   * \brief Copy assignment operator.
+   */
+  Escape& operator=(const Escape&) = default;
+  /*!
+   * \brief Move assignment operator.
+   */
+  Escape& operator=(Escape&&) = default;
 
   /*!
    * \brief The message control code from the Header of the message to which
@@ -995,9 +991,14 @@ struct Escape {
    * \param esc_code The code to check.
    * \return true if it is a valid code; false otherwise.
    */
-  static bool IsValidCode(const std::string& esc_code) {
-    return esc_code == "OTH" || esc_code == "TOP" || esc_code == "CNC";
-  }
+  static bool IsValidCode(std::string_view esc_code);
+  /*!
+   * \brief Get the enum value of the given Escape code.
+   * \param code The code to parse.
+   * \param value Output value.
+   * \return true if it is a valid code; false otherwise.
+   */
+  static bool ParseCode(std::string_view code, Code& value);
 };
 
 /*!
@@ -1033,25 +1034,20 @@ struct Header {
   Header() : version_id("POCT1") {}
   /*!
    * \brief Copy constructor.
-   * \param header The Header to copy.
-   */
-  Header(const Header& header) { *this = header; }
-  /*!
-   * \brief Overloading assignment operator.
-   * \param header The Header's values to assign.
-   * \return Header
-   */
-  Header& operator=(const Header& header) {
-    if (this == &header) {
-      return *this;
-    }
-    this->message_type = header.message_type;
-    this->control_id = header.control_id;
-    this->version_id = header.version_id;  // Always POCT1
-    this->creation_dttm = header.creation_dttm;
-    this->encoding_chars = header.encoding_chars;
-    return *this;
-  }
+   */
+  Header(const Header&) = default;
+  /*!
+   * \brief Move constructor.
+   */
+  Header(Header&&) = default;
+  /*!
+   * \brief Copy assignment operator.
+   */
+  Header& operator=(const Header&) = default;
+  /*!
+   * \brief Move assignment operator.
+   */
+  Header& operator=(Header&&) = default;
   /*!
    * \brief A string guaranteed to uniquely identify this message throughout
    * the
@@ -1065,7 +1061,7 @@ struct Header {
   /*!
    * \brief The Sender's time when the message was sent.
    */
-  time_t creation_dttm;
+  time_t creation_dttm = 0;
   /*!
    * \brief A code made up of the message name and trigger value. Values for
    * this field may be found in the description of each message.
@@ -1099,28 +1095,25 @@ struct Note {
   Note() : type_cd(MsgType::OPERATOR_COMMENT) {}
   /*!
    * \brief Copy constructor.
-   * \param note The Note to copy.
-   */
-  Note(const Note& note) { *this = note; }
-  /*!
-   * \brief Overloading assignment operator.
-   * \param note The Note's values to assign.
-   * \return Note
-   */
-  Note& operator=(const Note& note) {
-    if (this == &note) {
-      return *this;
-    }
-    this->type_cd = note.type_cd;
-    this->text = note.text;
-    this->code = note.code;
-    return *this;
-  }
+   */
+  Note(const Note&) = default;
+  /*!
+   * \brief Move constructor.
+   */
+  Note(Note&&) = default;
+  /*!
+   * \brief Copy assignment operator.
+   */
+  Note& operator=(const Note&) = default;
+  /*!
+   * \brief Move assignment operator.
+   */
+  Note& operator=(Note&&) = default;
 
   /*!
    * \brief Qualifies which is the use of this specific Note instance.
    */
-  MsgType type_cd;
+  MsgType type_cd{};
 
   /*!
    * \brief The string's contents are dependent on the context in which the Note
@@ -1199,6 +1192,11 @@ struct Observation {
     W,       /**< Worse - use when direction not relevant */
   };
 
+  /*!
+   * \brief The allocator of the repeated fields (see MessageArena).
+   */
+  using allocator_type = Allocator;
+
   /*!
    * \brief Default constructor.
    */
@@ -1206,28 +1204,43 @@ struct Observation {
   Observation() = default;
   /*!
    * \brief Copy constructor.
-   * \param observation The Observation to copy.
-   */
-  Observation(const Observation& observation) { *this = observation; }
-  /*!
-   * \brief Overloading assignment operator.
-   * \param observation The Observation's values to assign.
-   * \return Observation
-   */
-  Observation& operator=(const Observation& observation) {
-    if (this == &observation) {
-      return *this;
-    }
-    this->observation_id = observation.observation_id;
-    this->value = observation.value;
-    this->qualitative_value = observation.qualitative_value;
-    this->method = observation.method;
-    this->status = observation.status;
-    this->interpretation = observation.interpretation;
-    this->normal_lo_hi_limit = observation.normal_lo_hi_limit;
-    this->critical_lo_hi_limit = observation.critical_lo_hi_limit;
-    this->notes = observation.notes;
-    return *this;
+   */
+  Observation(const Observation&) = default;
+  /*!
+   * \brief Move constructor.
+   */
+  Observation(Observation&&) = default;
+  /*!
+   * \brief Copy assignment operator.
+   */
+  Observation& operator=(const Observation&) = default;
+  /*!
+   * \brief Move assignment operator.
+   */
+  Observation& operator=(Observation&&) = default;
+  /*!
+   * \brief Constructor using the given allocator for the repeated fields.
+   * \param alloc The allocator.
+   */
+  explicit Observation(const allocator_type& alloc)
+      : observation_id(alloc), notes(alloc) {}
+  /*!
+   * \brief Copy constructor using the given allocator.
+   * \param other The Observation to copy.
+   * \param alloc The allocator.
+   */
+  Observation(const Observation& other, const allocator_type& alloc)
+      : Observation(alloc) {
+    *this = other;
+  }
+  /*!
+   * \brief Move constructor using the given allocator.
+   * \param other The Observation to move from.
+   * \param alloc The allocator.
+   */
+  Observation(Observation&& other, const allocator_type& alloc)
+      : Observation(alloc) {
+    *this = std::move(other);
   }
 
   /*!
@@ -1269,49 +1282,64 @@ struct Observation {
   /*!
    * \brief notes
    */
-  std::list<Note> notes;
+  std::pmr::vector<Note> notes;
 
   /*!
    * \brief Check if the given code is a valid Method code.
    * \param method The code to check.
    * \return true if it is a valid code; false otherwise.
    */
-  static bool IsValidMethod(const std::string& method) {
-    return method == "C" || method == "D" || method == "E" || method == "I" ||
-           method == "M" || method == "U";
-  }
+  static bool IsValidMethod(std::string_view method);
+  /*!
+   * \brief Get the enum value of the given Method code.
+   * \param code The code to parse.
+   * \param method Output value.
+   * \return true if it is a valid code; false otherwise.
+   */
+  static bool ParseMethod(std::string_view code, Method& method);
 
   /*!
    * \brief Check if the given code is a valid Qualitate Value code.
    * \param value The code to check.
    * \return true if it is a valid code; false otherwise.
    */
-  static bool IsQualitativeValue(const std::string& value) {
-    return value == "L" || value == "H" || value == "LL" || value == "HH" ||
-           value == "N" || value == "A" || value == "AA" || value == "U" ||
-           value == "D" || value == "B" || value == "W";
-  }
+  static bool IsQualitativeValue(std::string_view value);
+  /*!
+   * \brief Get the enum value of the given Qualitative Value code.
+   * \param code The code to parse.
+   * \param value Output value.
+   * \return true if it is a valid code; false otherwise.
+   */
+  static bool ParseQualitativeValue(std::string_view code, Qualitative& value);
 
   /*!
    * \brief Check if the given code is a valid Status code.
    * \param status The code to check.
    * \return true if it is a valid code; false otherwise.
    */
-  static bool IsValidStatus(const std::string& status) {
-    return status == "A" || status == "D" || status == "U" || status == "X";
-  }
+  static bool IsValidStatus(std::string_view status);
+  /*!
+   * \brief Get the enum value of the given Status code.
+   * \param code The code to parse.
+   * \param status Output value.
+   * \return true if it is a valid code; false otherwise.
+   */
+  static bool ParseStatus(std::string_view code, Status& status);
 
   /*!
    * \brief Check if the given code is a valid Interpretation code.
    * \param intepretation The code to check.
    * \return true if it is a valid code; false otherwise.
    */
-  static bool IsValidInterpretation(const std::string& inter) {
-    return inter == "L" || inter == "H" || inter == "LL" || inter == "HH" ||
-           inter == "LESS" || inter == "GREATER" || inter == "N" ||
-           inter == "A" || inter == "AA" || inter == "null" || inter == "U" ||
-           inter == "D" || inter == "B" || inter == "W";
-  }
+  static bool IsValidInterpretation(std::string_view inter);
+  /*!
+   * \brief Get the enum value of the given Interpretation code.
+   * \param code The code to parse.
+   * \param interpretation Output value.
+   * \return true if it is a valid code; false otherwise.
+   */
+  static bool ParseInterpretation(std::string_view code,
+                                  Interpretation& interpretation);
 };
 
 /*!
@@ -1333,23 +1361,20 @@ struct Operator {
   Operator() = default;
   /*!
    * \brief Copy constructor.
-   * \param opt The Operator to copy
-   */
-  Operator(const Operator& opt) { *this = opt; }
-  /*!
-   * \brief Overloading assignment operator.
-   * \param opt The Operator's values to assign.
-   * \return Operator
-   */
-  Operator& operator=(const Operator& opt) {
-    if (this == &opt) {
-      return *this;
-    }
-    this->operator_id = opt.operator_id;
-    this->action = opt.action;
-    this->name = opt.name;
-    return *this;
-  }
+   */
+  Operator(const Operator&) = default;
+  /*!
+   * \brief Move constructor.
+   */
+  Operator(Operator&&) = default;
+  /*!
+   * \brief Copy assignment operator.
+   */
+  Operator& operator=(const Operator&) = default;
+  /*!
+   * \brief Move assignment operator.
+   */
+  Operator& operator=(Operator&&) = default;
 
   /*!
    * \brief The unique identifier for the operator of the Device.
@@ -1367,6 +1392,12 @@ struct Operator {
    * \brief The name of the operator who performed the test.
    */
   std::optional<PN> name;
+
+  /*!
+   * \brief The access rights of the operator. Only used in the Operator List
+   * topic.
+   */
+  std::vector<AccessControl> access_controls;
 };
 
 /*!
@@ -1379,23 +1410,20 @@ struct Order {
   Order() = default;
   /*!
    * \brief Copy constructor.
-   * \param order The Order to copy.
-   */
-  Order(const Order& order) { *this = order; }
-  /*!
-   * \brief Overloading assignment operator.
-   * \param order The Order's values to assign.
-   * \return Patient
-   */
-  Order& operator=(const Order& order) {
-    if (this == &order) {
-      return *this;
-    }
-    this->universal_service_id = order.universal_service_id;
-    this->ordering_provider_id = order.ordering_provider_id;
-    this->order_id = order.order_id;
-    return *this;
-  }
+   */
+  Order(const Order&) = default;
+  /*!
+   * \brief Move constructor.
+   */
+  Order(Order&&) = default;
+  /*!
+   * \brief Copy assignment operator.
+   */
+  Order& operator=(const Order&) = default;
+  /*!
+   * \brief Move assignment operator.
+   */
+  Order& operator=(Order&&) = default;
 
   /*!
    * \brief Identifies the service provided by these observations.
@@ -1421,6 +1449,14 @@ struct Order {
  * List.
  */
 struct Patient {
+  /*!
+   * \brief The Action enum
+   */
+  enum class Action {
+    I, /**< Insert the specified entries into the associated list. */
+    D  /**< Delete the specified entries from the associated list. */
+  };
+
   /*!
    * \brief The Gender enum
    */
@@ -1439,32 +1475,30 @@ struct Patient {
   Patient() = default;
   /*!
    * \brief Copy constructor.
-   * \param patient The Patient to copy.
-   */
-  Patient(const Patient& patient) { *this = patient; }
-  /*!
-   * \brief Overloading assignment operator.
-   * \param patient The Patient's values to assign.
-   * \return Patient
-   */
-  Patient& operator=(const Patient& Patient) {
-    if (this == &Patient) {
-      return *this;
-    }
-    this->patient_id = Patient.patient_id;
-    this->location = Patient.location;
-    this->name = Patient.name;
-    this->birth_date = Patient.birth_date;
-    this->gender = Patient.gender;
-    this->weight = Patient.weight;
-    this->height = Patient.height;
-    return *this;
-  }
+   */
+  Patient(const Patient&) = default;
+  /*!
+   * \brief Move constructor.
+   */
+  Patient(Patient&&) = default;
+  /*!
+   * \brief Copy assignment operator.
+   */
+  Patient& operator=(const Patient&) = default;
+  /*!
+   * \brief Move assignment operator.
+   */
+  Patient& operator=(Patient&&) = default;
 
   /*!
    * \brief The unique identifier for the Patient.
    */
   std::string patient_id;
+  /*!
+   * \brief Usefull in incremental Patient List topic. Not defined for
+   * complete updates.
+   */
+  std::optional<Action> action;
   /*!
    * \brief The location of the Patient when the specimen was drawn.
    */
@@ -1490,10 +1524,19 @@ struct Patient {
    */
   std::optional<PQ<std::string>> height;
 
-  static bool IsValidGender(const std::string& gender) {
-    return gender == "F" || gender == "M" || gender == "O" || gender == "U" ||
-           gender == "A" || gender == "N";
-  }
+  /*!
+   * \brief Check if the given code is a valid Gender code.
+   * \param gender The code to check.
+   * \return true if it is a valid code; false otherwise.
+   */
+  static bool IsValidGender(std::string_view gender);
+  /*!
+   * \brief Get the enum value of the given Gender code.
+   * \param code The code to parse.
+   * \param gender Output value.
+   * \return true if it is a valid code; false otherwise.
+   */
+  static bool ParseGender(std::string_view code, Gender& gender);
 };
 
 /*!
@@ -1506,23 +1549,20 @@ struct Reagent {
   Reagent() = default;
   /*!
    * \brief Copy constructor.
-   * \param reagent The Reagent to copy.
-   */
-  Reagent(const Reagent& reagent) { *this = reagent; }
-  /*!
-   * \brief Overloading assignment operator.
-   * \param reagent The Reagent's values to assign.
-   * \return Reagent
-   */
-  Reagent& operator=(const Reagent& reagent) {
-    if (this == &reagent) {
-      return *this;
-    }
-    this->name = reagent.name;
-    this->lot_number = reagent.lot_number;
-    this->expiration_date = reagent.expiration_date;
-    return *this;
-  }
+   */
+  Reagent(const Reagent&) = default;
+  /*!
+   * \brief Move constructor.
+   */
+  Reagent(Reagent&&) = default;
+  /*!
+   * \brief Copy assignment operator.
+   */
+  Reagent& operator=(const Reagent&) = default;
+  /*!
+   * \brief Move assignment operator.
+   */
+  Reagent& operator=(Reagent&&) = default;
   /*!
    * \brief The manufacturer's name for the reagent.
    */
@@ -1534,7 +1574,7 @@ struct Reagent {
   /*!
    * \brief The date past which the reagent should not be used.
    */
-  std::tm expiration_date;
+  std::tm expiration_date{};
 };
 
 /*!
@@ -1555,30 +1595,39 @@ struct Request {
   Request() = default;
   /*!
    * \brief Copy constructor.
-   * \param request The Request to copy.
    */
-  Request(const Request& request) { *this = request; }
+  Request(const Request&) = default;
   /*!
-   * \brief Overloading assignment operator.
-   * \param request The Request's values to assign.
-   * \return Request
+   * \brief Move constructor.
    */
-  Request& operator=(const Request& request) {
-    if (this == &request) {
-      return *this;
-    }
-    this->type = request.type;
-    return *this;
-  }
+  Request(Request&&) = default;
+  /*!
+   * \brief Copy assignment operator.
+   */
+  Request& operator=(const Request&) = default;
+  /*!
+   * \brief Move assignment operator.
+   */
+  Request& operator=(Request&&) = default;
 
   /*!
    * \brief A code denoting the information requested.
    */
   CV type;
 
-  static bool IsValidCode(const std::string& req_code) {
-    return req_code == "ROBS" || req_code == "RDEV";
-  }
+  /*!
+   * \brief Check if the given code is a valid Request code.
+   * \param req_code The code to check.
+   * \return true if it is a valid code; false otherwise.
+   */
+  static bool IsValidCode(std::string_view req_code);
+  /*!
+   * \brief Get the enum value of the given Request code.
+   * \param code The code to parse.
+   * \param type Output value.
+   * \return true if it is a valid code; false otherwise.
+   */
+  static bool ParseCode(std::string_view code, Type& type);
 };
 
 /*!
@@ -1593,27 +1642,20 @@ struct ControlCalibration {
 
   /*!
    * \brief Copy constructor.
-   * \param control_calibration The ControlCalibration to copy.
    */
-  ControlCalibration(const ControlCalibration& control_calibration) {
-    *this = control_calibration;
-  }
+  ControlCalibration(const ControlCalibration&) = default;
   /*!
-   * \brief Overloading assignment operator.
-   * \param control_calibration The ControlCalibration's values to assign.
-   * \return ControlCalibration
-   */
-  ControlCalibration& operator=(const ControlCalibration& control_calibration) {
-    if (this == &control_calibration) {
-      return *this;
-    }
-    this->name = control_calibration.name;
-    this->lot_number = control_calibration.lot_number;
-    this->expiration_date = control_calibration.expiration_date;
-    this->level = control_calibration.level;
-    this->cal_ver_repetition = control_calibration.cal_ver_repetition;
-    return *this;
-  }
+   * \brief Move constructor.
+   */
+  ControlCalibration(ControlCalibration&&) = default;
+  /*!
+   * \brief Copy assignment operator.
+   */
+  ControlCalibration& operator=(const ControlCalibration&) = default;
+  /*!
+   * \brief Move assignment operator.
+   */
+  ControlCalibration& operator=(ControlCalibration&&) = default;
 
   /*!
    * \brief QC/Calbration: Vendor.
@@ -1846,29 +1888,25 @@ struct Specimen {
 
   /*!
    * \brief Copy constructor.
-   * \param specimen The Specimen to copy.
-   */
-  Specimen(const Specimen& specimen) { *this = specimen; }
-  /*!
-   * \brief Overloading assignment operator.
-   * \param specimen The Specimen's values to assign.
-   * \return
-   */
-  Specimen& operator=(const Specimen& specimen) {
-    if (this == &specimen) {
-      return *this;
-    }
-    this->specimen_dttm = specimen.specimen_dttm;
-    this->specimen_id = specimen.specimen_id;
-    this->source = specimen.source;
-    this->type = specimen.type;
-    return *this;
-  }
+   */
+  Specimen(const Specimen&) = default;
+  /*!
+   * \brief Move constructor.
+   */
+  Specimen(Specimen&&) = default;
+  /*!
+   * \brief Copy assignment operator.
+   */
+  Specimen& operator=(const Specimen&) = default;
+  /*!
+   * \brief Move assignment operator.
+   */
+  Specimen& operator=(Specimen&&) = default;
 
   /*!
    * \brief Time the specimen was drawn.
    */
-  time_t specimen_dttm;
+  time_t specimen_dttm = 0;
   /*!
    * \brief The code identifying the specimen.
    */
@@ -1882,63 +1920,33 @@ struct Specimen {
    */
   std::optional<CE> type;
 
-  static bool IsValidSource(const std::string& source) {
-    return source == "BE" || source == "OU" || source == "BN" ||
-           source == "BU" || source == "CT" || source == "LA" ||
-           source == "LAC" || source == "LACF" || source == "LD" ||
-           source == "LE" || source == "LEJ" || source == "OS" ||
-           source == "LF" || source == "LG" || source == "LH" ||
-           source == "LIJ" || source == "LLAQ" || source == "LLFA" ||
-           source == "LMFA" || source == "LN" || source == "LPC" ||
-           source == "LSC" || source == "LT" || source == "LUA" ||
-           source == "LUAQ" || source == "LUFA" || source == "LVG" ||
-           source == "LVL" || source == "NB" || source == "PA" ||
-           source == "PERIN" || source == "RA" || source == "RAC" ||
-           source == "RACF" || source == "RD" || source == "RE" ||
-           source == "REJ" || source == "OD" || source == "RF" ||
-           source == "RG" || source == "RH" || source == "RIJ" ||
-           source == "RLAQ" || source == "RLFA" || source == "RMFA" ||
-           source == "RN" || source == "RPC" || source == "RSC" ||
-           source == "RT" || source == "RUA" || source == "RUAQ" ||
-           source == "RUFA" || source == "RVL" || source == "RVG";
-  }
+  /*!
+   * \brief Check if the given code is a valid Source code.
+   * \param source The code to check.
+   * \return true if it is a valid code; false otherwise.
+   */
+  static bool IsValidSource(std::string_view source);
+  /*!
+   * \brief Get the enum value of the given Source code.
+   * \param code The code to parse.
+   * \param source Output value.
+   * \return true if it is a valid code; false otherwise.
+   */
+  static bool ParseSource(std::string_view code, Source& source);
 
-  static bool IsValidType(const std::string& type) {
-    return type == "ABS" || type == "AMN" || type == "ASP" || type == "BPH" ||
-           type == "BIFL" || type == "BLDA" || type == "BBL" ||
-           type == "BLDC" || type == "BLMV" || type == "BPU" ||
-           type == "BLDV" || type == "BON" || type == "BRTH" || type == "BRO" ||
-           type == "BRN" || type == "CALC" || type == "CDM" || type == "CNL" ||
-           type == "CTP" || type == "CSF" || type == "CVM" || type == "CVX" ||
-           type == "COL" || type == "BLDCO" || type == "CNJT" ||
-           type == "CUR" || type == "CYST" || type == "DIAF" ||
-           type == "DOSE" || type == "DRN" || type == "DUFL" || type == "EAR" ||
-           type == "EARW" || type == "ELT" || type == "ENDC" ||
-           type == "ENDM" || type == "EOS" || type == "RBC" || type == "EYE" ||
-           type == "EXG" || type == "FIB" || type == "FLT" || type == "FIST" ||
-           type == "FLU" || type == "GAS" || type == "GAST" || type == "GEN" ||
-           type == "GENC" || type == "GENL" || type == "GENV" ||
-           type == "HAR" || type == "IHG" || type == "IT" || type == "ISLT" ||
-           type == "LAM" || type == "WBC" || type == "LN" || type == "LNA" ||
-           type == "LNV" || type == "LIQ" || type == "LYM" || type == "MAC" ||
-           type == "MAR" || type == "MEC" || type == "MBLD" || type == "MLK" ||
-           type == "MILK" || type == "NAIL" || type == "NOS" || type == "ORH" ||
-           type == "PAFL" || type == "PAT" || type == "PRT" || type == "PLC" ||
-           type == "PLAS" || type == "PLB" || type == "PLR" || type == "PMN" ||
-           type == "PPP" || type == "PRP" || type == "PUS" || type == "RT" ||
-           type == "SAL" || type == "SMN" || type == "SER" || type == "SKN" ||
-           type == "SKM" || type == "SPRM" || type == "SPT" || type == "SPTC" ||
-           type == "SPTT" || type == "STON" || type == "STL" || type == "SWT" ||
-           type == "SNV" || type == "TEAR" || type == "THRT" ||
-           type == "THRB" || type == "TISS" || type == "TISG" ||
-           type == "TLGI" || type == "TLNG" || type == "TISPL" ||
-           type == "TSMI" || type == "TISU" || type == "TUB" || type == "ULC" ||
-           type == "UMB" || type == "UMED" || type == "URTH" || type == "UR" ||
-           type == "URC" || type == "URT" || type == "URNS" || type == "USUB" ||
-           type == "VITF" || type == "VOM" || type == "BLD" || type == "BDY" ||
-           type == "WAT" || type == "WICK" || type == "WND" || type == "WNDA" ||
-           type == "WNDE" || type == "WNDD";
-  }
+  /*!
+   * \brief Check if the given code is a valid Type code.
+   * \param type The code to check.
+   * \return true if it is a valid code; false otherwise.
+   */
+  static bool IsValidType(std::string_view type);
+  /*!
+   * \brief Get the enum value of the given Type code.
+   * \param code The code to parse.
+   * \param type Output value.
+   * \return true if it is a valid code; false otherwise.
+   */
+  static bool ParseType(std::string_view code, Type& type);
 };
 
 /*!
@@ -1977,41 +1985,55 @@ struct Service {
     EDT  /**< Edited */
   };
 
+  /*!
+   * \brief The allocator of the repeated fields (see MessageArena).
+   */
+  using allocator_type = Allocator;
+
   /*!
    * \brief Default constructor
    */
-  Service() {}
+  Service() = default;
   /*!
    * \brief Copy constructor.
-   * \param service The Service to copy
-   */
-  Service(const Service& service) { *this = service; }
-  /*!
-   * \brief Overloading assignment operator.
-   * \param service The Service's values to assign.
-   * \return Service
-   */
-  Service& operator=(const Service& service) {
-    if (this == &service) {
-      return *this;
-    }
-    this->observation_uid = service.observation_uid;
-    this->role = service.role;
-    this->observations = service.observations;
-    this->observation_dttm = service.observation_dttm;
-    this->status = service.status;
-    this->reason = service.reason;
-    this->sequence = service.sequence;
-    this->op = service.op;
-    this->reagents = service.reagents;
-    this->notes = service.notes;
-    // patient information
-    this->patient = service.patient;
-    this->order = service.order;
-    this->specimen = service.specimen;
-    // non-patient information
-    this->control = service.control;
-    return *this;
+   */
+  Service(const Service&) = default;
+  /*!
+   * \brief Move constructor.
+   */
+  Service(Service&&) = default;
+  /*!
+   * \brief Copy assignment operator.
+   */
+  Service& operator=(const Service&) = default;
+  /*!
+   * \brief Move assignment operator.
+   */
+  Service& operator=(Service&&) = default;
+  /*!
+   * \brief Constructor using the given allocator for the repeated fields.
+   * \param alloc The allocator.
+   */
+  explicit Service(const allocator_type& alloc)
+      : observation_uid(alloc),
+        observations(alloc),
+        reagents(alloc),
+        notes(alloc) {}
+  /*!
+   * \brief Copy constructor using the given allocator.
+   * \param other The Service to copy.
+   * \param alloc The allocator.
+   */
+  Service(const Service& other, const allocator_type& alloc) : Service(alloc) {
+    *this = other;
+  }
+  /*!
+   * \brief Move constructor using the given allocator.
+   * \param other The Service to move from.
+   * \param alloc The allocator.
+   */
+  Service(Service&& other, const allocator_type& alloc) : Service(alloc) {
+    *this = std::move(other);
   }
   /*!
    * \brief Unique identifier of the sample on the Framework
@@ -2024,11 +2046,11 @@ struct Service {
   /*!
    * \brief The list of Observations.
    */
-  std::list<Observation> observations;
+  std::pmr::vector<Observation> observations;
   /*!
    * \brief The time the observation (test) was performed.
    */
-  time_t observation_dttm;
+  time_t observation_dttm = 0;
   /*!
    * \brief Was this test performed normally or under 'override' conditions.
    */
@@ -2050,11 +2072,11 @@ struct Service {
   /*!
    * \brief The list of Reagents.
    */
-  std::list<Reagent> reagents;
+  std::pmr::vector<Reagent> reagents;
   /*!
    * \brief The list of Notes.
    */
-  std::list<Note> notes;
+  std::pmr::vector<Note> notes;
 
   ///////////////////////
   /// Patient related ///
@@ -2080,18 +2102,47 @@ struct Service {
    */
   std::optional<ControlCalibration> control;
 
-  static bool IsValidRole(const std::string& role) {
-    return role == "UNK" || role == "OBS" || role == "LQC" || role == "EQC" ||
-           role == "CVR" || role == "CAL" || role == "PRF";
-  }
+  /*!
+   * \brief Check if the given code is a valid Role code.
+   * \param role The code to check.
+   * \return true if it is a valid code; false otherwise.
+   */
+  static bool IsValidRole(std::string_view role);
+  /*!
+   * \brief Get the enum value of the given Role code.
+   * \param code The code to parse.
+   * \param role Output value.
+   * \return true if it is a valid code; false otherwise.
+   */
+  static bool ParseRole(std::string_view code, Role& role);
 
-  static bool IsValidStatus(const std::string& status) {
-    return status == "NRM" || status == "OVR" || status == "UNK";
-  }
+  /*!
+   * \brief Check if the given code is a valid Status code.
+   * \param status The code to check.
+   * \return true if it is a valid code; false otherwise.
+   */
+  static bool IsValidStatus(std::string_view status);
+  /*!
+   * \brief Get the enum value of the given Status code.
+   * \param code The code to parse.
+   * \param status Output value.
+   * \return true if it is a valid code; false otherwise.
+   */
+  static bool ParseStatus(std::string_view code, Status& status);
 
-  static bool IsValidReason(const std::string& reason) {
-    return reason == "NEW" || reason == "RES" || reason == "EDT";
-  }
+  /*!
+   * \brief Check if the given code is a valid Reason code.
+   * \param reason The code to check.
+   * \return true if it is a valid code; false otherwise.
+   */
+  static bool IsValidReason(std::string_view reason);
+  /*!
+   * \brief Get the enum value of the given Reason code.
+   * \param code The code to parse.
+   * \param reason Output value.
+   * \return true if it is a valid code; false otherwise.
+   */
+  static bool ParseReason(std::string_view code, Reason& reason);
 };
 
 /*!
@@ -2114,22 +2165,20 @@ struct Terminate {
   Terminate() = default;
   /*!
    * \brief Copy constructor.
-   * \param terminate The Terminate to copy.
    */
-  Terminate(const Terminate& terminate) { *this = terminate; }
+  Terminate(const Terminate&) = default;
   /*!
-   * \brief Overloading assignment operator.
-   * \param terminate The Terminate's values to assign.
-   * \return Terminate.
+   * \brief Move constructor.
    */
-  Terminate& operator=(const Terminate& terminate) {
-    if (this == &terminate) {
-      return *this;
-    }
-    this->reason = terminate.reason;
-    this->note = terminate.note;
-    return *this;
-  }
+  Terminate(Terminate&&) = default;
+  /*!
+   * \brief Copy assignment operator.
+   */
+  Terminate& operator=(const Terminate&) = default;
+  /*!
+   * \brief Move assignment operator.
+   */
+  Terminate& operator=(Terminate&&) = default;
 
   /*!
    * \brief The reason for terminating the conversation.
@@ -2146,10 +2195,14 @@ struct Terminate {
    * \param trm_code The Reason type to check.
    * \return true if it is a reason value; false otherwise.
    */
-  static bool IsValidReason(const std::string& trm_reason) {
-    return trm_reason == "NRM" || trm_reason == "ABN" || trm_reason == "USR" ||
-           trm_reason == "UNK";
-  }
+  static bool IsValidReason(std::string_view trm_reason);
+  /*!
+   * \brief Get the enum value of the given Reason code.
+   * \param code The code to parse.
+   * \param reason Output value.
+   * \return true if it is a valid code; false otherwise.
+   */
+  static bool ParseReason(std::string_view code, Reason& reason);
 };
 
 /*!
@@ -0,0 +1,991 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "AccmDefinitions.h"
+
+namespace accm {
+/*!
+ * \brief Compile-time description of the accm:: data model.
+ *
+ * Every struct of AccmDefinitions.h has a FieldTable listing its members in
+ * wire order together with their POCT1-A names. The codecs, the comparison and
+ * the hashing below are all generated from these tables, so adding a field to
+ * the model only means adding one line to its table.
+ */
+namespace reflection {
+/*!
+ * \brief The Layout enum tells how a struct is laid out on the wire.
+ */
+enum class Layout {
+  ATTRIBUTES, /**< A single element whose fields are its attributes (e.g. CV).
+                 Repeated fields, if any, are written as child elements. */
+  ELEMENTS    /**< A tagged block whose fields are child elements (e.g. ACK). */
+};
+
+/*!
+ * \brief Describes one member of a struct.
+ */
+template <typename Class, typename Member, bool Serialized = true>
+struct Field {
+  using ClassType = Class;
+  using MemberType = Member;
+  /*!
+   * \brief false for members that are not part of the wire format, or that
+   * have a dedicated codec.
+   */
+  static constexpr bool kSerialized = Serialized;
+
+  /*!
+   * \brief Get the member from an object.
+   * \param object The object.
+   * \return A reference to the member.
+   */
+  constexpr const Member& Get(const Class& object) const {
+    return object.*member;
+  }
+  /*!
+   * \brief Get the member from an object.
+   * \param object The object.
+   * \return A reference to the member.
+   */
+  constexpr Member& Get(Class& object) const { return object.*member; }
+
+  /*!
+   * \brief POCT1-A element name (ELEMENTS layout) or attribute name
+   * (ATTRIBUTES layout); nullptr if the member is not serialized.
+   */
+  const char* name;
+  /*!
+   * \brief Pointer to the member.
+   */
+  Member Class::*member;
+};
+
+/*!
+ * \brief Helper to build a serialized Field deducing its types.
+ */
+template <typename Class, typename Member>
+constexpr Field<Class, Member> MakeField(const char* name,
+                                         Member Class::*member) {
+  return {name, member};
+}
+
+/*!
+ * \brief Helper to build a Field that only takes part in comparison and
+ * hashing.
+ */
+template <typename Class, typename Member>
+constexpr Field<Class, Member, false> MakeHiddenField(Member Class::*member) {
+  return {nullptr, member};
+}
+
+/*!
+ * \brief The FieldTable of a struct: kTag, kLayout and kFields.
+ * Only specializations are defined.
+ */
+template <typename T>
+struct FieldTable;
+
+/*!
+ * \brief The EnumTable of an enum: kCodes, the list of wire codes.
+ * Only specializations are defined.
+ */
+template <typename E>
+struct EnumTable;
+
+template <typename T, typename = void>
+struct IsDescribed : std::false_type {};
+template <typename T>
+struct IsDescribed<T, std::void_t<decltype(FieldTable<T>::kFields)>>
+    : std::true_type {};
+
+/*!
+ * \brief Check if T is described as a block of child elements.
+ */
+template <typename T, typename = void>
+struct IsComposite : std::false_type {};
+template <typename T>
+struct IsComposite<T, std::enable_if_t<IsDescribed<T>::value>>
+    : std::bool_constant<FieldTable<T>::kLayout == Layout::ELEMENTS> {};
+
+template <typename T>
+struct IsOptional : std::false_type {};
+template <typename T>
+struct IsOptional<std::optional<T>> : std::true_type {};
+
+template <typename T>
+struct IsSequence : std::false_type {};
+template <typename T, typename A>
+struct IsSequence<std::vector<T, A>> : std::true_type {};
+
+template <typename T>
+struct IsSet : std::false_type {};
+template <typename T>
+struct IsSet<std::set<T>> : std::true_type {};
+
+/*!
+ * \brief Call the visitor with every field of T, in order.
+ */
+template <typename T, typename Visitor>
+constexpr void ForEachField(Visitor&& visitor) {
+  std::apply([&](const auto&... field) { (visitor(field), ...); },
+             FieldTable<T>::kFields);
+}
+
+/*!
+ * \brief Call the visitor with the fields of T, in order, until it returns
+ * true.
+ * \return true if the visitor returned true for some field.
+ */
+template <typename T, typename Visitor>
+constexpr bool AnyField(Visitor&& visitor) {
+  return std::apply(
+      [&](const auto&... field) { return (visitor(field) || ...); },
+      FieldTable<T>::kFields);
+}
+
+/*!
+ * \brief FNV-1a hash of a wire code, usable at compile time.
+ */
+constexpr std::uint32_t HashCode(std::string_view code) {
+  std::uint32_t hash = 2166136261u;
+  for (char c : code) {
+    hash = (hash ^ static_cast<unsigned char>(c)) * 16777619u;
+  }
+  return hash;
+}
+
+/*!
+ * \brief Open-addressing hash index over EnumTable<E>::kCodes, built at
+ * compile time. The table is at most half full, so a lookup hashes the code
+ * once and compares it with one or two candidates, instead of comparing it
+ * with every code in turn.
+ */
+template <typename E>
+struct CodeIndex {
+  static constexpr std::size_t kCount = EnumTable<E>::kCodes.size();
+  static_assert(kCount < 0xFF, "Too many codes for a CodeIndex");
+
+  static constexpr std::size_t SizeFor(std::size_t count) {
+    std::size_t size = 4;
+    while (size < 2 * count) size *= 2;
+    return size;
+  }
+  static constexpr std::size_t kSize = SizeFor(kCount);
+  static constexpr std::uint8_t kEmpty = 0xFF;
+
+  static constexpr std::array<std::uint8_t, kSize> Build() {
+    std::array<std::uint8_t, kSize> slots{};
+    for (auto& slot : slots) slot = kEmpty;
+    for (std::size_t i = 0; i < kCount; ++i) {
+      std::size_t slot = HashCode(EnumTable<E>::kCodes[i].first) & (kSize - 1);
+      while (slots[slot] != kEmpty) slot = (slot + 1) & (kSize - 1);
+      slots[slot] = static_cast<std::uint8_t>(i);
+    }
+    return slots;
+  }
+  /*!
+   * \brief Position in kCodes of the code hashed to each slot; kEmpty if none.
+   */
+  static constexpr std::array<std::uint8_t, kSize> kSlots = Build();
+
+  /*!
+   * \brief Find the entry of a code.
+   * \return The entry of kCodes; nullptr if the code is unknown.
+   */
+  static constexpr const std::pair<std::string_view, E>* Find(
+      std::string_view code) {
+    std::size_t slot = HashCode(code) & (kSize - 1);
+    while (kSlots[slot] != kEmpty) {
+      const auto& entry = EnumTable<E>::kCodes[kSlots[slot]];
+      if (entry.first == code) return &entry;
+      slot = (slot + 1) & (kSize - 1);
+    }
+    return nullptr;
+  }
+};
+
+/*!
+ * \brief Get the wire code of an enum value.
+ * \return The code; empty if the value has none.
+ */
+template <typename E>
+constexpr std::string_view ToCode(E value) {
+  for (const auto& entry : EnumTable<E>::kCodes) {
+    if (entry.second == value) return entry.first;
+  }
+  return {};
+}
+
+/*!
+ * \brief Get the enum value of a wire code.
+ * \return true if the code is known; false otherwise.
+ */
+template <typename E>
+constexpr bool FromCode(std::string_view code, E& value) {
+  const auto* entry = CodeIndex<E>::Find(code);
+  if (!entry) return false;
+  value = entry->second;
+  return true;
+}
+
+///////////////////////////////////
+// Comparison and hashing
+///////////////////////////////////
+/*!
+ * \brief Combine a hash value into a seed.
+ */
+inline std::size_t HashCombine(std::size_t seed, std::size_t value) {
+  return seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+}
+
+/*!
+ * \brief Field-wise comparison and hashing, generated from the tables.
+ */
+template <typename T, typename = void>
+struct ValueTraits {
+  static bool Equal(const T& a, const T& b) { return a == b; }
+  static std::size_t Hash(const T& value) { return std::hash<T>()(value); }
+};
+
+template <typename T>
+struct ValueTraits<T, std::enable_if_t<IsDescribed<T>::value>> {
+  static bool Equal(const T& a, const T& b) {
+    return !AnyField<T>([&](const auto& field) {
+      using Member = typename std::decay_t<decltype(field)>::MemberType;
+      return !ValueTraits<Member>::Equal(field.Get(a), field.Get(b));
+    });
+  }
+  static std::size_t Hash(const T& value) {
+    std::size_t seed = 0;
+    ForEachField<T>([&](const auto& field) {
+      using Member = typename std::decay_t<decltype(field)>::MemberType;
+      seed = HashCombine(seed, ValueTraits<Member>::Hash(field.Get(value)));
+    });
+    return seed;
+  }
+};
+
+template <typename T>
+struct ValueTraits<std::optional<T>> {
+  static bool Equal(const std::optional<T>& a, const std::optional<T>& b) {
+    if (a.has_value() != b.has_value()) return false;
+    return !a || ValueTraits<T>::Equal(*a, *b);
+  }
+  static std::size_t Hash(const std::optional<T>& value) {
+    return value ? HashCombine(1, ValueTraits<T>::Hash(*value)) : 0;
+  }
+};
+
+template <typename Container>
+struct ContainerTraits {
+  using Item = typename Container::value_type;
+  static bool Equal(const Container& a, const Container& b) {
+    if (a.size() != b.size()) return false;
+    auto it = b.begin();
+    for (const auto& item : a) {
+      if (!ValueTraits<Item>::Equal(item, *it++)) return false;
+    }
+    return true;
+  }
+  static std::size_t Hash(const Container& values) {
+    std::size_t seed = values.size();
+    for (const auto& item : values) {
+      seed = HashCombine(seed, ValueTraits<Item>::Hash(item));
+    }
+    return seed;
+  }
+};
+
+template <typename T, typename A>
+struct ValueTraits<std::vector<T, A>> : ContainerTraits<std::vector<T, A>> {};
+template <typename T>
+struct ValueTraits<std::set<T>> : ContainerTraits<std::set<T>> {};
+
+template <>
+struct ValueTraits<std::tm> {
+  static bool Equal(const std::tm& a, const std::tm& b) {
+    return a.tm_year == b.tm_year && a.tm_mon == b.tm_mon &&
+           a.tm_mday == b.tm_mday && a.tm_hour == b.tm_hour &&
+           a.tm_min == b.tm_min && a.tm_sec == b.tm_sec;
+  }
+  static std::size_t Hash(const std::tm& value) {
+    return std::hash<long long>()(
+        ((((value.tm_year * 12LL + value.tm_mon) * 31 + value.tm_mday) * 24 +
+          value.tm_hour) *
+             60 +
+         value.tm_min) *
+            60 +
+        value.tm_sec);
+  }
+};
+
+template <typename Rep, typename Period>
+struct ValueTraits<std::chrono::duration<Rep, Period>> {
+  using Duration = std::chrono::duration<Rep, Period>;
+  static bool Equal(const Duration& a, const Duration& b) { return a == b; }
+  static std::size_t Hash(const Duration& value) {
+    return std::hash<Rep>()(value.count());
+  }
+};
+
+/*!
+ * \brief Compare two values member by member.
+ * \return true if every described member is equal.
+ */
+template <typename T>
+bool Equal(const T& a, const T& b) {
+  return ValueTraits<T>::Equal(a, b);
+}
+
+/*!
+ * \brief Hash a value member by member.
+ * \return The hash value.
+ */
+template <typename T>
+std::size_t Hash(const T& value) {
+  return ValueTraits<T>::Hash(value);
+}
+
+/*!
+ * \brief In-place reset, generated from the tables: strings and containers
+ * are emptied and optionals disengaged, so the memory they hold is kept.
+ */
+template <typename T, typename = void>
+struct ClearTraits {
+  static void Clear(T& value) { value = T(); }
+};
+
+template <typename T>
+struct ClearTraits<T, std::enable_if_t<IsDescribed<T>::value>> {
+  static void Clear(T& value) {
+    ForEachField<T>([&](const auto& field) {
+      using Member = typename std::decay_t<decltype(field)>::MemberType;
+      ClearTraits<Member>::Clear(field.Get(value));
+    });
+  }
+};
+
+template <typename T>
+struct ClearTraits<std::optional<T>> {
+  static void Clear(std::optional<T>& value) { value.reset(); }
+};
+
+template <typename C, typename Tr, typename A>
+struct ClearTraits<std::basic_string<C, Tr, A>> {
+  static void Clear(std::basic_string<C, Tr, A>& value) { value.clear(); }
+};
+
+template <typename T, typename A>
+struct ClearTraits<std::vector<T, A>> {
+  static void Clear(std::vector<T, A>& values) { values.clear(); }
+};
+
+template <typename T>
+struct ClearTraits<std::set<T>> {
+  static void Clear(std::set<T>& values) { values.clear(); }
+};
+
+/*!
+ * \brief Reset a value member by member to its default state, keeping the
+ * capacity of its strings and vectors.
+ */
+template <typename T>
+void Clear(T& value) {
+  ClearTraits<T>::Clear(value);
+}
+
+///////////////////////////////////
+// Enum tables
+///////////////////////////////////
+template <>
+struct EnumTable<AccessControl::Method> {
+  static constexpr std::array<std::pair<std::string_view, AccessControl::Method>,
+                              1>
+      kCodes{{{"ALL", AccessControl::Method::ALL}}};
+};
+
+template <>
+struct EnumTable<AccessControl::PermissionLevel> {
+  using Level = AccessControl::PermissionLevel;
+  static constexpr std::array<std::pair<std::string_view, Level>, 6> kCodes{
+      {{"SUPERVISOR", Level::SUPERVISOR},
+       {"KEY_OPERATOR", Level::KEY_OPERATOR},
+       {"TRUSTED_USER", Level::TRUSTED_USER},
+       {"USER", Level::USER},
+       {"SERVICE", Level::SERVICE},
+       {"TRAINING", Level::TRAINING}}};
+};
+
+template <>
+struct EnumTable<Ack::AckType> {
+  using Type = Ack::AckType;
+  static constexpr std::array<std::pair<std::string_view, Type>, 2> kCodes{
+      {{"AA", Type::AA}, {"AE", Type::AE}}};
+};
+
+template <>
+struct EnumTable<Directive::DirectivesStandard> {
+  using Command = Directive::DirectivesStandard;
+  static constexpr std::array<std::pair<std::string_view, Command>, 6> kCodes{
+      {{"SET_TIME", Command::SET_TIME},
+       {"LOCK", Command::LOCK},
+       {"UNLOCK", Command::UNLOCK},
+       {"GOTO_STANDBY", Command::GOTO_STANDBY},
+       {"GOTO_READY", Command::GOTO_READY},
+       {"START_CONTINUOUS", Command::START_CONTINUOUS}}};
+};
+
+template <>
+struct EnumTable<DeviceStaticCapabilities::ConnectionProfileType> {
+  using Profile = DeviceStaticCapabilities::ConnectionProfileType;
+  static constexpr std::array<std::pair<std::string_view, Profile>, 3> kCodes{
+      {{"CS", Profile::CS}, {"SA", Profile::SA}, {"AA", Profile::AA}}};
+};
+
+template <>
+struct EnumTable<DeviceEvent::SeverityLevel> {
+  using Level = DeviceEvent::SeverityLevel;
+  static constexpr std::array<std::pair<std::string_view, Level>, 3> kCodes{
+      {{"C", Level::C}, {"N", Level::N}, {"W", Level::W}}};
+};
+
+template <>
+struct EnumTable<DeviceStatus::DeviceCondition> {
+  using Condition = DeviceStatus::DeviceCondition;
+  static constexpr std::array<std::pair<std::string_view, Condition>, 5> kCodes{
+      {{"BUSY", Condition::BUSY}, {"LOCKED", Condition::LOCKED},
+       {"PARTIAL_LOCKED", Condition::PARTIAL_LOCKED},
+       {"READY", Condition::READY}, {"STANDBY", Condition::STANDBY}}};
+};
+
+template <>
+struct EnumTable<EndOfTopic::Code> {
+  using Topic = EndOfTopic::Code;
+  static constexpr std::array<std::pair<std::string_view, Topic>, 4> kCodes{
+      {{"EVS", Topic::EVS}, {"OBS", Topic::OBS}, {"OPL", Topic::OPL},
+       {"PTL", Topic::PTL}}};
+};
+
+template <>
+struct EnumTable<Escape::Code> {
+  using Detail = Escape::Code;
+  static constexpr std::array<std::pair<std::string_view, Detail>, 3> kCodes{
+      {{"OTH", Detail::OTH}, {"TOP", Detail::TOP}, {"CNC", Detail::CNC}}};
+};
+
+template <>
+struct EnumTable<Note::MsgType> {
+  static constexpr std::array<std::pair<std::string_view, Note::MsgType>, 2>
+      kCodes{{{"OPERATOR_COMMENT", Note::MsgType::OPERATOR_COMMENT},
+              {"ABNORMAL_FLAG", Note::MsgType::ABNORMAL_FLAG}}};
+};
+
+template <>
+struct EnumTable<Observation::Qualitative> {
+  using Value = Observation::Qualitative;
+  static constexpr std::array<std::pair<std::string_view, Value>, 11> kCodes{
+      {{"L", Value::L}, {"H", Value::H}, {"LL", Value::LL}, {"HH", Value::HH},
+       {"N", Value::N}, {"A", Value::A}, {"AA", Value::AA}, {"U", Value::U},
+       {"D", Value::D}, {"B", Value::B}, {"W", Value::W}}};
+};
+
+template <>
+struct EnumTable<Observation::Method> {
+  using Method = Observation::Method;
+  static constexpr std::array<std::pair<std::string_view, Method>, 6> kCodes{
+      {{"C", Method::C}, {"D", Method::D}, {"E", Method::E}, {"I", Method::I},
+       {"M", Method::M}, {"U", Method::U}}};
+};
+
+template <>
+struct EnumTable<Observation::Status> {
+  using Status = Observation::Status;
+  static constexpr std::array<std::pair<std::string_view, Status>, 4> kCodes{
+      {{"A", Status::A}, {"D", Status::D}, {"U", Status::U}, {"X", Status::X}}};
+};
+
+template <>
+struct EnumTable<Observation::Interpretation> {
+  using Flag = Observation::Interpretation;
+  static constexpr std::array<std::pair<std::string_view, Flag>, 14> kCodes{
+      {{"L", Flag::L}, {"H", Flag::H}, {"LL", Flag::LL}, {"HH", Flag::HH},
+       {"LESS", Flag::LESS}, {"GREATER", Flag::GREATER}, {"N", Flag::N},
+       {"A", Flag::A}, {"AA", Flag::AA}, {"null", Flag::null}, {"U", Flag::U},
+       {"D", Flag::D}, {"B", Flag::B}, {"W", Flag::W}}};
+};
+
+template <>
+struct EnumTable<Operator::Action> {
+  static constexpr std::array<std::pair<std::string_view, Operator::Action>, 2>
+      kCodes{{{"I", Operator::Action::I}, {"D", Operator::Action::D}}};
+};
+
+template <>
+struct EnumTable<Patient::Action> {
+  static constexpr std::array<std::pair<std::string_view, Patient::Action>, 2>
+      kCodes{{{"I", Patient::Action::I}, {"D", Patient::Action::D}}};
+};
+
+template <>
+struct EnumTable<Patient::Gender> {
+  using Gender = Patient::Gender;
+  static constexpr std::array<std::pair<std::string_view, Gender>, 6> kCodes{
+      {{"F", Gender::F}, {"M", Gender::M}, {"O", Gender::O}, {"U", Gender::U},
+       {"A", Gender::A}, {"N", Gender::N}}};
+};
+
+template <>
+struct EnumTable<Request::Type> {
+  using Type = Request::Type;
+  static constexpr std::array<std::pair<std::string_view, Type>, 2> kCodes{
+      {{"ROBS", Type::ROBS}, {"RDEV", Type::RDEV}}};
+};
+
+template <>
+struct EnumTable<Specimen::Source> {
+  using Source = Specimen::Source;
+  static constexpr std::array<std::pair<std::string_view, Source>, 54> kCodes{
+      {{"BE", Source::BE}, {"OU", Source::OU}, {"BN", Source::BN},
+       {"BU", Source::BU}, {"CT", Source::CT}, {"LA", Source::LA},
+       {"LAC", Source::LAC}, {"LACF", Source::LACF}, {"LD", Source::LD},
+       {"LE", Source::LE}, {"LEJ", Source::LEJ}, {"OS", Source::OS},
+       {"LF", Source::LF}, {"LG", Source::LG}, {"LH", Source::LH},
+       {"LIJ", Source::LIJ}, {"LLAQ", Source::LLAQ}, {"LLFA", Source::LLFA},
+       {"LMFA", Source::LMFA}, {"LN", Source::LN}, {"LPC", Source::LPC},
+       {"LSC", Source::LSC}, {"LT", Source::LT}, {"LUA", Source::LUA},
+       {"LUAQ", Source::LUAQ}, {"LUFA", Source::LUFA}, {"LVG", Source::LVG},
+       {"LVL", Source::LVL}, {"NB", Source::NB}, {"PA", Source::PA},
+       {"PERIN", Source::PERIN}, {"RA", Source::RA}, {"RAC", Source::RAC},
+       {"RACF", Source::RACF}, {"RD", Source::RD}, {"RE", Source::RE},
+       {"REJ", Source::REJ}, {"OD", Source::OD}, {"RF", Source::RF},
+       {"RG", Source::RG}, {"RH", Source::RH}, {"RIJ", Source::RIJ},
+       {"RLAQ", Source::RLAQ}, {"RLFA", Source::RLFA}, {"RMFA", Source::RMFA},
+       {"RN", Source::RN}, {"RPC", Source::RPC}, {"RSC", Source::RSC},
+       {"RT", Source::RT}, {"RUA", Source::RUA}, {"RUAQ", Source::RUAQ},
+       {"RUFA", Source::RUFA}, {"RVL", Source::RVL}, {"RVG", Source::RVG}}};
+};
+
+template <>
+struct EnumTable<Specimen::Type> {
+  using Type = Specimen::Type;
+  static constexpr std::array<std::pair<std::string_view, Type>, 125> kCodes{
+      {{"ABS", Type::ABS}, {"AMN", Type::AMN}, {"ASP", Type::ASP},
+       {"BPH", Type::BPH}, {"BIFL", Type::BIFL}, {"BLDA", Type::BLDA},
+       {"BBL", Type::BBL}, {"BLDC", Type::BLDC}, {"BLMV", Type::BLMV},
+       {"BPU", Type::BPU}, {"BLDV", Type::BLDV}, {"BON", Type::BON},
+       {"BRTH", Type::BRTH}, {"BRO", Type::BRO}, {"BRN", Type::BRN},
+       {"CALC", Type::CALC}, {"CDM", Type::CDM}, {"CNL", Type::CNL},
+       {"CTP", Type::CTP}, {"CSF", Type::CSF}, {"CVM", Type::CVM},
+       {"CVX", Type::CVX}, {"COL", Type::COL}, {"BLDCO", Type::BLDCO},
+       {"CNJT", Type::CNJT}, {"CUR", Type::CUR}, {"CYST", Type::CYST},
+       {"DIAF", Type::DIAF}, {"DOSE", Type::DOSE}, {"DRN", Type::DRN},
+       {"DUFL", Type::DUFL}, {"EAR", Type::EAR}, {"EARW", Type::EARW},
+       {"ELT", Type::ELT}, {"ENDC", Type::ENDC}, {"ENDM", Type::ENDM},
+       {"EOS", Type::EOS}, {"RBC", Type::RBC}, {"EYE", Type::EYE},
+       {"EXG", Type::EXG}, {"FIB", Type::FIB}, {"FLT", Type::FLT},
+       {"FIST", Type::FIST}, {"FLU", Type::FLU}, {"GAS", Type::GAS},
+       {"GAST", Type::GAST}, {"GEN", Type::GEN}, {"GENC", Type::GENC},
+       {"GENL", Type::GENL}, {"GENV", Type::GENV}, {"HAR", Type::HAR},
+       {"IHG", Type::IHG}, {"IT", Type::IT}, {"ISLT", Type::ISLT},
+       {"LAM", Type::LAM}, {"WBC", Type::WBC}, {"LN", Type::LN},
+       {"LNA", Type::LNA}, {"LNV", Type::LNV}, {"LIQ", Type::LIQ},
+       {"LYM", Type::LYM}, {"MAC", Type::MAC}, {"MAR", Type::MAR},
+       {"MEC", Type::MEC}, {"MBLD", Type::MBLD}, {"MLK", Type::MLK},
+       {"MILK", Type::MILK}, {"NAIL", Type::NAIL}, {"NOS", Type::NOS},
+       {"ORH", Type::ORH}, {"PAFL", Type::PAFL}, {"PAT", Type::PAT},
+       {"PRT", Type::PRT}, {"PLC", Type::PLC}, {"PLAS", Type::PLAS},
+       {"PLB", Type::PLB}, {"PLR", Type::PLR}, {"PMN", Type::PMN},
+       {"PPP", Type::PPP}, {"PRP", Type::PRP}, {"PUS", Type::PUS},
+       {"RT", Type::RT}, {"SAL", Type::SAL}, {"SMN", Type::SMN},
+       {"SER", Type::SER}, {"SKN", Type::SKN}, {"SKM", Type::SKM},
+       {"SPRM", Type::SPRM}, {"SPT", Type::SPT}, {"SPTC", Type::SPTC},
+       {"SPTT", Type::SPTT}, {"STON", Type::STON}, {"STL", Type::STL},
+       {"SWT", Type::SWT}, {"SNV", Type::SNV}, {"TEAR", Type::TEAR},
+       {"THRT", Type::THRT}, {"THRB", Type::THRB}, {"TISS", Type::TISS},
+       {"TISG", Type::TISG}, {"TLGI", Type::TLGI}, {"TLNG", Type::TLNG},
+       {"TISPL", Type::TISPL}, {"TSMI", Type::TSMI}, {"TISU", Type::TISU},
+       {"TUB", Type::TUB}, {"ULC", Type::ULC}, {"UMB", Type::UMB},
+       {"UMED", Type::UMED}, {"URTH", Type::URTH}, {"UR", Type::UR},
+       {"URC", Type::URC}, {"URT", Type::URT}, {"URNS", Type::URNS},
+       {"USUB", Type::USUB}, {"VITF", Type::VITF}, {"VOM", Type::VOM},
+       {"BLD", Type::BLD}, {"BDY", Type::BDY}, {"WAT", Type::WAT},
+       {"WICK", Type::WICK}, {"WND", Type::WND}, {"WNDA", Type::WNDA},
+       {"WNDE", Type::WNDE}, {"WNDD", Type::WNDD}}};
+};
+
+template <>
+struct EnumTable<Service::Role> {
+  using Role = Service::Role;
+  static constexpr std::array<std::pair<std::string_view, Role>, 7> kCodes{
+      {{"OBS", Role::OBS}, {"LQC", Role::LQC}, {"EQC", Role::EQC},
+       {"CVR", Role::CVR}, {"CAL", Role::CAL}, {"PRF", Role::PRF},
+       {"UNK", Role::UNK}}};
+};
+
+template <>
+struct EnumTable<Service::Status> {
+  using Status = Service::Status;
+  static constexpr std::array<std::pair<std::string_view, Status>, 4> kCodes{
+      {{"NRM", Status::NRM}, {"OVR", Status::OVR}, {"UNK", Status::UNK},
+       {"INI", Status::INI}}};
+};
+
+template <>
+struct EnumTable<Service::Reason> {
+  using Reason = Service::Reason;
+  static constexpr std::array<std::pair<std::string_view, Reason>, 3> kCodes{
+      {{"NEW", Reason::NEW}, {"RES", Reason::RES}, {"EDT", Reason::EDT}}};
+};
+
+template <>
+struct EnumTable<Terminate::Reason> {
+  using Reason = Terminate::Reason;
+  static constexpr std::array<std::pair<std::string_view, Reason>, 4> kCodes{
+      {{"NRM", Reason::NRM}, {"ABN", Reason::ABN}, {"USR", Reason::USR},
+       {"UNK", Reason::UNK}}};
+};
+
+///////////////////////////////////
+// Field tables
+///////////////////////////////////
+template <>
+struct FieldTable<PN> {
+  static constexpr const char* kTag = nullptr;
+  static constexpr Layout kLayout = Layout::ATTRIBUTES;
+  static constexpr auto kFields = std::make_tuple(
+      MakeField("V", &PN::value), MakeField("GIV", &PN::given),
+      MakeField("MID", &PN::middle), MakeField("FAM", &PN::family),
+      MakeField("PFX", &PN::prefix), MakeField("SFX", &PN::sufix),
+      MakeField("DEL", &PN::delimiter));
+};
+
+template <typename T>
+struct FieldTable<PQ<T>> {
+  static constexpr const char* kTag = nullptr;
+  static constexpr Layout kLayout = Layout::ATTRIBUTES;
+  static constexpr auto kFields = std::make_tuple(
+      MakeField("V", &PQ<T>::value), MakeField("U", &PQ<T>::unit));
+};
+
+/*!
+ * \brief The bounds of an IVL share the 'V' attribute ("[low;high]"), so they
+ * are described for comparison only and encoded by a dedicated codec.
+ */
+template <typename T>
+struct FieldTable<IVL<T>> {
+  static constexpr const char* kTag = nullptr;
+  static constexpr Layout kLayout = Layout::ATTRIBUTES;
+  static constexpr auto kFields = std::make_tuple(
+      MakeHiddenField(&IVL<T>::closed_low),
+      MakeHiddenField(&IVL<T>::closed_high),
+      MakeHiddenField(&IVL<T>::value_low),
+      MakeHiddenField(&IVL<T>::value_high), MakeField("U", &IVL<T>::unit));
+};
+
+template <>
+struct FieldTable<CV> {
+  static constexpr const char* kTag = nullptr;
+  static constexpr Layout kLayout = Layout::ATTRIBUTES;
+  static constexpr auto kFields = std::make_tuple(
+      MakeField("V", &CV::code), MakeField("DN", &CV::display_name),
+      MakeField("S", &CV::code_set_id), MakeField("SN", &CV::code_set_name),
+      MakeField("SV", &CV::code_set_version));
+};
+
+template <>
+struct FieldTable<CE> {
+  static constexpr const char* kTag = nullptr;
+  static constexpr Layout kLayout = Layout::ATTRIBUTES;
+  static constexpr auto kFields = std::tuple_cat(
+      FieldTable<CV>::kFields,
+      std::make_tuple(MakeField("TRN", &CE::transliterations)));
+};
+
+template <>
+struct FieldTable<AccessControl> {
+  static constexpr const char* kTag = "ACC";
+  static constexpr Layout kLayout = Layout::ELEMENTS;
+  static constexpr auto kFields = std::make_tuple(
+      MakeField("ACC.method_cd", &AccessControl::method),
+      MakeField("ACC.password", &AccessControl::password),
+      MakeField("ACC.active_date", &AccessControl::active_date),
+      MakeField("ACC.expiration_date", &AccessControl::expiration_date),
+      MakeField("ACC.permission_lvl_cd", &AccessControl::permission_lvl));
+};
+
+template <>
+struct FieldTable<Ack> {
+  static constexpr const char* kTag = "ACK";
+  static constexpr Layout kLayout = Layout::ELEMENTS;
+  static constexpr auto kFields = std::make_tuple(
+      MakeField("ACK.type_cd", &Ack::type),
+      MakeField("ACK.ack_control_id", &Ack::ack_control_id),
+      MakeField("ACK.note_txt", &Ack::note_txt),
+      MakeField("ACK.error_detail_cd", &Ack::error_detail));
+};
+
+template <>
+struct FieldTable<Directive> {
+  static constexpr const char* kTag = "DTV";
+  static constexpr Layout kLayout = Layout::ELEMENTS;
+  static constexpr auto kFields =
+      std::make_tuple(MakeField("DTV.command_cd", &Directive::command));
+};
+
+/*!
+ * \brief Only the application timeout of the connection profile travels on
+ * the wire; the reviewer's address is local configuration.
+ */
+template <>
+struct FieldTable<ConnectionProfile> {
+  static constexpr const char* kTag = "DCP";
+  static constexpr Layout kLayout = Layout::ELEMENTS;
+  static constexpr auto kFields = std::make_tuple(
+      MakeHiddenField(&ConnectionProfile::ip),
+      MakeHiddenField(&ConnectionProfile::port),
+      MakeField("DCP.application_timeout", &ConnectionProfile::timeout));
+};
+
+template <>
+struct FieldTable<DeviceStaticCapabilities> {
+  using DSC = DeviceStaticCapabilities;
+  static constexpr const char* kTag = "DSC";
+  static constexpr Layout kLayout = Layout::ELEMENTS;
+  static constexpr auto kFields = std::make_tuple(
+      MakeField("DSC.connection_profile_cd", &DSC::connection_profile),
+      MakeField("DSC.topics_supported_cd", &DSC::topics_supported),
+      MakeField("DSC.directives_supported_cd", &DSC::directives_supported),
+      MakeField("DSC.max_message_sz", &DSC::max_message_size));
+};
+
+template <>
+struct FieldTable<Device> {
+  static constexpr const char* kTag = "DEV";
+  static constexpr Layout kLayout = Layout::ELEMENTS;
+  static constexpr auto kFields = std::make_tuple(
+      MakeField("DEV.device_id", &Device::device_id),
+      MakeField("DEV.vendor_id", &Device::vendor_id),
+      MakeField("DEV.model_id", &Device::model_id),
+      MakeField("DEV.serial_id", &Device::serial_id),
+      MakeField("DEV.manufacturer_name", &Device::manufacturer_name),
+      MakeField("DEV.hw_version", &Device::hw_version),
+      MakeField("DEV.sw_version", &Device::sw_version),
+      MakeField("DEV.device_name", &Device::device_name),
+      MakeField("DEV.vmd_id", &Device::vmd_id),
+      MakeField("DEV.vmd_name", &Device::vmd_name),
+      MakeField("DCP", &Device::connection_profile),
+      MakeField("DSC", &Device::static_capabilities));
+};
+
+template <>
+struct FieldTable<DeviceEvent> {
+  static constexpr const char* kTag = "EVT";
+  static constexpr Layout kLayout = Layout::ELEMENTS;
+  static constexpr auto kFields = std::make_tuple(
+      MakeField("EVT.description", &DeviceEvent::description),
+      MakeField("EVT.event_dttm", &DeviceEvent::event_dttm),
+      MakeField("EVT.severity_cd", &DeviceEvent::severity));
+};
+
+template <>
+struct FieldTable<DeviceStatus> {
+  static constexpr const char* kTag = "DST";
+  static constexpr Layout kLayout = Layout::ELEMENTS;
+  static constexpr auto kFields = std::make_tuple(
+      MakeField("DST.status_dttm", &DeviceStatus::status_timestamp),
+      MakeField("DST.new_observations_qty", &DeviceStatus::new_observations),
+      MakeField("DST.new_events_qty", &DeviceStatus::new_events),
+      MakeField("DST.condition_cd", &DeviceStatus::condition),
+      MakeField("DST.observations_update_dttm",
+                &DeviceStatus::observations_update),
+      MakeField("DST.events_update_dttm", &DeviceStatus::events_update),
+      MakeField("DST.operators_update_dttm", &DeviceStatus::operators_update),
+      MakeField("DST.patients_update_dttm", &DeviceStatus::patients_update));
+};
+
+template <>
+struct FieldTable<EndOfTopic> {
+  static constexpr const char* kTag = "EOT";
+  static constexpr Layout kLayout = Layout::ELEMENTS;
+  static constexpr auto kFields = std::make_tuple(
+      MakeField("EOT.topic_cd", &EndOfTopic::topic),
+      MakeField("EOT.update_dttm", &EndOfTopic::update),
+      MakeField("EOT.eot_control_id", &EndOfTopic::eot_control));
+};
+
+template <>
+struct FieldTable<Escape> {
+  static constexpr const char* kTag = "ESC";
+  static constexpr Layout kLayout = Layout::ELEMENTS;
+  static constexpr auto kFields = std::make_tuple(
+      MakeField("ESC.esc_control_id", &Escape::esc_control_id),
+      MakeField("ESC.detail_cd", &Escape::detail),
+      MakeField("ESC.note_txt", &Escape::note));
+};
+
+/*!
+ * \brief The message type is given by the root element, not by the header.
+ */
+template <>
+struct FieldTable<Header> {
+  static constexpr const char* kTag = "HDR";
+  static constexpr Layout kLayout = Layout::ELEMENTS;
+  static constexpr auto kFields = std::make_tuple(
+      MakeField("HDR.control_id", &Header::control_id),
+      MakeField("HDR.version_id", &Header::version_id),
+      MakeField("HDR.creation_dttm", &Header::creation_dttm),
+      MakeHiddenField(&Header::message_type),
+      MakeField("HDR.encoding_chars", &Header::encoding_chars));
+};
+
+template <>
+struct FieldTable<Note> {
+  static constexpr const char* kTag = "NTE";
+  static constexpr Layout kLayout = Layout::ELEMENTS;
+  static constexpr auto kFields =
+      std::make_tuple(MakeField("NTE.type_cd", &Note::type_cd),
+                      MakeField("NTE.text", &Note::text),
+                      MakeField("NTE.code", &Note::code));
+};
+
+template <>
+struct FieldTable<Observation> {
+  static constexpr const char* kTag = "OBS";
+  static constexpr Layout kLayout = Layout::ELEMENTS;
+  static constexpr auto kFields = std::make_tuple(
+      MakeField("OBS.observation_id", &Observation::observation_id),
+      MakeField("OBS.value", &Observation::value),
+      MakeField("OBS.qualitative_value", &Observation::qualitative_value),
+      MakeField("OBS.method_cd", &Observation::method),
+      MakeField("OBS.status_cd", &Observation::status),
+      MakeField("OBS.interpretation_cd", &Observation::interpretation),
+      MakeField("OBS.normal_lo-hi_limit", &Observation::normal_lo_hi_limit),
+      MakeField("OBS.critical_lo-hi_limit",
+                &Observation::critical_lo_hi_limit),
+      MakeField("NTE", &Observation::notes));
+};
+
+template <>
+struct FieldTable<Operator> {
+  static constexpr const char* kTag = "OPR";
+  static constexpr Layout kLayout = Layout::ELEMENTS;
+  static constexpr auto kFields =
+      std::make_tuple(MakeField("OPR.operator_id", &Operator::operator_id),
+                      MakeField("OPR.action_cd", &Operator::action),
+                      MakeField("OPR.name", &Operator::name),
+                      MakeField("ACC", &Operator::access_controls));
+};
+
+template <>
+struct FieldTable<Order> {
+  static constexpr const char* kTag = "ORD";
+  static constexpr Layout kLayout = Layout::ELEMENTS;
+  static constexpr auto kFields = std::make_tuple(
+      MakeField("ORD.universal_service_id", &Order::universal_service_id),
+      MakeField("ORD.ordering_provider_id", &Order::ordering_provider_id),
+      MakeField("ORD.order_id", &Order::order_id));
+};
+
+template <>
+struct FieldTable<Patient> {
+  static constexpr const char* kTag = "PT";
+  static constexpr Layout kLayout = Layout::ELEMENTS;
+  static constexpr auto kFields =
+      std::make_tuple(MakeField("PT.patient_id", &Patient::patient_id),
+                      MakeField("PT.action_cd", &Patient::action),
+                      MakeField("PT.location", &Patient::location),
+                      MakeField("PT.name", &Patient::name),
+                      MakeField("PT.birth_date", &Patient::birth_date),
+                      MakeField("PT.gender_cd", &Patient::gender),
+                      MakeField("PT.weight", &Patient::weight),
+                      MakeField("PT.height", &Patient::height));
+};
+
+template <>
+struct FieldTable<Reagent> {
+  static constexpr const char* kTag = "RGT";
+  static constexpr Layout kLayout = Layout::ELEMENTS;
+  static constexpr auto kFields = std::make_tuple(
+      MakeField("RGT.name", &Reagent::name),
+      MakeField("RGT.lot_number", &Reagent::lot_number),
+      MakeField("RGT.expiration_date", &Reagent::expiration_date));
+};
+
+template <>
+struct FieldTable<Request> {
+  static constexpr const char* kTag = "REQ";
+  static constexpr Layout kLayout = Layout::ELEMENTS;
+  static constexpr auto kFields =
+      std::make_tuple(MakeField("REQ.request_cd", &Request::type));
+};
+
+template <>
+struct FieldTable<ControlCalibration> {
+  using CTC = ControlCalibration;
+  static constexpr const char* kTag = "CTC";
+  static constexpr Layout kLayout = Layout::ELEMENTS;
+  static constexpr auto kFields = std::make_tuple(
+      MakeField("CTC.name", &CTC::name),
+      MakeField("CTC.lot_number", &CTC::lot_number),
+      MakeField("CTC.expiration_date", &CTC::expiration_date),
+      MakeField("CTC.level_cd", &CTC::level),
+      MakeField("CTC.cal_ver_repetition", &CTC::cal_ver_repetition));
+};
+
+template <>
+struct FieldTable<Specimen> {
+  static constexpr const char* kTag = "SPC";
+  static constexpr Layout kLayout = Layout::ELEMENTS;
+  static constexpr auto kFields =
+      std::make_tuple(MakeField("SPC.specimen_dttm", &Specimen::specimen_dttm),
+                      MakeField("SPC.specimen_id", &Specimen::specimen_id),
+                      MakeField("SPC.source_cd", &Specimen::source),
+                      MakeField("SPC.type_cd", &Specimen::type));
+};
+
+/*!
+ * \brief On the wire the observations of a service are nested inside its <PT>
+ * (patient) or <CTC> (QC/calibration) block, when present. The codecs handle
+ * that nesting; everything else is generic.
+ */
+template <>
+struct FieldTable<Service> {
+  static constexpr const char* kTag = "SVC";
+  static constexpr Layout kLayout = Layout::ELEMENTS;
+  static constexpr auto kFields = std::make_tuple(
+      MakeField("SVC.observation_uid", &Service::observation_uid),
+      MakeField("SVC.role_cd", &Service::role),
+      MakeField("SVC.observation_dttm", &Service::observation_dttm),
+      MakeField("SVC.status_cd", &Service::status),
+      MakeField("SVC.reason_cd", &Service::reason),
+      MakeField("SVC.sequence_nbr", &Service::sequence),
+      MakeField("OPR", &Service::op), MakeField("RGT", &Service::reagents),
+      MakeField("NTE", &Service::notes), MakeField("PT", &Service::patient),
+      MakeField("ORD", &Service::order), MakeField("SPC", &Service::specimen),
+      MakeField("CTC", &Service::control),
+      MakeField("OBS", &Service::observations));
+};
+
+template <>
+struct FieldTable<Terminate> {
+  static constexpr const char* kTag = "TRM";
+  static constexpr Layout kLayout = Layout::ELEMENTS;
+  static constexpr auto kFields =
+      std::make_tuple(MakeField("TRM.reason_cd", &Terminate::reason),
+                      MakeField("TRM.note_txt", &Terminate::note));
+};
+}  // namespace reflection
+}  // namespace accm
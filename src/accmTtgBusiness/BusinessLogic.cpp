@@ -1,12 +1,166 @@
 #include "BusinessLogic.h"
 #include <QDebug>
+#include <chrono>
+#include <ctime>
+#include <thread>
+#include "CapturingTransport.h"
 #include "DbManager.h"
+#include "SocketTransport.h"
 
-BusinessLogic::BusinessLogic() { db_ = std::unique_ptr<IDb>(new DbManager); }
+BusinessLogic::BusinessLogic() {
+  db_ = std::unique_ptr<IDb>(new DbManager);
+  transport_ = SocketTransport::Create(io_backend_);
+}
 
-void BusinessLogic::StartUp() { db_->StartUp(); }
+void BusinessLogic::StartUp() {
+  db_->StartUp();
+  StartComms();
+}
 
 void BusinessLogic::ShutDown() {
+  if (replayer_) replayer_->Stop();
+  transport_->Disconnect();
+  if (stand_in_) stand_in_->Stop();
   //  QCoreApplication::processEvents();
   //  db_.reset();
 }
+
+bool BusinessLogic::GetCommsAddress(QString& ip, std::uint16_t& port) {
+  int value = 0;
+  if (!db_->GetCommsConf(ip, value)) return false;
+  if (value <= 0 || value > 65535) {
+    qDebug() << "Comms Error!! Invalid port: " << value;
+    return false;
+  }
+  port = static_cast<std::uint16_t>(value);
+  return true;
+}
+
+void BusinessLogic::StartComms() {
+  QString ip;
+  std::uint16_t port = 0;
+  if (!GetCommsAddress(ip, port)) return;
+  if (stand_in_policy_) StartStandIn(ip, port);
+
+  transport_->SetReceiver([this](std::string_view xml) { OnMessage(xml); });
+  transport_->SetClosedHandler([](const std::string& reason) {
+    qDebug() << "Comms closed: " << QString::fromStdString(reason);
+  });
+  if (!transport_->Connect(ip.toStdString(), port))
+    qDebug() << "Comms Error!! Cannot connect to " << ip << ":" << port;
+  else if (!replay_path_.empty()) {
+    replayer_ = std::make_unique<SessionReplayer>(*transport_, replay_options_);
+    if (!replayer_->Start(replay_path_))
+      qDebug() << "Comms Error!! Cannot replay "
+               << QString::fromStdString(replay_path_);
+  }
+}
+
+void BusinessLogic::EnableStandIn(const ManagerSimulator::Policy& policy) {
+  stand_in_policy_ = policy;
+}
+
+void BusinessLogic::SetIoBackend(EventLoop::Backend backend) {
+  io_backend_ = backend;
+  transport_ = SocketTransport::Create(io_backend_);
+}
+
+bool BusinessLogic::EnableCapture(const std::string& path) {
+  auto capture = std::make_shared<CaptureWriter>();
+  if (!capture->Open(path)) return false;
+  transport_ = std::unique_ptr<ITransport>(
+      new CapturingTransport(std::move(transport_), std::move(capture)));
+  return true;
+}
+
+void BusinessLogic::EnableReplay(const std::string& path, double speed) {
+  replay_path_ = path;
+  replay_options_.speed = speed;
+}
+
+void BusinessLogic::EnableValidation() { validate_ = true; }
+
+bool BusinessLogic::SimulateDevices(DeviceSimulator::Options options,
+                                    double duration, std::ostream& report) {
+  db_->StartUp();
+  QString ip;
+  if (!GetCommsAddress(ip, options.port)) return false;
+  if (stand_in_policy_) StartStandIn(ip, options.port);
+  options.ip = ip.toStdString();
+  options.io_backend = io_backend_;
+
+  ObservationGenerator::Options generator_options;
+  generator_options.start_time = std::time(nullptr);
+  ObservationGenerator generator(ObservationGenerator::GetDefaultAnalytes(),
+                                 generator_options);
+  DeviceSimulator simulator(options, generator);
+  auto start = std::chrono::steady_clock::now();
+  if (!simulator.Start()) {
+    qDebug() << "Comms Error!! Cannot start the device simulation on " << ip;
+    if (stand_in_) stand_in_->Stop();
+    return false;
+  }
+  auto deadline = std::chrono::steady_clock::time_point::max();
+  if (duration > 0)
+    deadline = start + std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           std::chrono::duration<double>(duration));
+  bool finished;
+  while (!(finished = simulator.IsFinished()) &&
+         std::chrono::steady_clock::now() < deadline)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  // Before stopping, which fails the devices still running.
+  SimulatorStats stats = simulator.GetStats();
+  simulator.Stop();
+  if (stand_in_) stand_in_->Stop();
+
+  if (!finished)
+    qDebug() << "Comms Error!! The device simulation hit its deadline of "
+             << duration << " seconds";
+  report << "devices=" << options.device_count
+         << " connected=" << stats.connected
+         << " completed=" << stats.completed << " failed=" << stats.failed
+         << " sent=" << stats.sent << " received=" << stats.received
+         << " rejected=" << stats.rejected
+         << " retransmitted=" << stats.retransmitted
+         << " timed_out=" << stats.timed_out << " invalid=" << stats.invalid
+         << " seconds=" << elapsed.count() << "\n";
+  if (stand_in_) {
+    ManagerStats stand_in = stand_in_->GetStats();
+    report << "stand-in connections=" << stand_in.connections
+           << " received=" << stand_in.received << " sent=" << stand_in.sent
+           << " rejected=" << stand_in.rejected << " lost=" << stand_in.lost
+           << " invalid=" << stand_in.invalid
+           << " refused=" << stand_in.refused << "\n";
+  }
+  simulator.WriteLatencyReport(report);
+  return finished;
+}
+
+void BusinessLogic::StartStandIn(const QString& ip, std::uint16_t port) {
+  ManagerSimulator::Options options;
+  options.ip = ip.toStdString();
+  options.port = port;
+  options.policy = *stand_in_policy_;
+  options.io_backend = io_backend_;
+  stand_in_ = std::make_unique<ManagerSimulator>(options);
+  if (!stand_in_->Start())
+    qDebug() << "Comms Error!! Cannot start the stand-in ACCM: "
+             << QString::fromStdString(stand_in_->GetLastError());
+}
+
+void BusinessLogic::OnMessage(std::string_view xml) {
+  std::unique_ptr<Message> message = decoder_.Decode(xml);
+  if (!message) {
+    qDebug() << "Comms Error!! Cannot decode: "
+             << QString::fromStdString(decoder_.GetLastError());
+    return;
+  }
+  if (validate_ && !validator_.Validate(*message)) {
+    for (const Violation& violation : validator_.GetViolations())
+      qDebug() << "Comms Error!! Invalid message: "
+               << QString::fromStdString(violation.path) << " "
+               << QString::fromStdString(violation.rule);
+  }
+}
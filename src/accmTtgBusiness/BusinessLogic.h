@@ -1,7 +1,18 @@
 #pragma once
+#include <cstdint>
 #include <memory>
+#include <optional>
+#include <ostream>
+#include <string>
 #include "IBusiness.h"
+#include "DeviceSimulator.h"
+#include "EventLoop.h"
 #include "IDb.h"
+#include "ITransport.h"
+#include "ManagerSimulator.h"
+#include "MessageDecoder.h"
+#include "MessageValidator.h"
+#include "SessionReplayer.h"
 
 class BusinessLogic : public IBusiness {
  public:
@@ -10,7 +21,71 @@ class BusinessLogic : public IBusiness {
 
   void StartUp() override;
   void ShutDown() override;
+  /*!
+   * \brief Run a ManagerSimulator on the commsConf address, for testing
+   * without an ACCM. Must be called before StartUp.
+   * \param policy How the stand-in answers.
+   */
+  void EnableStandIn(const ManagerSimulator::Policy& policy);
+  /*!
+   * \brief Select the I/O backend of the connection to the ACCM and of the
+   * stand-in; epoll if io_uring is not supported. Must be called before
+   * EnableCapture and StartUp.
+   * \param backend The backend.
+   */
+  void SetIoBackend(EventLoop::Backend backend);
+  /*!
+   * \brief Record the messages of the session into a capture file. Must be
+   * called before StartUp.
+   * \param path The path of the capture file.
+   * \return true if the file was created; false otherwise.
+   */
+  bool EnableCapture(const std::string& path);
+  /*!
+   * \brief Replay the outbound messages of a capture once connected. Must be
+   * called before StartUp.
+   * \param path The path of the capture file.
+   * \param speed The speed relative to the capture; 0 for maximum speed.
+   */
+  void EnableReplay(const std::string& path, double speed);
+  /*!
+   * \brief Check every message received from the ACCM against the POCT1-A
+   * rules and log the rules broken. Must be called before StartUp.
+   */
+  void EnableValidation();
+  /*!
+   * \brief Run a DeviceSimulator against the commsConf address instead of
+   * starting up: the stand-in, if enabled, answers the devices. Waits until
+   * every device completed or failed, or until the deadline, then writes the
+   * counters and the latency report, partial if the deadline was hit.
+   * \param options The simulation settings. The address and the I/O backend
+   * are replaced by the commsConf ones and by the selected backend.
+   * \param duration The longest the simulation runs, in seconds; 0 for no
+   * limit.
+   * \param report The stream receiving the report.
+   * \return true if every device completed or failed in time; false if the
+   * simulation could not start or hit the deadline.
+   */
+  bool SimulateDevices(DeviceSimulator::Options options, double duration,
+                       std::ostream& report);
+
+ private:
+  bool GetCommsAddress(QString& ip, std::uint16_t& port);
+  void StartComms();
+  void StartStandIn(const QString& ip, std::uint16_t port);
+  void OnMessage(std::string_view xml);
 
  private:
   std::unique_ptr<IDb> db_;
+  // Only used from the transport thread, which transport_ stops first.
+  MessageDecoder decoder_;
+  MessageValidator validator_;
+  bool validate_ = false;
+  std::unique_ptr<ITransport> transport_;
+  EventLoop::Backend io_backend_ = EventLoop::Backend::EPOLL;
+  std::optional<ManagerSimulator::Policy> stand_in_policy_;
+  std::unique_ptr<ManagerSimulator> stand_in_;
+  std::string replay_path_;
+  SessionReplayer::Options replay_options_;
+  std::unique_ptr<SessionReplayer> replayer_;
 };
@@ -0,0 +1,28 @@
+#include "CapturingTransport.h"
+#include <utility>
+
+CapturingTransport::CapturingTransport(std::unique_ptr<ITransport> transport,
+                                       std::shared_ptr<CaptureWriter> capture)
+    : transport_(std::move(transport)), capture_(std::move(capture)) {}
+
+void CapturingTransport::SetReceiver(Receiver receiver) {
+  transport_->SetReceiver(
+      [this, receiver = std::move(receiver)](std::string_view message) {
+        capture_->Record(CaptureRecord::Direction::INBOUND, message);
+        if (receiver) receiver(message);
+      });
+}
+
+// Outbound messages are recorded before being queued, so that they precede
+// their response in the capture.
+bool CapturingTransport::Send(std::string_view message) {
+  capture_->Record(CaptureRecord::Direction::OUTBOUND, message);
+  return transport_->Send(message);
+}
+
+bool CapturingTransport::Send(const Segment* segments, std::size_t count) {
+  std::string message;
+  for (std::size_t i = 0; i < count; ++i) message.append(segments[i].data);
+  capture_->Record(CaptureRecord::Direction::OUTBOUND, message);
+  return transport_->Send(segments, count);
+}
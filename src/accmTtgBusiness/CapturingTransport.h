@@ -0,0 +1,39 @@
+#pragma once
+#include <memory>
+#include <string>
+#include "ITransport.h"
+#include "SessionCapture.h"
+
+/*!
+ * \brief The CapturingTransport class records every message carried by
+ * another transport into a capture (see CaptureWriter): the messages it
+ * receives as inbound, and the messages sent through it as outbound.
+ */
+class CapturingTransport : public ITransport {
+ public:
+  /*!
+   * \brief Constructor.
+   * \param transport The transport carrying the messages.
+   * \param capture The capture. It must be open.
+   */
+  CapturingTransport(std::unique_ptr<ITransport> transport,
+                     std::shared_ptr<CaptureWriter> capture);
+
+  void SetReceiver(Receiver receiver) override;
+  inline void SetClosedHandler(ClosedHandler handler) override {
+    transport_->SetClosedHandler(std::move(handler));
+  }
+  inline bool Connect(const std::string& ip, std::uint16_t port) override {
+    return transport_->Connect(ip, port);
+  }
+  inline void Disconnect() override { transport_->Disconnect(); }
+  inline bool IsConnected() const override {
+    return transport_->IsConnected();
+  }
+  bool Send(std::string_view message) override;
+  bool Send(const Segment* segments, std::size_t count) override;
+
+ private:
+  std::unique_ptr<ITransport> transport_;
+  std::shared_ptr<CaptureWriter> capture_;
+};
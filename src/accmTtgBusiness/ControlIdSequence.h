@@ -0,0 +1,58 @@
+#pragma once
+#include <atomic>
+#include <charconv>
+#include <cstdint>
+#include <string>
+
+/*!
+ * \brief The ControlIdSequence class generates the HDR.control_id values of
+ * a conversation.
+ *
+ * Each conversation owns its own sequence, so conversations driven from
+ * different threads neither share a counter nor contend on it. Next is
+ * lock-free and may be called concurrently; the formatted id always fits in
+ * the small-string buffer of std::string, so assigning it does not allocate.
+ */
+class ControlIdSequence {
+ public:
+  /*!
+   * \brief Constructor.
+   * \param first The first control id of the sequence.
+   */
+  explicit ControlIdSequence(std::uint32_t first = 1) : next_(first) {}
+  /*!
+   * \brief Copy constructor is deleted.
+   */
+  ControlIdSequence(const ControlIdSequence&) = delete;
+  /*!
+   * \brief Assignment operator is deleted.
+   */
+  ControlIdSequence& operator=(const ControlIdSequence&) = delete;
+
+  /*!
+   * \brief Take the next control id.
+   * \return The control id.
+   */
+  inline std::uint32_t Next() {
+    return next_.fetch_add(1, std::memory_order_relaxed);
+  }
+  /*!
+   * \brief Take the next control id and write it as text.
+   * \param control_id Output control id. Its previous content is replaced.
+   */
+  inline void Next(std::string& control_id) {
+    char digits[10];
+    auto result = std::to_chars(digits, digits + sizeof(digits), Next());
+    control_id.assign(digits, result.ptr - digits);
+  }
+  /*!
+   * \brief Get the control id that the next call to Next will return.
+   * \return The control id.
+   */
+  inline std::uint32_t Peek() const {
+    return next_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  std::atomic<std::uint32_t> next_;
+};
@@ -0,0 +1,190 @@
+#include "Conversation.h"
+#include <algorithm>
+#include <charconv>
+#include <ctime>
+#include <utility>
+#include "Poct1Format.h"
+
+Conversation::Conversation(const accm::Device& device, const Options& options,
+                           ServiceSource source, Sender sender)
+    : options_(options),
+      source_(std::move(source)),
+      sender_(std::move(sender)),
+      observations_(true) {
+  if (options_.window == 0) options_.window = 1;
+  outstanding_.reserve(options_.window);
+  hello_.SetDevice(device);
+
+  accm::DeviceStatus status;
+  status.status_timestamp = std::time(nullptr);
+  status.new_observations = static_cast<int>(options_.observation_count);
+  status.condition = accm::CV("READY");
+  status_.SetDeviceStatus(std::move(status));
+
+  accm::EndOfTopic end_of_topic;
+  end_of_topic.topic = accm::CV("OBS");
+  end_of_topic_.SetEndOfTopic(std::move(end_of_topic));
+}
+
+bool Conversation::Start() {
+  if (state_ != State::IDLE) return false;
+  return SendAwaited(hello_, State::HELLO);
+}
+
+bool Conversation::OnMessage(const Message& message) {
+  switch (message.GetMessageType()) {
+    case accm::Header::MsgType::ACK_R01: {
+      const accm::Ack& ack = *static_cast<const MessageAck&>(message).GetAck();
+      accm::Ack::AckType type = accm::Ack::AckType::AA;
+      if (ack.type) accm::Ack::ParseType(ack.type->code, type);
+      return OnResponse(ack.ack_control_id, type == accm::Ack::AckType::AE
+                                                ? Response::REJECTED
+                                                : Response::ACCEPTED);
+    }
+    case accm::Header::MsgType::ESC_R01: {
+      const accm::Escape& escape =
+          *static_cast<const MessageEscape&>(message).GetEscape();
+      return OnResponse(escape.esc_control_id, Response::ESCAPED);
+    }
+    case accm::Header::MsgType::END_R01:
+      if (!Acknowledge(message)) return false;
+      if (!IsOver()) {
+        state_ = State::DONE;
+        outstanding_.clear();
+      }
+      return true;
+    default:
+      return Acknowledge(message);
+  }
+}
+
+bool Conversation::OnResponse(std::string_view control_id,
+                              Response response) {
+  std::uint32_t id = 0;
+  auto result =
+      std::from_chars(control_id.data(), control_id.data() + control_id.size(),
+                      id);
+  auto found = std::find(outstanding_.begin(), outstanding_.end(), id);
+  if (result.ec != std::errc() || found == outstanding_.end()) {
+    ++stats_.unexpected;
+    return false;
+  }
+  *found = outstanding_.back();
+  outstanding_.pop_back();
+  switch (response) {
+    case Response::ACCEPTED:
+      ++stats_.accepted;
+      break;
+    case Response::REJECTED:
+      ++stats_.rejected;
+      break;
+    case Response::ESCAPED:
+      ++stats_.escaped;
+      break;
+  }
+
+  switch (state_) {
+    case State::HELLO:
+      if (response == Response::ESCAPED) return Terminate("ABN", State::FAILED);
+      return SendAwaited(status_, State::STATUS);
+    case State::STATUS:
+      if (response == Response::ESCAPED) return Terminate("ABN", State::FAILED);
+      state_ = State::OBSERVATIONS;
+      return Pump();
+    case State::OBSERVATIONS:
+      if (response == Response::ESCAPED) topic_escaped_ = true;
+      return Pump();
+    case State::END_OF_TOPIC:
+      return Terminate("NRM", State::TERMINATE);
+    case State::TERMINATE:
+      state_ = State::DONE;
+      return true;
+    default:
+      return true;
+  }
+}
+
+bool Conversation::SendObservation() {
+  if (!CanSendObservation()) return false;
+  source_(observations_sent_++, service_);
+  observations_.SetService(std::move(service_));
+  return SendAwaited(observations_, State::OBSERVATIONS);
+}
+
+bool Conversation::OnTimeout(std::uint32_t control_id) {
+  if (std::find(outstanding_.begin(), outstanding_.end(), control_id) ==
+      outstanding_.end()) {
+    return false;
+  }
+  ++stats_.timed_out;
+  if (state_ == State::OBSERVATIONS) {
+    char digits[10];
+    auto result = std::to_chars(digits, digits + sizeof(digits), control_id);
+    accm::Escape escape;
+    escape.esc_control_id.assign(digits, result.ptr - digits);
+    escape.detail = accm::CV("CNC");
+    escape_.SetEscape(std::move(escape));
+    if (!Send(escape_)) return false;
+  }
+  return Terminate("ABN", State::FAILED);
+}
+
+bool Conversation::Pump() {
+  while (!options_.paced && CanSendObservation()) {
+    if (!SendObservation()) return false;
+  }
+  if (!outstanding_.empty()) return true;
+  // The topic is over: an escaped topic needs no EOT.R01.
+  if (topic_escaped_) return Terminate("NRM", State::TERMINATE);
+  if (observations_sent_ == options_.observation_count) {
+    return SendAwaited(end_of_topic_, State::END_OF_TOPIC);
+  }
+  return true;
+}
+
+bool Conversation::SendAwaited(Message& message, State state) {
+  state_ = state;
+  if (!Send(message)) return false;
+  std::uint32_t id = 0;
+  const std::string& control_id = message.GetHeader()->control_id;
+  std::from_chars(control_id.data(), control_id.data() + control_id.size(),
+                  id);
+  outstanding_.push_back(id);
+  return true;
+}
+
+bool Conversation::Send(Message& message) {
+  header_.message_type =
+      accm::CV(poct1::GetRootName(message.GetMessageType()));
+  header_.creation_dttm = std::time(nullptr);
+  message.SetHeader(header_, sequence_);
+  if (sender_(message)) {
+    ++stats_.sent;
+    return true;
+  }
+  state_ = State::FAILED;
+  outstanding_.clear();
+  return false;
+}
+
+bool Conversation::Terminate(std::string_view reason, State state) {
+  accm::Terminate terminate;
+  terminate.reason = accm::CV(reason);
+  terminate_.SetTerminate(std::move(terminate));
+  if (state != State::TERMINATE) {
+    // Nothing more is expected from the manager.
+    outstanding_.clear();
+    bool sent = Send(terminate_);
+    state_ = state;
+    return sent;
+  }
+  return SendAwaited(terminate_, state);
+}
+
+bool Conversation::Acknowledge(const Message& message) {
+  accm::Ack ack;
+  ack.ack_control_id = message.GetHeader()->control_id;
+  ack.type = accm::CV("AA");
+  ack_.SetAck(std::move(ack));
+  return Send(ack_);
+}
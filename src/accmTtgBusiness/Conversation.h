@@ -0,0 +1,217 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <vector>
+#include "ControlIdSequence.h"
+#include "Message.h"
+
+/*!
+ * \brief Counters of a Conversation.
+ */
+struct ConversationStats {
+  /*!
+   * \brief Messages handed to the sender, acknowledgments included.
+   */
+  std::uint32_t sent = 0;
+  /*!
+   * \brief Responses received to the messages of the device: AA and AE
+   * acknowledgments and escapes.
+   */
+  std::uint32_t accepted = 0;
+  std::uint32_t rejected = 0;
+  std::uint32_t escaped = 0;
+  /*!
+   * \brief Responses to no outstanding message (unknown or repeated
+   * control_id).
+   */
+  std::uint32_t unexpected = 0;
+  /*!
+   * \brief Messages given up for lack of response (OnTimeout).
+   */
+  std::uint32_t timed_out = 0;
+};
+
+/*!
+ * \brief The Conversation class drives the device side of a POCT1-A
+ * conversation: HEL.R01, DST.R01, the OBS.R01 topic, EOT.R01 and END.R01.
+ *
+ * The conversation is not tied to a transport: the messages to send are
+ * handed to a sender, and the messages received are given to OnMessage,
+ * which advances the state machine. HEL.R01, DST.R01, EOT.R01 and END.R01
+ * wait for their response; up to 'window' OBS.R01 messages are in flight at
+ * once, their acknowledgments being matched by control_id in any order. A
+ * window of 1 is the strict stop-and-wait exchange. In paced mode the
+ * observations are only sent on SendObservation, so that an open-loop driver
+ * decides when, independently of the responses.
+ *
+ * Responses are MessageAck (AA or AE, an AE only being counted) and
+ * MessageEscape: an escaped observation ends the topic, so no more
+ * observations are sent and the conversation terminates once the outstanding
+ * ones are answered; an escaped HEL.R01 or DST.R01 aborts the conversation.
+ * Other messages from the manager are acknowledged, and an END.R01 ends the
+ * conversation. The conversation does not keep time: its driver tells it when
+ * a message is given up (OnTimeout). A Conversation is not thread safe.
+ */
+class Conversation {
+ public:
+  /*!
+   * \brief The state of the conversation: the message waiting for its
+   * response, or the end.
+   */
+  enum class State {
+    IDLE,
+    HELLO,
+    STATUS,
+    OBSERVATIONS,
+    END_OF_TOPIC,
+    TERMINATE,
+    DONE,
+    FAILED
+  };
+  /*!
+   * \brief Function sending a message.
+   * \return true if the message was sent; false otherwise, which fails the
+   * conversation.
+   */
+  using Sender = std::function<bool(const Message& message)>;
+  /*!
+   * \brief Function filling the service of observation number 'number' (from
+   * 0) of the conversation.
+   */
+  using ServiceSource =
+      std::function<void(std::uint32_t number, accm::Service& service)>;
+
+  /*!
+   * \brief Conversation settings.
+   */
+  struct Options {
+    /*!
+     * \brief The number of OBS.R01 messages to send.
+     */
+    std::uint32_t observation_count = 0;
+    /*!
+     * \brief The maximum number of OBS.R01 messages waiting for their
+     * response; at least 1.
+     */
+    std::uint32_t window = 1;
+    /*!
+     * \brief Whether the observations are only sent by SendObservation.
+     */
+    bool paced = false;
+  };
+
+  /*!
+   * \brief Constructor.
+   * \param device The device identity sent in HEL.R01.
+   * \param options The conversation settings.
+   * \param source The source of the observations.
+   * \param sender The function sending the messages.
+   */
+  Conversation(const accm::Device& device, const Options& options,
+               ServiceSource source, Sender sender);
+  /*!
+   * \brief Copy constructor is deleted.
+   */
+  Conversation(const Conversation&) = delete;
+  /*!
+   * \brief Assignment operator is deleted.
+   */
+  Conversation& operator=(const Conversation&) = delete;
+
+  /*!
+   * \brief Start the conversation by sending HEL.R01.
+   * \return true if HEL.R01 was sent; false if the conversation already
+   * started or the sender failed.
+   */
+  bool Start();
+  /*!
+   * \brief Handle a message from the manager.
+   * \param message The message.
+   * \return false if it is a response to no outstanding message or the
+   * sender failed; true otherwise.
+   */
+  bool OnMessage(const Message& message);
+  /*!
+   * \brief Send the next observation (paced mode).
+   * \return true if it was sent; false if the topic is not under way, every
+   * observation was sent, the window is full or the sender failed.
+   * \see CanSendObservation
+   */
+  bool SendObservation();
+  /*!
+   * \brief Give up waiting for the response to a message, e.g. once its
+   * retransmissions went unanswered too. The conversation escalates: during
+   * the topic the device escapes from it (ESC.R01 CNC, referring to the
+   * message), then it terminates (END.R01 ABN) and fails.
+   * \param control_id The control_id of the message.
+   * \return true if the conversation was aborted; false if the message is
+   * not outstanding (e.g. answered meanwhile) or the sender failed.
+   */
+  bool OnTimeout(std::uint32_t control_id);
+  /*!
+   * \brief Check if SendObservation would send an observation.
+   * \return true if an observation can be sent now; false otherwise.
+   */
+  inline bool CanSendObservation() const {
+    return state_ == State::OBSERVATIONS && !topic_escaped_ &&
+           observations_sent_ < options_.observation_count &&
+           outstanding_.size() < options_.window;
+  }
+
+  /*!
+   * \brief Get the state.
+   * \return The state.
+   */
+  inline State GetState() const { return state_; }
+  /*!
+   * \brief Check if the conversation ended, normally or not.
+   * \return true if the state is DONE or FAILED; false otherwise.
+   */
+  inline bool IsOver() const {
+    return state_ == State::DONE || state_ == State::FAILED;
+  }
+  /*!
+   * \brief Get the number of messages waiting for their response.
+   * \return The number of outstanding messages.
+   */
+  inline std::size_t GetOutstanding() const { return outstanding_.size(); }
+  /*!
+   * \brief Get the counters.
+   * \return The counters.
+   */
+  inline const ConversationStats& GetStats() const { return stats_; }
+
+ private:
+  enum class Response { ACCEPTED, REJECTED, ESCAPED };
+
+  bool OnResponse(std::string_view control_id, Response response);
+  bool Pump();
+  bool SendAwaited(Message& message, State state);
+  bool Send(Message& message);
+  bool Terminate(std::string_view reason, State state);
+  bool Acknowledge(const Message& message);
+
+ private:
+  Options options_;
+  ServiceSource source_;
+  Sender sender_;
+  ControlIdSequence sequence_;
+  accm::Header header_;
+  State state_ = State::IDLE;
+  ConversationStats stats_;
+
+  // Control ids of the messages waiting for their response.
+  std::vector<std::uint32_t> outstanding_;
+  std::uint32_t observations_sent_ = 0;
+  bool topic_escaped_ = false;
+
+  MessageHello hello_;
+  MessageDeviceStatus status_;
+  MessageObservations observations_;
+  MessageEndOfTopic end_of_topic_;
+  MessageTerminate terminate_;
+  MessageAck ack_;
+  MessageEscape escape_;
+  accm::Service service_;
+};
@@ -0,0 +1,586 @@
+#include "DeviceSimulator.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <mutex>
+#include "Conversation.h"
+#include "MessageDecoder.h"
+#include "MessageEncoder.h"
+#include "MessagePool.h"
+#include "MessageValidator.h"
+#include "Poct1Format.h"
+#include "SocketTransport.h"
+#include "TimerQueue.h"
+#include "TimingWheel.h"
+#include "WorkStealingPool.h"
+
+namespace {
+constexpr std::int64_t kNanosecondsPerSecond = 1000000000;
+constexpr std::int64_t kNanosecondsPerMicrosecond = 1000;
+
+std::uint32_t ParseControlId(std::string_view control_id) {
+  std::uint32_t id = 0;
+  std::from_chars(control_id.data(), control_id.data() + control_id.size(),
+                  id);
+  return id;
+}
+}  // namespace
+
+// The state shared by the devices of a loop: the timers sending their paced
+// observations and the timeouts of their messages. Loop thread only.
+class DeviceSimulator::Worker {
+ public:
+  explicit Worker(EventLoop& loop) : timers_(loop), timeouts_(loop) {}
+
+  inline EventLoop& GetLoop() { return timers_.GetLoop(); }
+  inline TimerQueue& GetTimers() { return timers_; }
+  inline TimingWheel& GetTimeouts() { return timeouts_; }
+
+ private:
+  TimerQueue timers_;
+  TimingWheel timeouts_;
+};
+
+// The threads running the conversations, and the response latencies they
+// recorded.
+class DeviceSimulator::TaskPool {
+ public:
+  explicit TaskPool(std::size_t size) : pool_(size) {
+    latencies_.reserve(pool_.Size());
+    for (std::size_t i = 0; i < pool_.Size(); ++i) {
+      latencies_.push_back(std::make_unique<ThreadLatencies>());
+    }
+  }
+
+  inline void Post(WorkStealingPool::Task task) { pool_.Post(std::move(task)); }
+  inline void Stop() { pool_.Stop(); }
+
+  // Task threads only.
+  void Record(accm::Header::MsgType type, std::uint64_t latency) {
+    int index = pool_.GetThreadIndex();
+    if (index < 0) return;
+    ThreadLatencies& thread = *latencies_[index];
+    std::lock_guard<std::mutex> lock(thread.mutex);
+    thread.latencies[static_cast<std::size_t>(type)].Record(latency);
+  }
+
+  void Merge(Latencies& latencies) const {
+    for (const auto& thread : latencies_) {
+      std::lock_guard<std::mutex> lock(thread->mutex);
+      for (std::size_t i = 0; i < latencies.size(); ++i) {
+        latencies[i].Merge(thread->latencies[i]);
+      }
+    }
+  }
+
+ private:
+  // Only contended while the latencies are merged.
+  struct ThreadLatencies {
+    std::mutex mutex;
+    Latencies latencies;
+  };
+
+  WorkStealingPool pool_;
+  std::vector<std::unique_ptr<ThreadLatencies>> latencies_;
+};
+
+class DeviceSimulator::VirtualDevice {
+ private:
+  // A message waiting for its response. It is kept, with its timer, for
+  // the next message once answered.
+  struct Pending {
+    std::uint32_t id = 0;
+    accm::Header::MsgType type = accm::Header::MsgType::ACK_R01;
+    std::int64_t sent = 0;
+    std::uint32_t retransmits = 0;
+    // The message as sent, with an acknowledgment timeout only (see
+    // Transmit).
+    std::string bytes;
+    std::shared_ptr<const std::string> body;
+    // When the timer expires; 0 once answered. An expiry reported after the
+    // timer was cancelled or scheduled again is ignored.
+    std::int64_t deadline = 0;
+    // Loop thread only.
+    TimingWheel::Timer timer;
+  };
+
+  // What the loop thread hands over to the device (see Deliver).
+  enum class EventType { START, MESSAGE, CLOSED, PACE, TIMEOUT };
+  struct Event {
+    EventType type;
+    std::int64_t time;
+    // The size of the message, in the bytes received.
+    std::size_t size;
+    Pending* pending;
+  };
+
+ public:
+  VirtualDevice(std::uint32_t number, const Options& options,
+                const ObservationGenerator& generator,
+                const SharedBodies& shared_bodies, Counters& counters,
+                Worker& worker, TaskPool& tasks)
+      : counters_(counters),
+        worker_(worker),
+        tasks_(tasks),
+        loop_(worker.GetLoop()),
+        shared_bodies_(shared_bodies),
+        ack_timeout_(static_cast<std::int64_t>(options.ack_timeout) *
+                     kNanosecondsPerMicrosecond),
+        retransmit_count_(options.retransmit_count),
+        validate_(options.validate),
+        conversation_(
+            MakeDevice(number, options),
+            {options.observation_count, options.window, options.rate > 0},
+            [this, &generator, first = static_cast<std::uint64_t>(number) *
+                                       options.observation_count](
+                std::uint32_t observation, accm::Service& service) {
+              observation_ = observation;
+              if (shared_bodies_.empty()) {
+                generator.Generate(first + observation, service);
+              }
+            },
+            [this](const Message& message) { return Send(message); }),
+        transport_(SocketTransport::Create(loop_)) {
+    transport_->SetReceiver(
+        [this](std::string_view xml) { Deliver(EventType::MESSAGE, xml); });
+    transport_->SetClosedHandler(
+        [this](const std::string&) { Deliver(EventType::CLOSED); });
+    if (options.rate > 0) {
+      interval_ = std::max<std::int64_t>(
+          std::llround(kNanosecondsPerSecond / options.rate), 1);
+      // Spread the devices over an interval rather than sending in bursts.
+      phase_ = interval_ * number / std::max<std::uint32_t>(
+                                        options.device_count, 1);
+    }
+  }
+
+  bool Start(const Options& options) {
+    if (!transport_->Connect(options.ip, options.port)) return false;
+    Deliver(EventType::START);
+    return true;
+  }
+  inline void Stop() { transport_->Disconnect(); }
+  inline bool IsConnected() const { return transport_->IsConnected(); }
+
+ private:
+  static accm::Device MakeDevice(std::uint32_t number,
+                                 const Options& options) {
+    char digits[10];
+    auto result = std::to_chars(digits, digits + sizeof(digits), number);
+    std::size_t length = result.ptr - digits;
+    accm::Device device(options.device_id_prefix);
+    device.device_id.append(length < 6 ? 6 - length : 0, '0');
+    device.device_id.append(digits, length);
+    device.vendor_id = "SIM";
+    device.model_id = "ACCM-TTG";
+    device.serial_id = device.device_id;
+    device.sw_version = "1.0";
+    device.connection_profile.port = 0;
+    return device;
+  }
+
+  // Hand an event over to the task pool. May be called from any thread.
+  void Deliver(EventType type, std::string_view xml = {},
+               Pending* pending = nullptr) {
+    bool run;
+    {
+      std::lock_guard<std::mutex> lock(inbox_mutex_);
+      inbox_.push_back({type, TimerQueue::Now(), xml.size(), pending});
+      // Copied: the message is only valid during the call.
+      inbox_bytes_.append(xml);
+      run = !running_;
+      running_ = true;
+    }
+    if (run) tasks_.Post([this]() { Run(); });
+  }
+
+  // Handle the events delivered so far, in order.
+  void Run() {
+    {
+      std::lock_guard<std::mutex> lock(inbox_mutex_);
+      events_.swap(inbox_);
+      event_bytes_.swap(inbox_bytes_);
+    }
+    std::string_view bytes = event_bytes_;
+    for (const Event& event : events_) {
+      switch (event.type) {
+        case EventType::START:
+          if (!conversation_.Start()) Finish();
+          break;
+        case EventType::MESSAGE:
+          OnMessage(bytes.substr(0, event.size), event.time);
+          bytes.remove_prefix(event.size);
+          break;
+        case EventType::CLOSED:
+          OnClosed();
+          break;
+        case EventType::PACE:
+          scheduled_ = false;
+          Pace(event.time);
+          break;
+        case EventType::TIMEOUT:
+          OnTimeout(*event.pending, event.time);
+          break;
+      }
+    }
+    events_.clear();
+    event_bytes_.clear();
+    bool again;
+    {
+      std::lock_guard<std::mutex> lock(inbox_mutex_);
+      again = !inbox_.empty();
+      running_ = again;
+    }
+    // In another task: a busy device takes turns with the others.
+    if (again) tasks_.Post([this]() { Run(); });
+  }
+
+  bool Send(const Message& message) {
+    accm::Header::MsgType type = message.GetMessageType();
+    // A paced observation is late from its scheduled time on.
+    std::int64_t sent = interval_ > 0 && type == accm::Header::MsgType::OBS_R01
+                            ? intended_
+                            : TimerQueue::Now();
+    buffer_.clear();
+    std::shared_ptr<const std::string> body;
+    if (type == accm::Header::MsgType::OBS_R01 && !shared_bodies_.empty()) {
+      // Only the header is encoded; the rest is written from where it is.
+      encoder_.EncodeHeader(*message.GetHeader(), buffer_);
+      body = shared_bodies_[observation_];
+    } else if (!encoder_.Encode(message, buffer_)) {
+      return false;
+    }
+    if (!Transmit(type, buffer_, body)) return false;
+    counters_.sent.fetch_add(1, std::memory_order_relaxed);
+    if (type != accm::Header::MsgType::ACK_R01) {
+      Track(ParseControlId(message.GetHeader()->control_id), type, sent,
+            std::move(body));
+    }
+    return true;
+  }
+
+  // Send a message: 'bytes' is its encoding, or the encoding of its header
+  // if its body is shared.
+  bool Transmit(accm::Header::MsgType type, const std::string& bytes,
+                const std::shared_ptr<const std::string>& body) {
+    if (!body) return transport_->Send(bytes);
+    const ITransport::Segment segments[] = {
+        ITransport::Segment::Static(MessageEncoder::GetPrologue(type)),
+        ITransport::Segment::Copied(bytes),
+        ITransport::Segment::Shared(body),
+        ITransport::Segment::Static(MessageEncoder::GetEpilogue(type))};
+    return transport_->Send(segments, 4);
+  }
+
+  // Wait for the response to a message just sent, from buffer_.
+  void Track(std::uint32_t id, accm::Header::MsgType type, std::int64_t sent,
+             std::shared_ptr<const std::string> body) {
+    std::unique_ptr<Pending> pending;
+    if (spare_.empty()) {
+      pending = std::make_unique<Pending>();
+      pending->timer.SetCallback([this, p = pending.get()]() {
+        Deliver(EventType::TIMEOUT, {}, p);
+      });
+    } else {
+      pending = std::move(spare_.back());
+      spare_.pop_back();
+    }
+    pending->id = id;
+    pending->type = type;
+    pending->sent = sent;
+    pending->retransmits = 0;
+    if (ack_timeout_ > 0) {
+      // Kept to be sent again.
+      pending->bytes = buffer_;
+      pending->body = std::move(body);
+      Arm(*pending);
+    }
+    pending_.push_back(std::move(pending));
+  }
+
+  // The timers run on the loop thread.
+  void Arm(Pending& pending) {
+    pending.deadline = TimerQueue::Now() + ack_timeout_;
+    loop_.Post([this, p = &pending, due = pending.deadline]() {
+      worker_.GetTimeouts().Schedule(p->timer, due);
+    });
+  }
+
+  void Disarm(Pending& pending) {
+    if (pending.deadline == 0) return;
+    pending.deadline = 0;
+    loop_.Post([p = &pending]() { p->timer.Cancel(); });
+  }
+
+  void OnTimeout(Pending& pending, std::int64_t now) {
+    if (finished_ || pending.deadline == 0 || now < pending.deadline) return;
+    if (pending.retransmits < retransmit_count_) {
+      ++pending.retransmits;
+      if (!Transmit(pending.type, pending.bytes, pending.body)) {
+        Finish();
+        return;
+      }
+      counters_.sent.fetch_add(1, std::memory_order_relaxed);
+      counters_.retransmitted.fetch_add(1, std::memory_order_relaxed);
+      Arm(pending);
+      return;
+    }
+    pending.deadline = 0;
+    counters_.timed_out.fetch_add(1, std::memory_order_relaxed);
+    conversation_.OnTimeout(pending.id);
+    if (conversation_.IsOver()) Finish();
+  }
+
+  // 'now' is the time the message was received.
+  void OnMessage(std::string_view xml, std::int64_t now) {
+    counters_.received.fetch_add(1, std::memory_order_relaxed);
+    if (finished_) return;
+    PoolPtr<Message> message = decoder_.Decode(xml, pool_);
+    if (message) {
+      RecordLatency(*message, now);
+      if (validate_ && !validator_.Validate(*message)) {
+        counters_.invalid.fetch_add(1, std::memory_order_relaxed);
+      }
+      conversation_.OnMessage(*message);
+    }
+    if (conversation_.IsOver()) {
+      Finish();
+    } else if (interval_ > 0) {
+      Pace(now);
+    }
+  }
+
+  void RecordLatency(const Message& message, std::int64_t now) {
+    std::string_view control_id;
+    switch (message.GetMessageType()) {
+      case accm::Header::MsgType::ACK_R01:
+        control_id =
+            static_cast<const MessageAck&>(message).GetAck()->ack_control_id;
+        break;
+      case accm::Header::MsgType::ESC_R01:
+        control_id = static_cast<const MessageEscape&>(message)
+                         .GetEscape()
+                         ->esc_control_id;
+        break;
+      default:
+        return;
+    }
+    std::uint32_t id = ParseControlId(control_id);
+    auto found = std::find_if(
+        pending_.begin(), pending_.end(),
+        [id](const std::unique_ptr<Pending>& p) { return p->id == id; });
+    if (found == pending_.end()) return;
+    Pending& pending = **found;
+    tasks_.Record(pending.type, static_cast<std::uint64_t>(
+                                    std::max<std::int64_t>(now - pending.sent,
+                                                           0)));
+    Disarm(pending);
+    pending.body.reset();
+    spare_.push_back(std::move(*found));
+    *found = std::move(pending_.back());
+    pending_.pop_back();
+  }
+
+  // Send the observations due by 'now' and schedule the next one. An
+  // observation held back by the window is sent on the next response.
+  void Pace(std::int64_t now) {
+    if (finished_ || scheduled_ ||
+        conversation_.GetState() != Conversation::State::OBSERVATIONS) {
+      return;
+    }
+    if (next_ < 0) next_ = now + phase_;
+    while (next_ <= now && conversation_.CanSendObservation()) {
+      intended_ = next_;
+      next_ += interval_;
+      if (!conversation_.SendObservation()) {
+        Finish();
+        return;
+      }
+    }
+    if (conversation_.CanSendObservation()) {
+      scheduled_ = true;
+      loop_.Post([this, due = next_]() {
+        worker_.GetTimers().Schedule(due,
+                                     [this]() { Deliver(EventType::PACE); });
+      });
+    }
+  }
+
+  void OnClosed() {
+    if (finished_) return;
+    finished_ = true;
+    counters_.failed.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void Finish() {
+    if (finished_) return;
+    finished_ = true;
+    for (auto& pending : pending_) Disarm(*pending);
+    const ConversationStats& stats = conversation_.GetStats();
+    counters_.rejected.fetch_add(stats.rejected + stats.escaped,
+                                 std::memory_order_relaxed);
+    if (conversation_.GetState() == Conversation::State::DONE) {
+      counters_.completed.fetch_add(1, std::memory_order_relaxed);
+    } else {
+      counters_.failed.fetch_add(1, std::memory_order_relaxed);
+    }
+    // After the flush of the last messages (e.g. the ACK.R01 of an END.R01),
+    // which is already posted.
+    loop_.Post([this]() { transport_->Disconnect(); });
+  }
+
+ private:
+  Counters& counters_;
+  Worker& worker_;
+  TaskPool& tasks_;
+  EventLoop& loop_;
+  const SharedBodies& shared_bodies_;
+  // Schedule of the paced observations, in nanoseconds; interval_ is 0 when
+  // they are not paced.
+  std::int64_t interval_ = 0;
+  std::int64_t phase_ = 0;
+  // In nanoseconds; 0 without timeout.
+  const std::int64_t ack_timeout_;
+  const std::uint32_t retransmit_count_;
+  const bool validate_;
+
+  // Events delivered and not handled yet; running_ while a task handles
+  // them.
+  std::mutex inbox_mutex_;
+  std::vector<Event> inbox_;
+  std::string inbox_bytes_;
+  bool running_ = false;
+
+  // Task pool only, one task at a time.
+  std::vector<Event> events_;
+  std::string event_bytes_;
+  MessageDecoder decoder_;
+  MessageEncoder encoder_;
+  MessagePool pool_{4};
+  MessageValidator validator_;
+  std::string buffer_;
+  Conversation conversation_;
+  std::vector<std::unique_ptr<Pending>> pending_;
+  std::vector<std::unique_ptr<Pending>> spare_;
+  // The number of the observation being sent.
+  std::uint32_t observation_ = 0;
+  std::int64_t next_ = -1;
+  std::int64_t intended_ = 0;
+  bool scheduled_ = false;
+  bool finished_ = false;
+
+  std::unique_ptr<SocketTransport> transport_;
+};
+
+DeviceSimulator::DeviceSimulator(const Options& options,
+                                 const ObservationGenerator& generator)
+    : options_(options),
+      generator_(generator),
+      pool_(options.worker_count, options.io_backend) {
+  if (options_.total_rate > 0 && options_.device_count > 0) {
+    options_.rate = options_.total_rate / options_.device_count;
+  }
+  if (options_.shared_observations) {
+    MessageEncoder encoder;
+    MessageObservations observations(true);
+    shared_bodies_.reserve(options_.observation_count);
+    for (std::uint32_t i = 0; i < options_.observation_count; ++i) {
+      accm::Service service;
+      generator_.Generate(i, service);
+      observations.SetService(std::move(service));
+      auto body = std::make_shared<std::string>();
+      encoder.EncodeBody(observations, *body);
+      shared_bodies_.push_back(std::move(body));
+    }
+  }
+  workers_.reserve(pool_.Size());
+  for (std::size_t i = 0; i < pool_.Size(); ++i) {
+    workers_.push_back(std::make_unique<Worker>(pool_.Get(i)));
+  }
+  tasks_ = std::make_unique<TaskPool>(options_.task_thread_count);
+}
+
+DeviceSimulator::~DeviceSimulator() {
+  Stop();
+  devices_.clear();
+}
+
+bool DeviceSimulator::Start() {
+  if (!devices_.empty()) return false;
+  devices_.reserve(options_.device_count);
+  for (std::uint32_t i = 0; i < options_.device_count; ++i) {
+    devices_.push_back(std::make_unique<VirtualDevice>(
+        i, options_, generator_, shared_bodies_, counters_,
+        *workers_[i % workers_.size()], *tasks_));
+    if (!devices_.back()->Start(options_)) {
+      // Only the address can be wrong: the devices share it.
+      if (i == 0) {
+        devices_.clear();
+        return false;
+      }
+      counters_.failed.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+  return true;
+}
+
+void DeviceSimulator::Stop() {
+  // The conversations first: they no longer use the timers and transports.
+  tasks_->Stop();
+  for (auto& worker : workers_) {
+    worker->GetTimers().Stop();
+    worker->GetTimeouts().Stop();
+  }
+  for (auto& device : devices_) device->Stop();
+}
+
+bool DeviceSimulator::IsFinished() const {
+  return counters_.completed.load(std::memory_order_relaxed) +
+             counters_.failed.load(std::memory_order_relaxed) >=
+         devices_.size();
+}
+
+SimulatorStats DeviceSimulator::GetStats() const {
+  SimulatorStats stats;
+  for (const auto& device : devices_) {
+    if (device->IsConnected()) ++stats.connected;
+  }
+  stats.completed = counters_.completed.load(std::memory_order_relaxed);
+  stats.failed = counters_.failed.load(std::memory_order_relaxed);
+  stats.sent = counters_.sent.load(std::memory_order_relaxed);
+  stats.received = counters_.received.load(std::memory_order_relaxed);
+  stats.rejected = counters_.rejected.load(std::memory_order_relaxed);
+  stats.retransmitted =
+      counters_.retransmitted.load(std::memory_order_relaxed);
+  stats.timed_out = counters_.timed_out.load(std::memory_order_relaxed);
+  stats.invalid = counters_.invalid.load(std::memory_order_relaxed);
+  return stats;
+}
+
+void DeviceSimulator::GetLatencies(Latencies& latencies) const {
+  for (LatencyHistogram& histogram : latencies) histogram.Reset();
+  tasks_->Merge(latencies);
+}
+
+void DeviceSimulator::WriteLatencyReport(std::ostream& stream) const {
+  Latencies latencies;
+  GetLatencies(latencies);
+  char line[160];
+  for (std::size_t i = 0; i < latencies.size(); ++i) {
+    const LatencyHistogram& histogram = latencies[i];
+    if (histogram.GetCount() == 0) continue;
+    std::string_view name =
+        poct1::GetRootName(static_cast<accm::Header::MsgType>(i));
+    std::snprintf(line, sizeof(line),
+                  "%-8.*s count=%llu p50=%.1fus p99=%.1fus p99.9=%.1fus "
+                  "max=%.1fus\n",
+                  static_cast<int>(name.size()), name.data(),
+                  static_cast<unsigned long long>(histogram.GetCount()),
+                  histogram.GetValueAtPercentile(50) / 1e3,
+                  histogram.GetValueAtPercentile(99) / 1e3,
+                  histogram.GetValueAtPercentile(99.9) / 1e3,
+                  histogram.GetMax() / 1e3);
+    stream << line;
+  }
+}
@@ -0,0 +1,254 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "AccmDefinitions.h"
+#include "EventLoop.h"
+#include "LatencyHistogram.h"
+#include "ObservationGenerator.h"
+
+/*!
+ * \brief Counters of a DeviceSimulator run.
+ */
+struct SimulatorStats {
+  /*!
+   * \brief Devices whose connection is established.
+   */
+  std::uint32_t connected = 0;
+  /*!
+   * \brief Devices that went through their whole conversation.
+   */
+  std::uint32_t completed = 0;
+  /*!
+   * \brief Devices whose connection failed or dropped before the end.
+   */
+  std::uint32_t failed = 0;
+  /*!
+   * \brief Messages sent and received by all the devices.
+   */
+  std::uint64_t sent = 0;
+  std::uint64_t received = 0;
+  /*!
+   * \brief Messages rejected by the manager (AE acknowledgments and
+   * escapes).
+   */
+  std::uint64_t rejected = 0;
+  /*!
+   * \brief Messages sent again for lack of response, and messages given up
+   * after their last retransmission.
+   */
+  std::uint64_t retransmitted = 0;
+  std::uint64_t timed_out = 0;
+  /*!
+   * \brief Messages from the manager breaking a POCT1-A rule
+   * (Options::validate); they are handled as usual.
+   */
+  std::uint64_t invalid = 0;
+};
+
+/*!
+ * \brief The DeviceSimulator class stands in for many POCT1-A devices at
+ * once: every virtual device has its own accm::Device identity, control_id
+ * sequence and TCP connection, and runs its own conversation with the
+ * manager.
+ *
+ * Every device runs a Conversation: it says hello (HEL.R01) with its
+ * identity, reports its status (DST.R01), sends its observations (OBS.R01,
+ * from the ObservationGenerator, up to 'window' of them in flight), ends the
+ * topic (EOT.R01) and terminates (END.R01).
+ *
+ * By default a device sends its next observation as soon as the window
+ * allows (closed loop). With a rate, the observations are sent on a fixed
+ * schedule whatever the response time (open loop): a late observation is sent
+ * as soon as the window allows, and its latency counts from its scheduled
+ * time, so a stalled manager shows in the latencies instead of slowing the
+ * load down (no coordinated omission).
+ *
+ * The latency from a message to its response (ACK.R01 or ESC.R01) is
+ * recorded per message type in a LatencyHistogram per event loop, merged on
+ * demand. With an acknowledgment timeout, every message waiting for its
+ * response has a timer in the TimingWheel of its loop: an unanswered message
+ * is sent again, up to retransmit_count times, then given up, which aborts
+ * the conversation (see Conversation::OnTimeout). Its latency counts from the
+ * first transmission.
+ *
+ * The connections are multiplexed on a small pool of event loops, so
+ * thousands of devices run in one process on a few threads. The
+ * conversations run apart, as tasks of a WorkStealingPool sized to the
+ * cores: the loop threads only hand the messages, disconnections and timer
+ * expiries over to their device, which handles them one task at a time, then
+ * gives its thread up. A device with a long burst of observations thus never
+ * holds back the devices sharing its loop, and idle threads take over the
+ * waiting devices. Every device keeps its codec buffers across messages.
+ */
+class DeviceSimulator {
+ public:
+  /*!
+   * \brief Latency histograms in nanoseconds, indexed by the type of the
+   * message answered.
+   */
+  using Latencies =
+      std::array<LatencyHistogram,
+                 static_cast<std::size_t>(accm::Header::MsgType::END_R01) + 1>;
+
+  /*!
+   * \brief Simulation settings.
+   */
+  struct Options {
+    /*!
+     * \brief The address of the manager.
+     */
+    std::string ip = "127.0.0.1";
+    std::uint16_t port = 8080;
+    /*!
+     * \brief The number of virtual devices.
+     */
+    std::uint32_t device_count = 100;
+    /*!
+     * \brief The number of event loop threads.
+     */
+    std::size_t worker_count = 4;
+    /*!
+     * \brief The number of threads running the conversations; 0 for one per
+     * core.
+     */
+    std::size_t task_thread_count = 0;
+    /*!
+     * \brief The I/O backend of the event loops; epoll if io_uring is not
+     * supported.
+     */
+    EventLoop::Backend io_backend = EventLoop::Backend::EPOLL;
+    /*!
+     * \brief The number of OBS.R01 messages each device sends.
+     */
+    std::uint32_t observation_count = 10;
+    /*!
+     * \brief The number of OBS.R01 messages in flight per device.
+     */
+    std::uint32_t window = 1;
+    /*!
+     * \brief The number of OBS.R01 messages per second sent by each device,
+     * on a fixed schedule; 0 sends them as the window allows.
+     */
+    double rate = 0;
+    /*!
+     * \brief The number of OBS.R01 messages per second sent by all the
+     * devices; overrides rate if not 0.
+     */
+    double total_rate = 0;
+    /*!
+     * \brief Whether every device sends the same observations (services 0
+     * and on), serialized once and shared by all the connections instead of
+     * being encoded and copied per device.
+     */
+    bool shared_observations = false;
+    /*!
+     * \brief The time in microseconds a device waits for the response to a
+     * message before sending it again; 0 waits forever.
+     */
+    std::uint32_t ack_timeout = 0;
+    /*!
+     * \brief The number of times an unanswered message is sent again before
+     * it is given up.
+     */
+    std::uint32_t retransmit_count = 2;
+    /*!
+     * \brief Whether every message received is checked against the POCT1-A
+     * rules (see MessageValidator).
+     */
+    bool validate = false;
+    /*!
+     * \brief The prefix of the device ids, followed by the device number.
+     */
+    std::string device_id_prefix = "SIM";
+  };
+
+  /*!
+   * \brief Constructor. Starts the event loops.
+   * \param options The simulation settings.
+   * \param generator The source of the observations. It must outlive the
+   * simulator. Device number d sends services d * observation_count and on,
+   * or 0 and on if the observations are shared.
+   */
+  DeviceSimulator(const Options& options,
+                  const ObservationGenerator& generator);
+  /*!
+   * \brief Destructor. Stops the simulation.
+   */
+  ~DeviceSimulator();
+  /*!
+   * \brief Copy constructor is deleted.
+   */
+  DeviceSimulator(const DeviceSimulator&) = delete;
+  /*!
+   * \brief Assignment operator is deleted.
+   */
+  DeviceSimulator& operator=(const DeviceSimulator&) = delete;
+
+  /*!
+   * \brief Connect every device and start the conversations.
+   * \return true if the devices are connecting; false if the address is
+   * invalid or the simulation already started.
+   */
+  bool Start();
+  /*!
+   * \brief Close every connection.
+   */
+  void Stop();
+  /*!
+   * \brief Check if every device completed or failed.
+   * \return true if the simulation is over; false otherwise.
+   */
+  bool IsFinished() const;
+  /*!
+   * \brief Get the counters of the run.
+   * \return The counters.
+   */
+  SimulatorStats GetStats() const;
+  /*!
+   * \brief Get the response latencies recorded so far.
+   * \param latencies Receives the histograms of every task thread, merged.
+   */
+  void GetLatencies(Latencies& latencies) const;
+  /*!
+   * \brief Write the count and the p50, p99, p99.9 and max response latency,
+   * in microseconds, of every message type answered.
+   * \param stream The output stream.
+   */
+  void WriteLatencyReport(std::ostream& stream) const;
+
+ private:
+  // Counters shared by the devices.
+  struct Counters {
+    std::atomic<std::uint32_t> completed{0};
+    std::atomic<std::uint32_t> failed{0};
+    std::atomic<std::uint64_t> sent{0};
+    std::atomic<std::uint64_t> received{0};
+    std::atomic<std::uint64_t> rejected{0};
+    std::atomic<std::uint64_t> retransmitted{0};
+    std::atomic<std::uint64_t> timed_out{0};
+    std::atomic<std::uint64_t> invalid{0};
+  };
+  using SharedBodies = std::vector<std::shared_ptr<const std::string>>;
+  class Worker;
+  class TaskPool;
+  class VirtualDevice;
+
+ private:
+  Options options_;
+  const ObservationGenerator& generator_;
+  Counters counters_;
+  EventLoopPool pool_;
+  // The encoded <SVC> of the shared observations.
+  SharedBodies shared_bodies_;
+  // One per loop; they outlive the devices.
+  std::vector<std::unique_ptr<Worker>> workers_;
+  // Stopped before the devices are destroyed.
+  std::unique_ptr<TaskPool> tasks_;
+  std::vector<std::unique_ptr<VirtualDevice>> devices_;
+};
@@ -0,0 +1,72 @@
+#include "LatencyHistogram.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+namespace {
+constexpr unsigned kSubBucketBits = 7;
+constexpr std::uint64_t kSubBuckets = 1 << kSubBucketBits;
+constexpr std::uint64_t kHalfSubBuckets = kSubBuckets / 2;
+// Values below kSubBuckets, then 64 buckets per power of two up to 2^64.
+constexpr std::size_t kBuckets =
+    kSubBuckets + (64 - kSubBucketBits) * kHalfSubBuckets;
+
+std::size_t IndexOf(std::uint64_t value) {
+  if (value < kSubBuckets) return static_cast<std::size_t>(value);
+  // value >> shift falls in [kHalfSubBuckets, kSubBuckets).
+  unsigned shift = 63 - __builtin_clzll(value) - (kSubBucketBits - 1);
+  return static_cast<std::size_t>(kSubBuckets +
+                                  (shift - 1) * kHalfSubBuckets +
+                                  ((value >> shift) - kHalfSubBuckets));
+}
+
+std::uint64_t HighestEquivalentValue(std::size_t index) {
+  if (index < kSubBuckets) return index;
+  unsigned shift =
+      static_cast<unsigned>((index - kSubBuckets) / kHalfSubBuckets + 1);
+  std::uint64_t sub_bucket =
+      (index - kSubBuckets) % kHalfSubBuckets + kHalfSubBuckets;
+  return ((sub_bucket + 1) << shift) - 1;
+}
+}  // namespace
+
+void LatencyHistogram::Record(std::uint64_t value) {
+  if (counts_.empty()) counts_.assign(kBuckets, 0);
+  ++counts_[IndexOf(value)];
+  ++count_;
+  sum_ += value;
+  min_ = std::min(min_, value);
+  max_ = std::max(max_, value);
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram& other) {
+  if (other.count_ == 0) return;
+  if (counts_.empty()) counts_.assign(kBuckets, 0);
+  for (std::size_t i = 0; i < kBuckets; ++i) counts_[i] += other.counts_[i];
+  count_ += other.count_;
+  sum_ += other.sum_;
+  min_ = std::min(min_, other.min_);
+  max_ = std::max(max_, other.max_);
+}
+
+void LatencyHistogram::Reset() {
+  std::fill(counts_.begin(), counts_.end(), 0);
+  count_ = 0;
+  sum_ = 0;
+  min_ = UINT64_MAX;
+  max_ = 0;
+}
+
+std::uint64_t LatencyHistogram::GetValueAtPercentile(double percentile) const {
+  if (count_ == 0) return 0;
+  percentile = std::min(std::max(percentile, 0.0), 100.0);
+  auto rank = static_cast<std::uint64_t>(
+      std::ceil(percentile / 100 * static_cast<double>(count_)));
+  rank = std::max<std::uint64_t>(rank, 1);
+  std::uint64_t seen = 0;
+  for (std::size_t i = 0; i < kBuckets; ++i) {
+    seen += counts_[i];
+    if (seen >= rank) return std::min(HighestEquivalentValue(i), max_);
+  }
+  return max_;
+}
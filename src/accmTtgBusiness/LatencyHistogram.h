@@ -0,0 +1,76 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+/*!
+ * \brief The LatencyHistogram class records latencies (or any non-negative
+ * integer values, e.g. nanoseconds) with a bounded relative error, in the
+ * manner of HdrHistogram.
+ *
+ * Values below 128 have their own bucket; above, every power of two is split
+ * in 64 buckets, so a value is reported with a relative error below 1/64
+ * whatever its magnitude, from nanoseconds to hours. Recording is a few bit
+ * operations and an increment. Histograms with the same layout can be merged,
+ * e.g. the per-thread histograms of a run. The buckets are allocated on the
+ * first record, so unused histograms cost nothing. A LatencyHistogram is not
+ * thread safe.
+ */
+class LatencyHistogram {
+ public:
+  /*!
+   * \brief Default constructor. The histogram is empty.
+   */
+  LatencyHistogram() = default;
+
+  /*!
+   * \brief Record a value.
+   * \param value The value.
+   */
+  void Record(std::uint64_t value);
+  /*!
+   * \brief Add the values of another histogram.
+   * \param other The histogram to add.
+   */
+  void Merge(const LatencyHistogram& other);
+  /*!
+   * \brief Remove every value.
+   */
+  void Reset();
+
+  /*!
+   * \brief Get the number of values.
+   * \return The number of values.
+   */
+  inline std::uint64_t GetCount() const { return count_; }
+  /*!
+   * \brief Get the smallest value.
+   * \return The smallest value; 0 if the histogram is empty.
+   */
+  inline std::uint64_t GetMin() const { return count_ ? min_ : 0; }
+  /*!
+   * \brief Get the largest value.
+   * \return The largest value; 0 if the histogram is empty.
+   */
+  inline std::uint64_t GetMax() const { return max_; }
+  /*!
+   * \brief Get the mean of the values.
+   * \return The mean; 0 if the histogram is empty.
+   */
+  inline double GetMean() const {
+    return count_ ? static_cast<double>(sum_) / count_ : 0;
+  }
+  /*!
+   * \brief Get the value at a percentile.
+   * \param percentile The percentile, from 0 to 100.
+   * \return The highest value equivalent to the value at the percentile,
+   * bounded by the largest value; 0 if the histogram is empty.
+   */
+  std::uint64_t GetValueAtPercentile(double percentile) const;
+
+ private:
+  std::vector<std::uint64_t> counts_;
+  std::uint64_t count_ = 0;
+  std::uint64_t sum_ = 0;
+  std::uint64_t min_ = UINT64_MAX;
+  std::uint64_t max_ = 0;
+};
@@ -0,0 +1,263 @@
+#include "ManagerSimulator.h"
+#include <unistd.h>
+#include <ctime>
+#include <string_view>
+#include <utility>
+#include "ControlIdSequence.h"
+#include "Message.h"
+#include "MessageDecoder.h"
+#include "MessageEncoder.h"
+#include "MessagePool.h"
+#include "MessageValidator.h"
+#include "Poct1Format.h"
+#include "SocketTransport.h"
+#include "SplitMix64.h"
+#include "TimerQueue.h"
+
+// The connections of a loop, their timers and their random source.
+class ManagerSimulator::Worker {
+ public:
+  Worker(EventLoop& loop, const Policy& policy, Counters& counters,
+         std::uint64_t seed)
+      : policy_(policy),
+        counters_(counters),
+        timers_(loop),
+        random_(seed),
+        error_detail_(std::to_string(static_cast<int>(policy.error_code))) {}
+
+  inline EventLoop& GetLoop() { return timers_.GetLoop(); }
+  inline const Policy& GetPolicy() const { return policy_; }
+  inline Counters& GetCounters() { return counters_; }
+  inline const accm::CV& GetErrorDetail() const { return error_detail_; }
+  // Loop thread only.
+  inline TimerQueue& GetTimers() { return timers_; }
+  inline SplitMix64& GetRandom() { return random_; }
+  inline MessageValidator& GetValidator() { return validator_; }
+
+  // Loop thread only: serve an accepted connection.
+  void Accept(int descriptor);
+  // Loop thread only: make a closed session available again.
+  inline void Release(Session* session) { idle_.push_back(session); }
+  void Stop();
+
+ private:
+  const Policy& policy_;
+  Counters& counters_;
+  TimerQueue timers_;
+  SplitMix64 random_;
+  MessageValidator validator_;
+  const accm::CV error_detail_;
+
+  // Loop thread only.
+  std::vector<std::unique_ptr<Session>> sessions_;
+  std::vector<Session*> idle_;
+  bool stopped_ = false;
+};
+
+class ManagerSimulator::Session {
+ public:
+  explicit Session(Worker& worker)
+      : worker_(worker),
+        transport_(SocketTransport::Create(worker.GetLoop())) {
+    transport_->SetReceiver([this](std::string_view xml) { OnMessage(xml); });
+    transport_->SetClosedHandler([this](const std::string&) { OnClosed(); });
+    accm::Terminate terminate;
+    terminate.reason = accm::CV("NRM");
+    terminate_.SetTerminate(std::move(terminate));
+  }
+
+  void Attach(int descriptor) {
+    ++generation_;
+    terminating_.clear();
+    terminated_ = false;
+    if (!transport_->Attach(descriptor)) worker_.Release(this);
+  }
+  inline void Close() {
+    ++generation_;
+    transport_->Disconnect();
+  }
+
+ private:
+  void OnMessage(std::string_view xml) {
+    Counters& counters = worker_.GetCounters();
+    counters.received.fetch_add(1, std::memory_order_relaxed);
+    PoolPtr<Message> message = decoder_.Decode(xml, pool_);
+    if (!message) {
+      counters.undecodable.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    const Policy& policy = worker_.GetPolicy();
+    if (policy.validate && !worker_.GetValidator().Validate(*message)) {
+      counters.invalid.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    accm::Header::MsgType type = message->GetMessageType();
+    switch (type) {
+      case accm::Header::MsgType::ACK_R01:
+        if (!terminating_.empty() &&
+            static_cast<const MessageAck&>(*message).GetAck()->ack_control_id ==
+                terminating_) {
+          terminating_.clear();
+          CountTermination();
+        }
+        return;
+      case accm::Header::MsgType::ESC_R01:
+        return;
+      case accm::Header::MsgType::END_R01:
+        CountTermination();
+        break;
+      default:
+        break;
+    }
+
+    SplitMix64& random = worker_.GetRandom();
+    if (type == accm::Header::MsgType::OBS_R01 && policy.loss_rate > 0 &&
+        random.Uniform() < policy.loss_rate) {
+      counters.lost.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    bool reject = type == accm::Header::MsgType::OBS_R01 &&
+                  policy.error_rate > 0 && random.Uniform() < policy.error_rate;
+    std::int64_t delay = policy.ack_delay;
+    if (policy.ack_jitter > 0) delay += random.Next() % (policy.ack_jitter + 1);
+    if (delay == 0) {
+      Respond(message->GetHeader()->control_id, type, reject);
+      return;
+    }
+    worker_.GetTimers().Schedule(
+        TimerQueue::Now() + delay * 1000,
+        [this, generation = generation_,
+         control_id = message->GetHeader()->control_id, type, reject]() {
+          // The connection may have closed meanwhile.
+          if (generation == generation_) Respond(control_id, type, reject);
+        });
+  }
+
+  void Respond(const std::string& control_id, accm::Header::MsgType type,
+               bool reject) {
+    accm::Ack ack;
+    ack.ack_control_id = control_id;
+    ack.type = accm::CV(reject ? "AE" : "AA");
+    if (reject) ack.error_detail = worker_.GetErrorDetail();
+    ack_.SetAck(std::move(ack));
+    if (!Send(ack_)) return;
+    if (reject) {
+      worker_.GetCounters().rejected.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (type == accm::Header::MsgType::EOT_R01 &&
+        worker_.GetPolicy().terminate_after_topic && Send(terminate_)) {
+      terminating_ = terminate_.GetHeader()->control_id;
+    }
+  }
+
+  bool Send(Message& message) {
+    header_.message_type =
+        accm::CV(poct1::GetRootName(message.GetMessageType()));
+    header_.creation_dttm = std::time(nullptr);
+    message.SetHeader(header_, sequence_);
+    buffer_.clear();
+    if (!encoder_.Encode(message, buffer_) || !transport_->Send(buffer_)) {
+      return false;
+    }
+    worker_.GetCounters().sent.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  // Both sides may send END.R01 at once.
+  void CountTermination() {
+    if (terminated_) return;
+    terminated_ = true;
+    worker_.GetCounters().terminated.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void OnClosed() {
+    ++generation_;
+    worker_.Release(this);
+  }
+
+ private:
+  Worker& worker_;
+
+  // Loop thread only.
+  MessageDecoder decoder_;
+  MessageEncoder encoder_;
+  MessagePool pool_{4};
+  std::string buffer_;
+  ControlIdSequence sequence_;
+  accm::Header header_;
+  MessageAck ack_;
+  MessageTerminate terminate_;
+  // The control_id of the END.R01 sent, until it is acknowledged.
+  std::string terminating_;
+  bool terminated_ = false;
+  // Changes when the connection closes, invalidating the delayed responses.
+  std::uint64_t generation_ = 0;
+
+  std::unique_ptr<SocketTransport> transport_;
+};
+
+void ManagerSimulator::Worker::Accept(int descriptor) {
+  if (stopped_) {
+    close(descriptor);
+    return;
+  }
+  Session* session;
+  if (idle_.empty()) {
+    sessions_.push_back(std::make_unique<Session>(*this));
+    session = sessions_.back().get();
+  } else {
+    session = idle_.back();
+    idle_.pop_back();
+  }
+  counters_.connections.fetch_add(1, std::memory_order_relaxed);
+  session->Attach(descriptor);
+}
+
+void ManagerSimulator::Worker::Stop() {
+  timers_.Stop();
+  GetLoop().Invoke([this]() {
+    stopped_ = true;
+    for (auto& session : sessions_) session->Close();
+  });
+}
+
+ManagerSimulator::ManagerSimulator(const Options& options)
+    : options_(options),
+      pool_(options.worker_count, options.io_backend),
+      listener_(pool_.Get(0)) {
+  workers_.reserve(pool_.Size());
+  for (std::size_t i = 0; i < pool_.Size(); ++i) {
+    workers_.push_back(std::make_unique<Worker>(
+        pool_.Get(i), options_.policy, counters_,
+        SplitMix64(options_.policy.seed ^ i).Next()));
+  }
+}
+
+ManagerSimulator::~ManagerSimulator() { Stop(); }
+
+bool ManagerSimulator::Start() {
+  return listener_.Listen(options_.ip, options_.port, [this](int descriptor) {
+    Worker& worker = *workers_[next_worker_++ % workers_.size()];
+    worker.GetLoop().Post(
+        [&worker, descriptor]() { worker.Accept(descriptor); });
+  });
+}
+
+void ManagerSimulator::Stop() {
+  listener_.Close();
+  for (auto& worker : workers_) worker->Stop();
+}
+
+ManagerStats ManagerSimulator::GetStats() const {
+  ManagerStats stats;
+  stats.connections = counters_.connections.load(std::memory_order_relaxed);
+  stats.terminated = counters_.terminated.load(std::memory_order_relaxed);
+  stats.received = counters_.received.load(std::memory_order_relaxed);
+  stats.sent = counters_.sent.load(std::memory_order_relaxed);
+  stats.rejected = counters_.rejected.load(std::memory_order_relaxed);
+  stats.undecodable = counters_.undecodable.load(std::memory_order_relaxed);
+  stats.lost = counters_.lost.load(std::memory_order_relaxed);
+  stats.invalid = counters_.invalid.load(std::memory_order_relaxed);
+  stats.refused = listener_.GetRefusedCount();
+  return stats;
+}
@@ -0,0 +1,201 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "AccmDefinitions.h"
+#include "EpollListener.h"
+#include "EventLoop.h"
+
+/*!
+ * \brief Counters of a ManagerSimulator run.
+ */
+struct ManagerStats {
+  /*!
+   * \brief Connections accepted.
+   */
+  std::uint32_t connections = 0;
+  /*!
+   * \brief Conversations ended by an END.R01, from either side.
+   */
+  std::uint32_t terminated = 0;
+  /*!
+   * \brief Messages received and sent on all the connections.
+   */
+  std::uint64_t received = 0;
+  std::uint64_t sent = 0;
+  /*!
+   * \brief Messages answered with an AE acknowledgment.
+   */
+  std::uint64_t rejected = 0;
+  /*!
+   * \brief Messages that could not be decoded; they are not answered.
+   */
+  std::uint64_t undecodable = 0;
+  /*!
+   * \brief Observations left unanswered on purpose (Policy::loss_rate).
+   */
+  std::uint64_t lost = 0;
+  /*!
+   * \brief Messages breaking a POCT1-A rule (Policy::validate); they are
+   * answered as usual.
+   */
+  std::uint64_t invalid = 0;
+  /*!
+   * \brief Connections closed as soon as accepted, for lack of descriptors.
+   */
+  std::uint64_t refused = 0;
+};
+
+/*!
+ * \brief The ManagerSimulator class stands in for the ACCM (the POCT1-A data
+ * manager), so that the device side can be benchmarked on one machine with
+ * no external service.
+ *
+ * It accepts connections, decodes every message and acknowledges it
+ * (ACK.R01) with its own control_id sequence per connection. The policy
+ * decides how: every message accepted (AA), or a fraction of the
+ * observations rejected (AE, with an Ack::AckCode), optionally after a delay;
+ * a fraction of the observations may also be left unanswered.
+ * An EOT.R01 may be followed by an END.R01 from the manager. Acknowledgments
+ * and escapes from the device are not answered.
+ *
+ * The connections are spread over a small pool of event loops, like the
+ * devices of a DeviceSimulator; a connection is only touched by the thread of
+ * its loop, and its state is reused by the next connection once it closes.
+ */
+class ManagerSimulator {
+ public:
+  /*!
+   * \brief How the messages are answered.
+   */
+  struct Policy {
+    /*!
+     * \brief The fraction of OBS.R01 messages answered with an AE
+     * acknowledgment, from 0 (every message accepted) to 1.
+     */
+    double error_rate = 0;
+    /*!
+     * \brief The error_detail of the AE acknowledgments.
+     */
+    accm::Ack::AckCode error_code = accm::Ack::AckCode::APP_INTERNAL_ERROR;
+    /*!
+     * \brief The fraction of OBS.R01 messages never answered, as if they were
+     * lost, so that the devices time out and send them again.
+     */
+    double loss_rate = 0;
+    /*!
+     * \brief The delay of the acknowledgments in microseconds, plus a
+     * uniformly random part up to ack_jitter.
+     */
+    std::uint32_t ack_delay = 0;
+    std::uint32_t ack_jitter = 0;
+    /*!
+     * \brief Whether the manager ends the conversation with an END.R01 once
+     * the device ends its topic (EOT.R01).
+     */
+    bool terminate_after_topic = false;
+    /*!
+     * \brief Whether every message received is checked against the POCT1-A
+     * rules (see MessageValidator).
+     */
+    bool validate = false;
+    /*!
+     * \brief The seed of the random errors and delays.
+     */
+    std::uint64_t seed = 1;
+  };
+
+  /*!
+   * \brief Server settings.
+   */
+  struct Options {
+    /*!
+     * \brief The address to listen to; port 0 picks a free one.
+     */
+    std::string ip = "127.0.0.1";
+    std::uint16_t port = 8080;
+    /*!
+     * \brief The number of event loop threads.
+     */
+    std::size_t worker_count = 2;
+    /*!
+     * \brief The I/O backend of the event loops; epoll if io_uring is not
+     * supported.
+     */
+    EventLoop::Backend io_backend = EventLoop::Backend::EPOLL;
+    Policy policy;
+  };
+
+  /*!
+   * \brief Constructor. Starts the event loops.
+   * \param options The server settings.
+   */
+  explicit ManagerSimulator(const Options& options);
+  /*!
+   * \brief Destructor. Stops the server.
+   */
+  ~ManagerSimulator();
+  /*!
+   * \brief Copy constructor is deleted.
+   */
+  ManagerSimulator(const ManagerSimulator&) = delete;
+  /*!
+   * \brief Assignment operator is deleted.
+   */
+  ManagerSimulator& operator=(const ManagerSimulator&) = delete;
+
+  /*!
+   * \brief Start accepting connections.
+   * \return true if the server listens; false otherwise.
+   * \see GetLastError
+   */
+  bool Start();
+  /*!
+   * \brief Stop accepting connections and close every connection.
+   */
+  void Stop();
+  /*!
+   * \brief Get the port listened to.
+   * \return The port; 0 if not listening.
+   */
+  inline std::uint16_t GetPort() const { return listener_.GetPort(); }
+  /*!
+   * \brief Get the reason why the last call to Start failed.
+   * \return The error description.
+   */
+  inline const std::string& GetLastError() const {
+    return listener_.GetLastError();
+  }
+  /*!
+   * \brief Get the counters of the run.
+   * \return The counters.
+   */
+  ManagerStats GetStats() const;
+
+ private:
+  // Counters shared by the connections.
+  struct Counters {
+    std::atomic<std::uint32_t> connections{0};
+    std::atomic<std::uint32_t> terminated{0};
+    std::atomic<std::uint64_t> received{0};
+    std::atomic<std::uint64_t> sent{0};
+    std::atomic<std::uint64_t> rejected{0};
+    std::atomic<std::uint64_t> undecodable{0};
+    std::atomic<std::uint64_t> lost{0};
+    std::atomic<std::uint64_t> invalid{0};
+  };
+  class Worker;
+  class Session;
+
+ private:
+  Options options_;
+  Counters counters_;
+  EventLoopPool pool_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+  // Listener loop thread only.
+  std::size_t next_worker_ = 0;
+  EpollListener listener_;
+};
@@ -1,5 +1,11 @@
 #pragma once
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 #include "AccmDefinitions.h"
+#include "AccmReflection.h"
+#include "ControlIdSequence.h"
 
 /*!
  * \brief The Message class is the abstraction of all the messages defined by
@@ -35,13 +41,15 @@ class Message {
    */
   inline const accm::Header* GetHeader() const { return &header_; }
   /*!
-   * \brief Set the header.
+   * \brief Set the header, with the next control_id of a conversation.
    * \param head The header from which to get the values.
+   * \param sequence The control_id sequence of the conversation.
    * \see GetHeader
    */
-  inline void SetHeader(const accm::Header& head) {
+  inline void SetHeader(const accm::Header& head,
+                        ControlIdSequence& sequence) {
     header_ = head;
-    header_.control_id = std::to_string(++kMessageNum);
+    sequence.Next(header_.control_id);
   }
   /*!
    * \brief Set the header.
@@ -54,16 +62,27 @@ class Message {
     header_ = head;
     header_.control_id = control_id;
   }
+  /*!
+   * \brief Set the header, taking ownership of the given one.
+   * \param head The header to move from.
+   * \param control_id The control_id of the header.
+   * \see SetHeader(const accm::Header&, const std::string&)
+   */
+  inline void SetHeader(accm::Header&& head, std::string control_id) {
+    header_ = std::move(head);
+    header_.control_id = std::move(control_id);
+  }
   /*!
    * \brief Get the message type. Aimed to identify which kind of message it is.
    * \return The message type.
    */
   virtual accm::Header::MsgType GetMessageType() const = 0;
-
   /*!
-   * \brief Point the message position in a conversation.
+   * \brief Bring the message back to its default-constructed state, so that
+   * it can be filled again (see MessagePool). Strings and vectors are cleared
+   * in place, keeping their capacity.
    */
-  static unsigned int kMessageNum;
+  virtual void Reset() { accm::reflection::Clear(header_); }
 
  protected:
   accm::Header header_;
@@ -110,6 +129,20 @@ class MessageAck : public Message {
    * \see GetAck
    */
   inline void SetAck(const accm::Ack& ack) { ack_ = ack; }
+  /*!
+   * \brief Set the body of the ACK.R01, taking ownership of the given one.
+   * \param ack The body to move from.
+   * \see GetAck
+   */
+  inline void SetAck(accm::Ack&& ack) { ack_ = std::move(ack); }
+
+  /*!
+   * \brief Reset the header and the body.
+   */
+  inline void Reset() override {
+    Message::Reset();
+    accm::reflection::Clear(ack_);
+  }
 
  private:
   accm::Ack ack_;
@@ -160,6 +193,23 @@ class MessageDeviceStatus : public Message {
   inline void SetDeviceStatus(const accm::DeviceStatus& device) {
     device_status_ = device;
   }
+  /*!
+   * \brief Set the body of the DST.R01 message, taking ownership of the given
+   * one.
+   * \param device The body to move from.
+   * \see GetDeviceStatus
+   */
+  inline void SetDeviceStatus(accm::DeviceStatus&& device) {
+    device_status_ = std::move(device);
+  }
+
+  /*!
+   * \brief Reset the header and the body.
+   */
+  inline void Reset() override {
+    Message::Reset();
+    accm::reflection::Clear(device_status_);
+  }
 
  private:
   accm::DeviceStatus device_status_;
@@ -206,6 +256,21 @@ class MessageEscape : public Message {
    * \see GetEscape
    */
   inline void SetEscape(const accm::Escape& escape) { escape_ = escape; }
+  /*!
+   * \brief Set the body of the ESC.R01 message, taking ownership of the given
+   * one.
+   * \param escape The body to move from.
+   * \see GetEscape
+   */
+  inline void SetEscape(accm::Escape&& escape) { escape_ = std::move(escape); }
+
+  /*!
+   * \brief Reset the header and the body.
+   */
+  inline void Reset() override {
+    Message::Reset();
+    accm::reflection::Clear(escape_);
+  }
 
  private:
   accm::Escape escape_;
@@ -256,6 +321,23 @@ class MessageEndOfTopic : public Message {
   inline void SetEndOfTopic(const accm::EndOfTopic& end_of_topic) {
     end_of_topic_ = end_of_topic;
   }
+  /*!
+   * \brief Set the body of the EOT.R01 message, taking ownership of the given
+   * one.
+   * \param end_of_topic The body to move from.
+   * \see GetEndOfTopic
+   */
+  inline void SetEndOfTopic(accm::EndOfTopic&& end_of_topic) {
+    end_of_topic_ = std::move(end_of_topic);
+  }
+
+  /*!
+   * \brief Reset the header and the body.
+   */
+  inline void Reset() override {
+    Message::Reset();
+    accm::reflection::Clear(end_of_topic_);
+  }
 
  private:
   accm::EndOfTopic end_of_topic_;
@@ -334,6 +416,13 @@ class MessageHello : public Message {
    * \see accm::Device
    */
   inline void SetDevice(const accm::Device& device) { device_ = device; }
+  /*!
+   * \brief Set the Device (<DEV>) information, taking ownership of the given
+   * one.
+   * \param device The body to move from.
+   * \see GetDevice
+   */
+  inline void SetDevice(accm::Device&& device) { device_ = std::move(device); }
   /*!
    * \brief Set the Device Static capabilities (<DSC>) information.
    * \param capabilities The Device Static capabilities from which to get the
@@ -346,6 +435,14 @@ class MessageHello : public Message {
   //    device_.static_capabilities = capabilities;
   //  }
 
+  /*!
+   * \brief Reset the header and the body.
+   */
+  inline void Reset() override {
+    Message::Reset();
+    accm::reflection::Clear(device_);
+  }
+
  private:
   accm::Device device_;
 };
@@ -364,6 +461,17 @@ class MessageObservations : public Message {
   explicit MessageObservations(bool isPatientInfo)
       : msg_type((isPatientInfo ? accm::Header::MsgType::OBS_R01
                                 : accm::Header::MsgType::OBS_R02)) {}
+  /*!
+   * \brief Constructor keeping the service in the memory of an allocator.
+   * \param isPatientInfo Whether it is patient (OBS.R01) or non-patient
+   * (OBS.R02).
+   * \param alloc The allocator of the service (see MessageArena). Services
+   * set with the same allocator are moved in without copying.
+   */
+  MessageObservations(bool isPatientInfo, const accm::Allocator& alloc)
+      : service_(alloc),
+        msg_type((isPatientInfo ? accm::Header::MsgType::OBS_R01
+                                : accm::Header::MsgType::OBS_R02)) {}
   /*!
    * \brief Default destructor.
    */
@@ -385,20 +493,255 @@ class MessageObservations : public Message {
     return msg_type;
   }
   /*!
-   * \brief Get the body of the OBS.* message.
-   * \return A reference to the service of the OBS.* message.
+   * \brief Function decoding a raw <SVC> element into a service.
+   */
+  using ServiceParser = bool (*)(std::string_view raw, accm::Service& service);
+
+  /*!
+   * \brief Get the body of the OBS.* message. A lazily decoded body (see
+   * SetLazyService) is decoded by the first call, which must not race with
+   * other calls on the same message.
+   * \return A reference to the service of the OBS.* message; nullptr if the
+   * lazily decoded body turned out to be malformed.
    * \see SetService
    */
-  inline const accm::Service* GetService() const { return &service_; }
+  inline const accm::Service* GetService() const {
+    if (!raw_service_.empty() && !DecodeLazyService()) return nullptr;
+    return &service_;
+  }
+  /*!
+   * \brief Get the body of the OBS.* message without decoding a lazy body.
+   * In that case only the top-level fields of the service (observation uid,
+   * role, timestamp, status, reason and sequence) are set.
+   * \return A reference to the service of the OBS.* message.
+   */
+  inline const accm::Service* GetServiceSummary() const { return &service_; }
+  /*!
+   * \brief Check if the body is still held as raw XML.
+   * \return true if the body has not been decoded yet; false otherwise.
+   * \see GetRawService
+   */
+  inline bool IsServicePending() const { return !raw_service_.empty(); }
+  /*!
+   * \brief Get the raw <SVC> element of a lazily decoded body.
+   * \return The raw element; empty if the body has been decoded.
+   */
+  inline std::string_view GetRawService() const { return raw_service_; }
   /*!
    * \brief Set the body of the OBS.* message.
    * \param service The OBS.* body from which to get the values.
    * \see GetService
    */
-  inline void SetService(const accm::Service& service) { service_ = service; }
+  inline void SetService(const accm::Service& service) {
+    raw_service_.clear();
+    service_ = service;
+  }
+  /*!
+   * \brief Set the body of the OBS.* message, taking ownership of the given
+   * one.
+   * \param service The body to move from.
+   * \see GetService
+   */
+  inline void SetService(accm::Service&& service) {
+    raw_service_.clear();
+    service_ = std::move(service);
+  }
+  /*!
+   * \brief Set a body to be decoded on the first call to GetService.
+   * \param raw The raw <SVC> element. It is copied.
+   * \param summary The top-level fields of the service.
+   * \param parser The function decoding the raw element.
+   * \see GetServiceSummary
+   */
+  inline void SetLazyService(std::string_view raw, accm::Service&& summary,
+                             ServiceParser parser) {
+    service_ = std::move(summary);
+    raw_service_.assign(raw.data(), raw.size());
+    parser_ = parser;
+  }
+
+  /*!
+   * \brief Reset the header and the body.
+   */
+  inline void Reset() override {
+    Message::Reset();
+    accm::reflection::Clear(service_);
+    raw_service_.clear();
+  }
 
  private:
-  accm::Service service_;
+  bool DecodeLazyService() const {
+    accm::Service service(service_.observations.get_allocator());
+    if (!parser_(raw_service_, service)) return false;
+    service_ = std::move(service);
+    raw_service_.clear();
+    return true;
+  }
+
+ private:
+  mutable accm::Service service_;
+  mutable std::string raw_service_;
+  ServiceParser parser_ = nullptr;
+  accm::Header::MsgType msg_type;
+};
+///////////////////////////////////
+/*!
+ * \brief The MessageOperatorList class implements both OPL.R01 and OPL.R02
+ * messages defined by the POCT1-A standard.
+ */
+class MessageOperatorList : public Message {
+ public:
+  /*!
+   * \brief Default constructor.
+   * \param isComplete Whether it is the complete (R01) or the incremental
+   * (R02) operator list.
+   */
+  explicit MessageOperatorList(bool isComplete)
+      : msg_type((isComplete ? accm::Header::MsgType::OPL_R01
+                             : accm::Header::MsgType::OPL_R02)) {}
+  /*!
+   * \brief Default destructor.
+   */
+  ~MessageOperatorList() override = default;
+  /*!
+   * \brief Copy constructor is deleted.
+   */
+  MessageOperatorList(const MessageOperatorList&) = delete;
+  /*!
+   * \brief Assignment operator is deleted.
+   */
+  MessageOperatorList& operator=(const MessageOperatorList&) = delete;
+  /*!
+   * \brief Get the message type.
+   * \return accm::Header::MsgType::OPL_R01 or
+   * accm::Header::MsgType::OPL_R02.
+   */
+  inline accm::Header::MsgType GetMessageType() const override {
+    return msg_type;
+  }
+  /*!
+   * \brief Get the body of the OPL.* message.
+   * \return A reference to the operators of the OPL.* message.
+   * \see SetOperators
+   */
+  inline const std::vector<accm::Operator>* GetOperators() const {
+    return &operators_;
+  }
+  /*!
+   * \brief Set the body of the OPL.* message.
+   * \param operators The operators from which to get the values.
+   * \see GetOperators
+   */
+  inline void SetOperators(const std::vector<accm::Operator>& operators) {
+    operators_ = operators;
+  }
+  /*!
+   * \brief Set the body of the OPL.* message, taking ownership of the
+   * given one.
+   * \param operators The operators to move from.
+   * \see GetOperators
+   */
+  inline void SetOperators(std::vector<accm::Operator>&& operators) {
+    operators_ = std::move(operators);
+  }
+  /*!
+   * \brief Append an entry to the body of the OPL.* message.
+   * \param op The entry to move from.
+   */
+  inline void AddOperator(accm::Operator&& op) {
+    operators_.push_back(std::move(op));
+  }
+
+  /*!
+   * \brief Reset the header and the body. The capacity of the list is kept.
+   */
+  inline void Reset() override {
+    Message::Reset();
+    operators_.clear();
+  }
+
+ private:
+  std::vector<accm::Operator> operators_;
+  accm::Header::MsgType msg_type;
+};
+///////////////////////////////////
+/*!
+ * \brief The MessagePatientList class implements both PTL.R01 and PTL.R02
+ * messages defined by the POCT1-A standard.
+ */
+class MessagePatientList : public Message {
+ public:
+  /*!
+   * \brief Default constructor.
+   * \param isComplete Whether it is the complete (R01) or the incremental
+   * (R02) patient list.
+   */
+  explicit MessagePatientList(bool isComplete)
+      : msg_type((isComplete ? accm::Header::MsgType::PTL_R01
+                             : accm::Header::MsgType::PTL_R02)) {}
+  /*!
+   * \brief Default destructor.
+   */
+  ~MessagePatientList() override = default;
+  /*!
+   * \brief Copy constructor is deleted.
+   */
+  MessagePatientList(const MessagePatientList&) = delete;
+  /*!
+   * \brief Assignment operator is deleted.
+   */
+  MessagePatientList& operator=(const MessagePatientList&) = delete;
+  /*!
+   * \brief Get the message type.
+   * \return accm::Header::MsgType::PTL_R01 or
+   * accm::Header::MsgType::PTL_R02.
+   */
+  inline accm::Header::MsgType GetMessageType() const override {
+    return msg_type;
+  }
+  /*!
+   * \brief Get the body of the PTL.* message.
+   * \return A reference to the patients of the PTL.* message.
+   * \see SetPatients
+   */
+  inline const std::vector<accm::Patient>* GetPatients() const {
+    return &patients_;
+  }
+  /*!
+   * \brief Set the body of the PTL.* message.
+   * \param patients The patients from which to get the values.
+   * \see GetPatients
+   */
+  inline void SetPatients(const std::vector<accm::Patient>& patients) {
+    patients_ = patients;
+  }
+  /*!
+   * \brief Set the body of the PTL.* message, taking ownership of the
+   * given one.
+   * \param patients The patients to move from.
+   * \see GetPatients
+   */
+  inline void SetPatients(std::vector<accm::Patient>&& patients) {
+    patients_ = std::move(patients);
+  }
+  /*!
+   * \brief Append an entry to the body of the PTL.* message.
+   * \param patient The entry to move from.
+   */
+  inline void AddPatient(accm::Patient&& patient) {
+    patients_.push_back(std::move(patient));
+  }
+
+  /*!
+   * \brief Reset the header and the body. The capacity of the list is kept.
+   */
+  inline void Reset() override {
+    Message::Reset();
+    patients_.clear();
+  }
+
+ private:
+  std::vector<accm::Patient> patients_;
   accm::Header::MsgType msg_type;
 };
 ///////////////////////////////////
@@ -443,6 +786,22 @@ class MessageRequest : public Message {
    * \see GetRequest
    */
   inline void SetRequest(const accm::Request& request) { request_ = request; }
+  /*!
+   * \brief Set the body of the REQ.R01, taking ownership of the given one.
+   * \param request The body to move from.
+   * \see GetRequest
+   */
+  inline void SetRequest(accm::Request&& request) {
+    request_ = std::move(request);
+  }
+
+  /*!
+   * \brief Reset the header and the body.
+   */
+  inline void Reset() override {
+    Message::Reset();
+    accm::reflection::Clear(request_);
+  }
 
  private:
   accm::Request request_;
@@ -491,7 +850,53 @@ class MessageTerminate : public Message {
   inline void SetTerminate(const accm::Terminate& terminate) {
     terminate_ = terminate;
   }
+  /*!
+   * \brief Set the body of the END.R01, taking ownership of the given one.
+   * \param terminate The body to move from.
+   * \see GetTerminate
+   */
+  inline void SetTerminate(accm::Terminate&& terminate) {
+    terminate_ = std::move(terminate);
+  }
+
+  /*!
+   * \brief Reset the header and the body.
+   */
+  inline void Reset() override {
+    Message::Reset();
+    accm::reflection::Clear(terminate_);
+  }
 
  private:
   accm::Terminate terminate_;
 };
+///////////////////////////////////
+/*!
+ * \brief Mapping between the entry of a list topic and the Message subclass
+ * holding the list: Class, and the Get/Add accessors of the list. Only
+ * specializations are defined.
+ */
+template <typename Entry>
+struct MessageListTraits;
+
+template <>
+struct MessageListTraits<accm::Operator> {
+  using Class = MessageOperatorList;
+  static const std::vector<accm::Operator>* Get(const Class& message) {
+    return message.GetOperators();
+  }
+  static void Add(Class& message, accm::Operator&& entry) {
+    message.AddOperator(std::move(entry));
+  }
+};
+
+template <>
+struct MessageListTraits<accm::Patient> {
+  using Class = MessagePatientList;
+  static const std::vector<accm::Patient>* Get(const Class& message) {
+    return message.GetPatients();
+  }
+  static void Add(Class& message, accm::Patient&& entry) {
+    message.AddPatient(std::move(entry));
+  }
+};
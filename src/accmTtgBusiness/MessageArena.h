@@ -0,0 +1,97 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <utility>
+#include "AccmDefinitions.h"
+
+/*!
+ * \brief Deleter of the objects created by a MessageArena: it only runs the
+ * destructor, the memory is given back when the arena is released.
+ */
+struct ArenaDeleter {
+  template <typename T>
+  void operator()(T* object) const {
+    object->~T();
+  }
+};
+
+/*!
+ * \brief Owning pointer to an object created by a MessageArena.
+ */
+template <typename T>
+using ArenaPtr = std::unique_ptr<T, ArenaDeleter>;
+
+/*!
+ * \brief The MessageArena class is a monotonic memory arena meant to hold one
+ * or several messages together with their whole accm:: object tree.
+ *
+ * Allocations are carved from large blocks and never freed one by one; the
+ * memory is reclaimed in one shot by Release (e.g. when the messages have been
+ * acknowledged or archived) or when the arena is destroyed. The allocator-aware
+ * structs (CE, Observation and Service) built with GetAllocator keep their
+ * repeated fields, and the items in them, in the arena as well.
+ *
+ * An arena is not thread safe: use one per thread or per conversation.
+ */
+class MessageArena {
+ public:
+  /*!
+   * \brief Default size of the first block.
+   */
+  static constexpr std::size_t kDefaultBlockSize = 16 * 1024;
+
+  /*!
+   * \brief Constructor.
+   * \param block_size The size of the first block. Following blocks grow
+   * geometrically.
+   */
+  explicit MessageArena(std::size_t block_size = kDefaultBlockSize)
+      : resource_(block_size) {}
+  /*!
+   * \brief Default destructor. All the objects created by the arena must
+   * have been destroyed.
+   */
+  ~MessageArena() = default;
+  /*!
+   * \brief Copy constructor is deleted.
+   */
+  MessageArena(const MessageArena&) = delete;
+  /*!
+   * \brief Assignment operator is deleted.
+   */
+  MessageArena& operator=(const MessageArena&) = delete;
+
+  /*!
+   * \brief Get the memory resource of the arena.
+   * \return The memory resource.
+   */
+  inline std::pmr::memory_resource* GetResource() { return &resource_; }
+  /*!
+   * \brief Get an allocator for the allocator-aware accm:: structs.
+   * \return The allocator.
+   */
+  inline accm::Allocator GetAllocator() { return accm::Allocator(&resource_); }
+
+  /*!
+   * \brief Construct an object in the arena.
+   * \param args The constructor arguments.
+   * \return The object. Resetting the pointer runs the destructor but the
+   * memory is only reclaimed by Release.
+   */
+  template <typename T, typename... Args>
+  ArenaPtr<T> New(Args&&... args) {
+    void* memory = resource_.allocate(sizeof(T), alignof(T));
+    return ArenaPtr<T>(new (memory) T(std::forward<Args>(args)...));
+  }
+
+  /*!
+   * \brief Give back all the memory of the arena at once. All the objects
+   * created by the arena must have been destroyed.
+   */
+  inline void Release() { resource_.release(); }
+
+ private:
+  std::pmr::monotonic_buffer_resource resource_;
+};
@@ -0,0 +1,737 @@
+#include "MessageDecoder.h"
+#include <charconv>
+#include <ctime>
+#include "AccmReflection.h"
+#include "Poct1Format.h"
+#include "XmlReader.h"
+
+namespace {
+using Token = XmlReader::Token;
+using namespace accm::reflection;
+
+/*!
+ * \brief State shared by the decoding functions of a single message.
+ */
+struct Context {
+  Context(std::string_view input, const accm::Allocator& alloc)
+      : xml(input), reader(input), allocator(alloc) {}
+
+  std::string_view xml;
+  XmlReader reader;
+  accm::Allocator allocator;
+  std::string scratch;
+  std::string_view error;
+  std::string_view element;
+};
+
+bool Fail(Context& ctx, std::string_view error) {
+  if (ctx.error.empty()) {
+    ctx.error = error;
+    ctx.element = ctx.reader.GetName();
+  }
+  return false;
+}
+
+bool Skip(Context& ctx) {
+  return ctx.reader.SkipElement() || Fail(ctx, "Malformed element");
+}
+
+/*!
+ * \brief Call the handler with the name of every child of the current element.
+ * The handler must consume the whole child element. Returns once the closing
+ * tag of the current element has been read.
+ */
+template <typename Handler>
+bool ForEachChild(Context& ctx, Handler handler) {
+  while (true) {
+    switch (ctx.reader.Next()) {
+      case Token::START_ELEMENT:
+        if (!handler(ctx.reader.GetName())) return false;
+        break;
+      case Token::END_ELEMENT:
+        return true;
+      case Token::END_DOCUMENT:
+        return Fail(ctx, "Unexpected end of document");
+      case Token::ERROR:
+        return Fail(ctx, ctx.reader.GetError());
+    }
+  }
+}
+
+///////////////////////////////////
+// Attribute parsing
+///////////////////////////////////
+bool ParseText(Context& ctx, std::string_view raw, std::string& value) {
+  value.clear();
+  return XmlReader::AppendUnescaped(raw, value) ||
+         Fail(ctx, "Malformed entity reference");
+}
+
+bool ParseText(Context& ctx, std::string_view raw,
+               std::optional<std::string>& value) {
+  return ParseText(ctx, raw, value.emplace());
+}
+
+bool ParseInt(Context& ctx, std::string_view raw, int& value) {
+  auto result = std::from_chars(raw.data(), raw.data() + raw.size(), value);
+  return (result.ec == std::errc() && result.ptr == raw.data() + raw.size()) ||
+         Fail(ctx, "Invalid integer value");
+}
+
+bool ParseDigits(std::string_view& raw, std::size_t count, int& value) {
+  if (raw.size() < count) return false;
+  // Fixed-width fields: no sign, every character a digit.
+  value = 0;
+  for (std::size_t i = 0; i < count; ++i) {
+    if (raw[i] < '0' || raw[i] > '9') return false;
+    value = value * 10 + (raw[i] - '0');
+  }
+  raw.remove_prefix(count);
+  return true;
+}
+
+bool ParseSeparator(std::string_view& raw, char separator) {
+  if (raw.empty() || raw.front() != separator) return false;
+  raw.remove_prefix(1);
+  return true;
+}
+
+bool ParseDate(std::string_view& raw, std::tm& date) {
+  date = std::tm();
+  if (!ParseDigits(raw, 4, date.tm_year) || !ParseSeparator(raw, '-') ||
+      !ParseDigits(raw, 2, date.tm_mon) || !ParseSeparator(raw, '-') ||
+      !ParseDigits(raw, 2, date.tm_mday)) {
+    return false;
+  }
+  date.tm_year -= 1900;
+  date.tm_mon -= 1;
+  return true;
+}
+
+bool ParseDate(Context& ctx, std::string_view raw, std::tm& date) {
+  return (ParseDate(raw, date) && raw.empty()) || Fail(ctx, "Invalid date");
+}
+
+/*!
+ * \brief Parse an ISO 8601 timestamp ("YYYY-MM-DDThh:mm:ss[.fff][Z|+hh:mm]").
+ * Timestamps without a zone designator are taken as UTC.
+ */
+bool ParseDateTime(Context& ctx, std::string_view raw, time_t& value) {
+  std::tm date;
+  if (!ParseDate(raw, date) || !ParseSeparator(raw, 'T') ||
+      !ParseDigits(raw, 2, date.tm_hour) || !ParseSeparator(raw, ':') ||
+      !ParseDigits(raw, 2, date.tm_min) || !ParseSeparator(raw, ':') ||
+      !ParseDigits(raw, 2, date.tm_sec)) {
+    return Fail(ctx, "Invalid timestamp");
+  }
+  if (ParseSeparator(raw, '.')) {
+    while (!raw.empty() && raw.front() >= '0' && raw.front() <= '9') {
+      raw.remove_prefix(1);
+    }
+  }
+  int offset = 0;
+  if (ParseSeparator(raw, 'Z')) {
+    // UTC
+  } else if (!raw.empty()) {
+    int sign = raw.front() == '-' ? -1 : 1;
+    int hours = 0;
+    int minutes = 0;
+    if ((!ParseSeparator(raw, '+') && !ParseSeparator(raw, '-')) ||
+        !ParseDigits(raw, 2, hours) || !ParseSeparator(raw, ':') ||
+        !ParseDigits(raw, 2, minutes)) {
+      return Fail(ctx, "Invalid timestamp");
+    }
+    offset = sign * (hours * 3600 + minutes * 60);
+  }
+  if (!raw.empty()) return Fail(ctx, "Invalid timestamp");
+  value = timegm(&date) - offset;
+  return true;
+}
+
+bool ParseIvl(Context& ctx, std::string_view raw, accm::IVL<std::string>& ivl) {
+  std::size_t separator = raw.find(';');
+  if (raw.size() < 3 || separator == std::string_view::npos ||
+      (raw.front() != '[' && raw.front() != '(') ||
+      (raw.back() != ']' && raw.back() != ')')) {
+    return Fail(ctx, "Invalid interval");
+  }
+  ivl.closed_low = raw.front() == '[';
+  ivl.closed_high = raw.back() == ']';
+  std::string_view low = raw.substr(1, separator - 1);
+  std::string_view high = raw.substr(separator + 1, raw.size() - separator - 2);
+  if (low.empty()) {
+    ivl.value_low.reset();
+  } else if (!ParseText(ctx, low, ivl.value_low)) {
+    return false;
+  }
+  if (high.empty()) {
+    ivl.value_high.reset();
+  } else if (!ParseText(ctx, high, ivl.value_high)) {
+    return false;
+  }
+  return true;
+}
+
+///////////////////////////////////
+// Leaf elements
+///////////////////////////////////
+bool ParseValue(Context& ctx, std::string_view raw, std::string& value) {
+  return ParseText(ctx, raw, value);
+}
+
+bool ParseValue(Context& ctx, std::string_view raw, accm::Code& value) {
+  if (raw.find('&') == std::string_view::npos) {
+    value = accm::Code(raw);
+    return true;
+  }
+  if (!ParseText(ctx, raw, ctx.scratch)) return false;
+  value = accm::Code(ctx.scratch);
+  return true;
+}
+
+bool ParseValue(Context& ctx, std::string_view raw, int& value) {
+  return ParseInt(ctx, raw, value);
+}
+
+bool ParseValue(Context& ctx, std::string_view raw, time_t& value) {
+  return ParseDateTime(ctx, raw, value);
+}
+
+bool ParseValue(Context& ctx, std::string_view raw, std::tm& value) {
+  return ParseDate(ctx, raw, value);
+}
+
+bool ParseValue(Context& ctx, std::string_view raw,
+                std::chrono::milliseconds& value) {
+  int count = 0;
+  if (!ParseInt(ctx, raw, count)) return false;
+  value = std::chrono::milliseconds(count);
+  return true;
+}
+
+template <typename E, typename = std::enable_if_t<std::is_enum_v<E>>>
+bool ParseValue(Context& ctx, std::string_view raw, E& value) {
+  return FromCode(raw, value) || Fail(ctx, "Unknown code");
+}
+
+template <typename T>
+bool ParseValue(Context& ctx, std::string_view raw, std::optional<T>& value) {
+  return ParseValue(ctx, raw, value.emplace());
+}
+
+/*!
+ * \brief Parse the attribute 'name' of the current element, if present.
+ */
+template <typename T>
+bool ParseAttribute(Context& ctx, std::string_view name, T& value) {
+  std::string_view raw;
+  if (!ctx.reader.GetAttribute(name, raw)) return true;
+  return ParseValue(ctx, raw, value);
+}
+
+template <typename M>
+bool ReadMember(Context& ctx, M& member);
+
+/*!
+ * \brief Read the attributes of a leaf element: the described fields of
+ * ATTRIBUTES structs, or the 'V' attribute of plain values.
+ */
+template <typename T>
+bool ReadLeafAttributes(Context& ctx, T& value) {
+  if constexpr (IsDescribed<T>::value) {
+    return !AnyField<T>([&](const auto& field) {
+      using FieldType = std::decay_t<decltype(field)>;
+      using Member = typename FieldType::MemberType;
+      if constexpr (FieldType::kSerialized && !IsSequence<Member>::value) {
+        return !ParseAttribute(ctx, field.name, field.Get(value));
+      }
+      return false;
+    });
+  } else {
+    return ParseAttribute(ctx, "V", value);
+  }
+}
+
+bool ReadLeafAttributes(Context& ctx, accm::IVL<std::string>& ivl) {
+  std::string_view raw;
+  if (ctx.reader.GetAttribute("V", raw) && !ParseIvl(ctx, raw, ivl)) {
+    return false;
+  }
+  return ReadLeafAttributes<accm::IVL<std::string>>(ctx, ivl);
+}
+
+/*!
+ * \brief Read the children of a leaf element: the repeated fields of
+ * ATTRIBUTES structs. Anything else is ignored.
+ */
+template <typename T>
+bool ReadLeafChildren(Context& ctx, T& value) {
+  if constexpr (IsDescribed<T>::value) {
+    return ForEachChild(ctx, [&](std::string_view name) {
+      bool ok = true;
+      bool found = AnyField<T>([&](const auto& field) {
+        using Member = typename std::decay_t<decltype(field)>::MemberType;
+        if constexpr (IsSequence<Member>::value) {
+          if (name == field.name) {
+            ok = ReadMember(ctx, field.Get(value));
+            return true;
+          }
+        }
+        return false;
+      });
+      return found ? ok : Skip(ctx);
+    });
+  } else {
+    return Skip(ctx);
+  }
+}
+
+///////////////////////////////////
+// Composite elements
+///////////////////////////////////
+/*!
+ * \brief Extra child handler for composites without special children.
+ */
+struct NoExtraChildren {
+  bool operator()(std::string_view, bool&) const { return false; }
+};
+
+/*!
+ * \brief Decode an ELEMENTS block. Each child is matched against the field
+ * table of T; children the 'extra' handler claims are left to it.
+ */
+template <typename T, typename Extra>
+bool DecodeComposite(Context& ctx, T& object, Extra&& extra) {
+  return ForEachChild(ctx, [&](std::string_view name) {
+    bool ok = true;
+    if (extra(name, ok)) return ok;
+    bool found = AnyField<T>([&](const auto& field) {
+      if constexpr (std::decay_t<decltype(field)>::kSerialized) {
+        if (name == field.name) {
+          ok = ReadMember(ctx, field.Get(object));
+          return true;
+        }
+      }
+      return false;
+    });
+    return found ? ok : Skip(ctx);
+  });
+}
+
+template <typename T>
+bool ReadElement(Context& ctx, T& value) {
+  if constexpr (IsComposite<T>::value) {
+    return DecodeComposite(ctx, value, NoExtraChildren());
+  } else {
+    return ReadLeafAttributes(ctx, value) && ReadLeafChildren(ctx, value);
+  }
+}
+
+/*!
+ * \brief Decode a member from the current element. Optional members are
+ * engaged, and repeated members get a new item.
+ */
+template <typename M>
+bool ReadMember(Context& ctx, M& member) {
+  if constexpr (IsOptional<M>::value) {
+    using Value = typename M::value_type;
+    if constexpr (IsSet<Value>::value || IsSequence<Value>::value) {
+      if (!member) member.emplace();
+      return ReadMember(ctx, *member);
+    } else {
+      return ReadElement(ctx, member.emplace());
+    }
+  } else if constexpr (IsSequence<M>::value) {
+    return ReadElement(ctx, member.emplace_back());
+  } else if constexpr (IsSet<M>::value) {
+    typename M::value_type value;
+    if (!ReadElement(ctx, value)) return false;
+    member.insert(std::move(value));
+    return true;
+  } else {
+    return ReadElement(ctx, member);
+  }
+}
+
+/*!
+ * \brief Decode a <SVC> block. The observations are nested inside the <PT>
+ * or <CTC> block on the wire, but belong to the service in the data model.
+ */
+bool ReadElement(Context& ctx, accm::Service& service) {
+  auto observations = [&](std::string_view name, bool& ok) {
+    if (name != FieldTable<accm::Observation>::kTag) return false;
+    ok = ReadMember(ctx, service.observations);
+    return true;
+  };
+  return DecodeComposite(ctx, service, [&](std::string_view name, bool& ok) {
+    if (name == FieldTable<accm::Patient>::kTag) {
+      ok = DecodeComposite(ctx, service.patient.emplace(), observations);
+      return true;
+    }
+    if (name == FieldTable<accm::ControlCalibration>::kTag) {
+      ok = DecodeComposite(ctx, service.control.emplace(), observations);
+      return true;
+    }
+    return false;
+  });
+}
+
+/*!
+ * \brief Check if a member is written as a block of elements or a list.
+ */
+template <typename M>
+struct IsNested
+    : std::bool_constant<IsComposite<M>::value || IsSequence<M>::value> {};
+template <typename T>
+struct IsNested<std::optional<T>> : IsNested<T> {};
+
+/*!
+ * \brief Decode only the top-level leaf fields of a <SVC> block, skipping the
+ * nested patient, control, observation, reagent, specimen and note blocks.
+ */
+bool ReadServiceSummary(Context& ctx, accm::Service& service) {
+  return ForEachChild(ctx, [&](std::string_view name) {
+    bool ok = true;
+    bool found = AnyField<accm::Service>([&](const auto& field) {
+      using Member = typename std::decay_t<decltype(field)>::MemberType;
+      if constexpr (!IsNested<Member>::value) {
+        if (name == field.name) {
+          ok = ReadMember(ctx, field.Get(service));
+          return true;
+        }
+      }
+      return false;
+    });
+    return found ? ok : Skip(ctx);
+  });
+}
+
+/*!
+ * \brief Decode a raw <SVC> element kept by a lazily decoded OBS message.
+ */
+bool ParseService(std::string_view raw, accm::Service& service) {
+  Context ctx(raw, service.observations.get_allocator());
+  return ctx.reader.Next() == Token::START_ELEMENT &&
+         ctx.reader.GetName() == FieldTable<accm::Service>::kTag &&
+         ReadElement(ctx, service) &&
+         ctx.reader.Next() == Token::END_DOCUMENT;
+}
+
+/*!
+ * \brief Decode the <SVC> element of an OBS message lazily: only its summary
+ * is decoded now, and the raw element is kept for GetService.
+ */
+bool DecodeLazyService(Context& ctx, MessageObservations& message) {
+  std::size_t start = ctx.reader.GetTokenStart();
+  accm::Service summary(ctx.allocator);
+  if (!ReadServiceSummary(ctx, summary)) return false;
+  std::string_view raw =
+      ctx.xml.substr(start, ctx.reader.GetPosition() - start);
+  message.SetLazyService(raw, std::move(summary), &ParseService);
+  return true;
+}
+
+///////////////////////////////////
+// Messages
+///////////////////////////////////
+/*!
+ * \brief Factory of messages on the heap.
+ */
+struct HeapFactory {
+  using Pointer = std::unique_ptr<Message>;
+
+  template <typename T, typename... Args>
+  std::unique_ptr<Message> New(Args&&... args) {
+    return std::make_unique<T>(std::forward<Args>(args)...);
+  }
+};
+
+/*!
+ * \brief Factory of messages in a MessageArena.
+ */
+struct ArenaFactory {
+  using Pointer = ArenaPtr<Message>;
+
+  template <typename T, typename... Args>
+  ArenaPtr<Message> New(Args&&... args) {
+    return arena.New<T>(std::forward<Args>(args)...);
+  }
+
+  MessageArena& arena;
+};
+
+/*!
+ * \brief Factory of messages recycled by a MessagePool.
+ */
+struct PoolFactory {
+  using Pointer = PoolPtr<Message>;
+
+  MessagePool& pool;
+};
+
+template <typename Factory>
+typename Factory::Pointer CreateMessage(accm::Header::MsgType type,
+                                        const accm::Allocator& alloc,
+                                        Factory& factory) {
+  using MsgType = accm::Header::MsgType;
+  switch (type) {
+    case MsgType::ACK_R01:
+      return factory.template New<MessageAck>();
+    case MsgType::DST_R01:
+      return factory.template New<MessageDeviceStatus>();
+    case MsgType::ESC_R01:
+      return factory.template New<MessageEscape>();
+    case MsgType::EOT_R01:
+      return factory.template New<MessageEndOfTopic>();
+    case MsgType::HEL_R01:
+      return factory.template New<MessageHello>();
+    case MsgType::OBS_R01:
+      return factory.template New<MessageObservations>(true, alloc);
+    case MsgType::OBS_R02:
+      return factory.template New<MessageObservations>(false, alloc);
+    case MsgType::OPL_R01:
+      return factory.template New<MessageOperatorList>(true);
+    case MsgType::OPL_R02:
+      return factory.template New<MessageOperatorList>(false);
+    case MsgType::PTL_R01:
+      return factory.template New<MessagePatientList>(true);
+    case MsgType::PTL_R02:
+      return factory.template New<MessagePatientList>(false);
+    case MsgType::REQ_R01:
+      return factory.template New<MessageRequest>();
+    case MsgType::END_R01:
+      return factory.template New<MessageTerminate>();
+    default:
+      return nullptr;
+  }
+}
+
+PoolFactory::Pointer CreateMessage(accm::Header::MsgType type,
+                                   const accm::Allocator&,
+                                   PoolFactory& factory) {
+  return factory.pool.Acquire(type);
+}
+
+/*!
+ * \brief Create an empty body, using the allocator of the context if the
+ * body is allocator-aware.
+ */
+template <typename Body>
+Body MakeBody(Context& ctx) {
+  if constexpr (std::uses_allocator_v<Body, accm::Allocator>) {
+    return Body(ctx.allocator);
+  } else {
+    return Body();
+  }
+}
+
+/*!
+ * \brief Decode the body element of a message whose body is of type Body.
+ * \return false if the element is not the body of the message; true otherwise
+ * with 'ok' holding the decoding result.
+ */
+template <typename Body>
+bool DecodeBody(Context& ctx, std::string_view name, Message& message,
+                bool& ok) {
+  using Traits = MessageBodyTraits<Body>;
+  if (name != FieldTable<Body>::kTag) return false;
+  Body body = MakeBody<Body>(ctx);
+  ok = ReadElement(ctx, body);
+  Traits::Set(static_cast<typename Traits::Class&>(message), std::move(body));
+  return true;
+}
+
+/*!
+ * \brief Decode one entry of a list topic message (OPL.*, PTL.*).
+ * \return false if the element is not an entry of the list; true otherwise
+ * with 'ok' holding the decoding result.
+ */
+template <typename Entry>
+bool DecodeListEntry(Context& ctx, std::string_view name, Message& message,
+                     bool& ok) {
+  using Traits = MessageListTraits<Entry>;
+  if (name != FieldTable<Entry>::kTag) return false;
+  Entry entry;
+  ok = ReadElement(ctx, entry);
+  Traits::Add(static_cast<typename Traits::Class&>(message), std::move(entry));
+  return true;
+}
+
+bool DecodeBody(Context& ctx, std::string_view name, Message& message,
+                bool& ok) {
+  switch (message.GetMessageType()) {
+    case accm::Header::MsgType::ACK_R01:
+      return DecodeBody<accm::Ack>(ctx, name, message, ok);
+    case accm::Header::MsgType::DST_R01:
+      return DecodeBody<accm::DeviceStatus>(ctx, name, message, ok);
+    case accm::Header::MsgType::ESC_R01:
+      return DecodeBody<accm::Escape>(ctx, name, message, ok);
+    case accm::Header::MsgType::EOT_R01:
+      return DecodeBody<accm::EndOfTopic>(ctx, name, message, ok);
+    case accm::Header::MsgType::HEL_R01:
+      return DecodeBody<accm::Device>(ctx, name, message, ok);
+    case accm::Header::MsgType::OBS_R01:
+    case accm::Header::MsgType::OBS_R02:
+      return DecodeBody<accm::Service>(ctx, name, message, ok);
+    case accm::Header::MsgType::OPL_R01:
+    case accm::Header::MsgType::OPL_R02:
+      return DecodeListEntry<accm::Operator>(ctx, name, message, ok);
+    case accm::Header::MsgType::PTL_R01:
+    case accm::Header::MsgType::PTL_R02:
+      return DecodeListEntry<accm::Patient>(ctx, name, message, ok);
+    case accm::Header::MsgType::REQ_R01:
+      return DecodeBody<accm::Request>(ctx, name, message, ok);
+    case accm::Header::MsgType::END_R01:
+      return DecodeBody<accm::Terminate>(ctx, name, message, ok);
+    default:
+      return false;
+  }
+}
+
+/*!
+ * \brief Decode a whole document into the target, which creates the body for
+ * the message type found in the root element and decodes it.
+ * \return true on success; false otherwise, with the error description in
+ * last_error.
+ */
+template <typename Target>
+bool DecodeDocument(std::string_view xml, const accm::Allocator& alloc,
+                    Target& target, std::string& last_error) {
+  last_error.clear();
+  Context ctx(xml, alloc);
+
+  accm::Header header;
+  bool ok = false;
+  switch (ctx.reader.Next()) {
+    case Token::START_ELEMENT: {
+      accm::Header::MsgType type;
+      std::string_view root = ctx.reader.GetName();
+      if (!poct1::ParseRootName(root, type)) {
+        Fail(ctx, "Unknown message type");
+        break;
+      }
+      if (!target.Create(ctx, type)) {
+        Fail(ctx, "Unsupported message type");
+        break;
+      }
+      header.message_type = accm::CV(root);
+      ok = ForEachChild(ctx, [&](std::string_view name) {
+        bool body_ok = false;
+        if (name == FieldTable<accm::Header>::kTag) {
+          return ReadElement(ctx, header);
+        }
+        if (target.ReadBody(ctx, name, body_ok)) return body_ok;
+        return Skip(ctx);
+      });
+      break;
+    }
+    case Token::ERROR:
+      Fail(ctx, ctx.reader.GetError());
+      break;
+    default:
+      Fail(ctx, "Empty document");
+      break;
+  }
+
+  if (ok && ctx.reader.Next() != Token::END_DOCUMENT) {
+    ok = Fail(ctx, "Unexpected content after the root element");
+  }
+  if (!ok) {
+    last_error.assign(ctx.error.data(), ctx.error.size());
+    if (!ctx.element.empty()) {
+      last_error.append(" at <").append(ctx.element).append(">");
+    }
+    return false;
+  }
+  target.SetHeader(std::move(header));
+  return true;
+}
+
+/*!
+ * \brief Decoding target creating a message of the Message hierarchy with
+ * the factory.
+ */
+template <typename Factory>
+struct MessageTarget {
+  bool Create(Context& ctx, accm::Header::MsgType type) {
+    message = CreateMessage(type, ctx.allocator, factory);
+    return message != nullptr;
+  }
+  bool ReadBody(Context& ctx, std::string_view name, bool& ok) {
+    accm::Header::MsgType type = message->GetMessageType();
+    if (lazy_services && name == FieldTable<accm::Service>::kTag &&
+        (type == accm::Header::MsgType::OBS_R01 ||
+         type == accm::Header::MsgType::OBS_R02)) {
+      ok = DecodeLazyService(ctx, static_cast<MessageObservations&>(*message));
+      return true;
+    }
+    return DecodeBody(ctx, name, *message, ok);
+  }
+  void SetHeader(accm::Header&& header) {
+    std::string control_id = std::move(header.control_id);
+    message->SetHeader(std::move(header), std::move(control_id));
+  }
+
+  Factory& factory;
+  bool lazy_services;
+  typename Factory::Pointer message;
+};
+
+/*!
+ * \brief Decoding target filling a MessageVariant.
+ */
+struct VariantTarget {
+  bool Create(Context&, accm::Header::MsgType type) {
+    variant.type = type;
+    return EmplaceBody(type, variant.body);
+  }
+  bool ReadBody(Context& ctx, std::string_view name, bool& ok) {
+    return std::visit(
+        [&](auto& body) {
+          using Body = std::decay_t<decltype(body)>;
+          if (name != FieldTable<Body>::kTag) return false;
+          ok = ReadElement(ctx, body);
+          return true;
+        },
+        variant.body);
+  }
+  void SetHeader(accm::Header&& header) { variant.header = std::move(header); }
+
+  MessageVariant& variant;
+};
+
+template <typename Factory>
+typename Factory::Pointer DecodeMessage(std::string_view xml,
+                                        const accm::Allocator& alloc,
+                                        Factory& factory, bool lazy_services,
+                                        std::string& last_error) {
+  MessageTarget<Factory> target{factory, lazy_services, nullptr};
+  if (!DecodeDocument(xml, alloc, target, last_error)) target.message.reset();
+  return std::move(target.message);
+}
+}  // namespace
+
+std::unique_ptr<Message> MessageDecoder::Decode(std::string_view xml) {
+  HeapFactory factory;
+  return DecodeMessage(xml, accm::Allocator(), factory, lazy_services_,
+                       last_error_);
+}
+
+ArenaPtr<Message> MessageDecoder::Decode(std::string_view xml,
+                                         MessageArena& arena) {
+  ArenaFactory factory{arena};
+  return DecodeMessage(xml, arena.GetAllocator(), factory, lazy_services_,
+                       last_error_);
+}
+
+PoolPtr<Message> MessageDecoder::Decode(std::string_view xml,
+                                        MessagePool& pool) {
+  PoolFactory factory{pool};
+  return DecodeMessage(xml, accm::Allocator(), factory, lazy_services_,
+                       last_error_);
+}
+
+bool MessageDecoder::Decode(std::string_view xml, MessageVariant& variant) {
+  VariantTarget target{variant};
+  return DecodeDocument(xml, accm::Allocator(), target, last_error_);
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <string_view>
+#include "Message.h"
+#include "MessageArena.h"
+#include "MessagePool.h"
+#include "MessageVariant.h"
+
+/*!
+ * \brief The MessageDecoder class turns POCT1-A XML into the Message
+ * hierarchy.
+ *
+ * The decoder streams over the input buffer once (see XmlReader) and fills the
+ * accm:: structures directly, without building an intermediate document tree.
+ * Unknown elements are skipped, so vendor extensions do not break decoding.
+ */
+class MessageDecoder {
+ public:
+  /*!
+   * \brief Default constructor.
+   */
+  MessageDecoder() = default;
+  /*!
+   * \brief Default destructor.
+   */
+  ~MessageDecoder() = default;
+  /*!
+   * \brief Decode a single POCT1-A message.
+   * \param xml The XML document holding the message.
+   * \return The decoded message; nullptr if the document is malformed or the
+   * message type is not supported.
+   * \see GetLastError
+   */
+  std::unique_ptr<Message> Decode(std::string_view xml);
+  /*!
+   * \brief Decode a single POCT1-A message into an arena. The message and the
+   * repeated fields of its body are allocated from the arena.
+   * \param xml The XML document holding the message.
+   * \param arena The arena where to create the message.
+   * \return The decoded message; nullptr if the document is malformed or the
+   * message type is not supported.
+   * \see GetLastError
+   */
+  ArenaPtr<Message> Decode(std::string_view xml, MessageArena& arena);
+  /*!
+   * \brief Decode a single POCT1-A message into a message recycled by a pool.
+   * \param xml The XML document holding the message.
+   * \param pool The pool from which to acquire the message.
+   * \return The decoded message; nullptr if the document is malformed or the
+   * message type is not supported. On failure the message goes back to the
+   * pool.
+   * \see GetLastError
+   */
+  PoolPtr<Message> Decode(std::string_view xml, MessagePool& pool);
+  /*!
+   * \brief Decode a single POCT1-A message into a MessageVariant.
+   * \param xml The XML document holding the message.
+   * \param variant Output message.
+   * \return true on success; false if the document is malformed or the
+   * message type is not supported.
+   * \see GetLastError
+   */
+  bool Decode(std::string_view xml, MessageVariant& variant);
+  /*!
+   * \brief Enable or disable the lazy decoding of the <SVC> block of the
+   * OBS.R01/OBS.R02 messages. When enabled, only the top-level fields of the
+   * service are decoded; the observations, patient and control blocks are
+   * decoded on the first call to MessageObservations::GetService, and a
+   * message re-encoded before that is forwarded with its original <SVC>
+   * bytes. Disabled by default. The MessageVariant overload of Decode always
+   * decodes eagerly.
+   * \param lazy true to decode the services lazily.
+   */
+  inline void SetLazyServices(bool lazy) { lazy_services_ = lazy; }
+  /*!
+   * \brief Get the reason why the last call to Decode failed.
+   * \return The error description.
+   */
+  inline const std::string& GetLastError() const { return last_error_; }
+
+ private:
+  bool lazy_services_ = false;
+  std::string last_error_;
+};
@@ -0,0 +1,361 @@
+#include "MessageEncoder.h"
+#include <array>
+#include "AccmReflection.h"
+#include "Poct1Format.h"
+#include "XmlWriter.h"
+
+namespace {
+using namespace accm::reflection;
+
+///////////////////////////////////
+// Leaf elements
+///////////////////////////////////
+void WriteValue(XmlWriter& writer, std::string_view name,
+                const std::string& value) {
+  writer.Attribute(name, value);
+}
+
+void WriteValue(XmlWriter& writer, std::string_view name,
+                const accm::Code& value) {
+  writer.Attribute(name, value.View());
+}
+
+void WriteValue(XmlWriter& writer, std::string_view name, int value) {
+  writer.Attribute(name, value);
+}
+
+void WriteValue(XmlWriter& writer, std::string_view name, time_t value) {
+  writer.AttributeDateTime(name, value);
+}
+
+void WriteValue(XmlWriter& writer, std::string_view name, const std::tm& date) {
+  writer.AttributeDate(name, date);
+}
+
+void WriteValue(XmlWriter& writer, std::string_view name,
+                std::chrono::milliseconds value) {
+  writer.Attribute(name, static_cast<long long>(value.count()));
+}
+
+template <typename E, typename = std::enable_if_t<std::is_enum_v<E>>>
+void WriteValue(XmlWriter& writer, std::string_view name, E value) {
+  writer.Attribute(name, ToCode(value));
+}
+
+template <typename T>
+void WriteValue(XmlWriter& writer, std::string_view name,
+                const std::optional<T>& value) {
+  if (value) WriteValue(writer, name, *value);
+}
+
+template <typename M>
+void WriteMember(XmlWriter& writer, std::string_view name, const M& member);
+
+/*!
+ * \brief Write the attributes of a leaf element: the described fields of
+ * ATTRIBUTES structs, or the 'V' attribute of plain values.
+ */
+template <typename T>
+void WriteLeafAttributes(XmlWriter& writer, const T& value) {
+  if constexpr (IsDescribed<T>::value) {
+    ForEachField<T>([&](const auto& field) {
+      using FieldType = std::decay_t<decltype(field)>;
+      using Member = typename FieldType::MemberType;
+      if constexpr (FieldType::kSerialized && !IsSequence<Member>::value) {
+        WriteValue(writer, field.name, field.Get(value));
+      }
+    });
+  } else {
+    WriteValue(writer, "V", value);
+  }
+}
+
+void WriteLeafAttributes(XmlWriter& writer,
+                         const accm::IVL<std::string>& ivl) {
+  writer.StartAttribute("V");
+  writer.AppendRaw(ivl.closed_low ? '[' : '(');
+  if (ivl.value_low) writer.AppendEscaped(*ivl.value_low);
+  writer.AppendRaw(';');
+  if (ivl.value_high) writer.AppendEscaped(*ivl.value_high);
+  writer.AppendRaw(ivl.closed_high ? ']' : ')');
+  writer.EndAttribute();
+  WriteLeafAttributes<accm::IVL<std::string>>(writer, ivl);
+}
+
+/*!
+ * \brief Check if a leaf has repeated fields to be written as children.
+ */
+template <typename T>
+bool HasLeafChildren(const T& value) {
+  return AnyField<T>([&](const auto& field) {
+    using Member = typename std::decay_t<decltype(field)>::MemberType;
+    if constexpr (IsSequence<Member>::value) {
+      return !field.Get(value).empty();
+    }
+    return false;
+  });
+}
+
+template <typename T>
+void WriteLeafChildren(XmlWriter& writer, const T& value) {
+  ForEachField<T>([&](const auto& field) {
+    using Member = typename std::decay_t<decltype(field)>::MemberType;
+    if constexpr (IsSequence<Member>::value) {
+      WriteMember(writer, field.name, field.Get(value));
+    }
+  });
+}
+
+///////////////////////////////////
+// Composite elements
+///////////////////////////////////
+/*!
+ * \brief Extra children writer for composites without special children.
+ */
+struct NoExtraChildren {
+  void operator()() const {}
+};
+
+/*!
+ * \brief Encode an ELEMENTS block: every serialized field of T in table
+ * order, followed by whatever the 'extra' writer appends.
+ */
+template <typename T, typename Extra>
+void EncodeComposite(XmlWriter& writer, const T& object, Extra&& extra) {
+  writer.Open(FieldTable<T>::kTag);
+  ForEachField<T>([&](const auto& field) {
+    if constexpr (std::decay_t<decltype(field)>::kSerialized) {
+      WriteMember(writer, field.name, field.Get(object));
+    }
+  });
+  extra();
+  writer.Close(FieldTable<T>::kTag);
+}
+
+template <typename T>
+void WriteElement(XmlWriter& writer, std::string_view name, const T& value) {
+  if constexpr (IsComposite<T>::value) {
+    EncodeComposite(writer, value, NoExtraChildren());
+  } else {
+    writer.Start(name);
+    WriteLeafAttributes(writer, value);
+    if constexpr (IsDescribed<T>::value) {
+      if (HasLeafChildren(value)) {
+        writer.EndStart();
+        WriteLeafChildren(writer, value);
+        writer.Close(name);
+        return;
+      }
+    }
+    writer.EndEmpty();
+  }
+}
+
+/*!
+ * \brief Encode a member as an element. Unset optional members are skipped
+ * and repeated members are written once per item.
+ */
+template <typename M>
+void WriteMember(XmlWriter& writer, std::string_view name, const M& member) {
+  if constexpr (IsOptional<M>::value) {
+    if (member) WriteMember(writer, name, *member);
+  } else if constexpr (IsSequence<M>::value || IsSet<M>::value) {
+    for (const auto& item : member) WriteElement(writer, name, item);
+  } else {
+    WriteElement(writer, name, member);
+  }
+}
+
+/*!
+ * \brief Encode a <SVC> block. The observations are nested inside the <PT>
+ * block for patient services, or inside <CTC> for QC/calibration ones.
+ */
+void WriteElement(XmlWriter& writer, std::string_view,
+                  const accm::Service& service) {
+  auto observations = [&] {
+    WriteMember(writer, FieldTable<accm::Observation>::kTag,
+                service.observations);
+  };
+  writer.Open(FieldTable<accm::Service>::kTag);
+  ForEachField<accm::Service>([&](const auto& field) {
+    const auto& member = field.Get(service);
+    using Member = std::decay_t<decltype(member)>;
+    if constexpr (std::is_same_v<Member, std::optional<accm::Patient>>) {
+      if (member) EncodeComposite(writer, *member, observations);
+    } else if constexpr (std::is_same_v<
+                             Member, std::optional<accm::ControlCalibration>>) {
+      if (member) {
+        EncodeComposite(writer, *member, [&] {
+          if (!service.patient) observations();
+        });
+      }
+    } else if constexpr (std::is_same_v<Member,
+                                        decltype(service.observations)>) {
+      if (!service.patient && !service.control) observations();
+    } else {
+      WriteMember(writer, field.name, member);
+    }
+  });
+  writer.Close(FieldTable<accm::Service>::kTag);
+}
+
+/*!
+ * \brief Encode the body of a message whose body is of type Body.
+ */
+template <typename Body>
+bool EncodeBody(XmlWriter& writer, const Message& message) {
+  using Traits = MessageBodyTraits<Body>;
+  const auto& concrete = static_cast<const typename Traits::Class&>(message);
+  if constexpr (std::is_same_v<Body, accm::Service>) {
+    // A body that has not been decoded is forwarded as received.
+    if (concrete.IsServicePending()) {
+      writer.AppendMarkup(concrete.GetRawService());
+      return true;
+    }
+  }
+  const Body* body = Traits::Get(concrete);
+  if (!body) return false;
+  WriteElement(writer, FieldTable<Body>::kTag, *body);
+  return true;
+}
+
+/*!
+ * \brief Encode the entries of a list topic message (OPL.*, PTL.*).
+ */
+template <typename Entry>
+bool EncodeList(XmlWriter& writer, const Message& message) {
+  using Traits = MessageListTraits<Entry>;
+  const auto& concrete = static_cast<const typename Traits::Class&>(message);
+  for (const Entry& entry : *Traits::Get(concrete)) {
+    WriteElement(writer, FieldTable<Entry>::kTag, entry);
+  }
+  return true;
+}
+
+/*!
+ * \brief Encode the body of a message.
+ * \return false if the message type is not supported.
+ */
+bool EncodeMessageBody(XmlWriter& writer, const Message& message) {
+  switch (message.GetMessageType()) {
+    case accm::Header::MsgType::ACK_R01:
+      return EncodeBody<accm::Ack>(writer, message);
+    case accm::Header::MsgType::DST_R01:
+      return EncodeBody<accm::DeviceStatus>(writer, message);
+    case accm::Header::MsgType::ESC_R01:
+      return EncodeBody<accm::Escape>(writer, message);
+    case accm::Header::MsgType::EOT_R01:
+      return EncodeBody<accm::EndOfTopic>(writer, message);
+    case accm::Header::MsgType::HEL_R01:
+      return EncodeBody<accm::Device>(writer, message);
+    case accm::Header::MsgType::OBS_R01:
+    case accm::Header::MsgType::OBS_R02:
+      return EncodeBody<accm::Service>(writer, message);
+    case accm::Header::MsgType::OPL_R01:
+    case accm::Header::MsgType::OPL_R02:
+      return EncodeList<accm::Operator>(writer, message);
+    case accm::Header::MsgType::PTL_R01:
+    case accm::Header::MsgType::PTL_R02:
+      return EncodeList<accm::Patient>(writer, message);
+    case accm::Header::MsgType::REQ_R01:
+      return EncodeBody<accm::Request>(writer, message);
+    case accm::Header::MsgType::END_R01:
+      return EncodeBody<accm::Terminate>(writer, message);
+    default:
+      return false;
+  }
+}
+
+/*!
+ * \brief The constant prologue and epilogue of the documents of every message
+ * type.
+ */
+struct DocumentFrames {
+  static constexpr std::size_t kTypes =
+      static_cast<std::size_t>(accm::Header::MsgType::END_R01) + 1;
+  std::array<std::string, kTypes> prologues;
+  std::array<std::string, kTypes> epilogues;
+
+  DocumentFrames() {
+    for (std::size_t i = 0; i < kTypes; ++i) {
+      std::string_view root =
+          poct1::GetRootName(static_cast<accm::Header::MsgType>(i));
+      XmlWriter prologue(prologues[i]);
+      prologue.Declaration();
+      prologue.Open(root);
+      XmlWriter(epilogues[i]).Close(root);
+    }
+  }
+
+  static const DocumentFrames& Get() {
+    static const DocumentFrames frames;
+    return frames;
+  }
+};
+
+/*!
+ * \brief Encode a whole document: declaration, root, header and the body
+ * written by 'body'.
+ * \return false if 'body' failed, with the buffer rolled back.
+ */
+template <typename BodyWriter>
+bool EncodeDocument(accm::Header::MsgType type, const accm::Header& header,
+                    std::string& buffer, BodyWriter&& body) {
+  std::size_t rollback = buffer.size();
+  std::string_view root = poct1::GetRootName(type);
+  XmlWriter writer(buffer);
+  writer.Declaration();
+  writer.Open(root);
+  WriteElement(writer, FieldTable<accm::Header>::kTag, header);
+  if (!body(writer)) {
+    buffer.resize(rollback);
+    return false;
+  }
+  writer.Close(root);
+  return true;
+}
+}  // namespace
+
+bool MessageEncoder::Encode(const Message& message, std::string& buffer) const {
+  return EncodeDocument(
+      message.GetMessageType(), *message.GetHeader(), buffer,
+      [&](XmlWriter& writer) { return EncodeMessageBody(writer, message); });
+}
+
+std::string_view MessageEncoder::GetPrologue(accm::Header::MsgType type) {
+  return DocumentFrames::Get().prologues[static_cast<std::size_t>(type)];
+}
+
+std::string_view MessageEncoder::GetEpilogue(accm::Header::MsgType type) {
+  return DocumentFrames::Get().epilogues[static_cast<std::size_t>(type)];
+}
+
+void MessageEncoder::EncodeHeader(const accm::Header& header,
+                                  std::string& buffer) const {
+  XmlWriter writer(buffer);
+  WriteElement(writer, FieldTable<accm::Header>::kTag, header);
+}
+
+bool MessageEncoder::EncodeBody(const Message& message,
+                                std::string& buffer) const {
+  std::size_t rollback = buffer.size();
+  XmlWriter writer(buffer);
+  if (EncodeMessageBody(writer, message)) return true;
+  buffer.resize(rollback);
+  return false;
+}
+
+bool MessageEncoder::Encode(const MessageVariant& message,
+                            std::string& buffer) const {
+  return EncodeDocument(message.type, message.header, buffer,
+                        [&](XmlWriter& writer) {
+                          std::visit(
+                              [&](const auto& body) {
+                                using Body = std::decay_t<decltype(body)>;
+                                WriteElement(writer, FieldTable<Body>::kTag,
+                                             body);
+                              },
+                              message.body);
+                          return true;
+                        });
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include "Message.h"
+#include "MessageVariant.h"
+
+/*!
+ * \brief The MessageEncoder class turns the Message hierarchy into POCT1-A
+ * XML.
+ *
+ * Messages are appended to a caller-owned buffer, which is meant to be cleared
+ * and reused from one message to the next so that, once warmed up, encoding
+ * does not allocate (see XmlWriter). Optional fields that are not set are
+ * omitted from the output.
+ *
+ * A document is also available in pieces: GetPrologue, EncodeHeader,
+ * EncodeBody and GetEpilogue, in this order, produce what Encode does. The
+ * prologue and epilogue never change for a message type, and a body can be
+ * encoded once and sent in many messages, so the pieces can be written as
+ * separate segments (see ITransport::Segment) without being copied.
+ */
+class MessageEncoder {
+ public:
+  /*!
+   * \brief Default constructor.
+   */
+  MessageEncoder() = default;
+  /*!
+   * \brief Default destructor.
+   */
+  ~MessageEncoder() = default;
+  /*!
+   * \brief Append a message as a POCT1-A XML document to the buffer.
+   * \param message The message to encode.
+   * \param buffer The buffer where to append the document. It is not cleared.
+   * \return true on success; false if the message type is not supported.
+   */
+  bool Encode(const Message& message, std::string& buffer) const;
+  /*!
+   * \brief Append a MessageVariant as a POCT1-A XML document to the buffer.
+   * \param message The message to encode.
+   * \param buffer The buffer where to append the document. It is not cleared.
+   * \return true on success.
+   */
+  bool Encode(const MessageVariant& message, std::string& buffer) const;
+
+  /*!
+   * \brief Get the start of the documents of a message type: the XML
+   * declaration and the opening root tag.
+   * \param type The message type.
+   * \return The prologue; it lives as long as the program.
+   */
+  static std::string_view GetPrologue(accm::Header::MsgType type);
+  /*!
+   * \brief Get the end of the documents of a message type: the closing root
+   * tag.
+   * \param type The message type.
+   * \return The epilogue; it lives as long as the program.
+   */
+  static std::string_view GetEpilogue(accm::Header::MsgType type);
+  /*!
+   * \brief Append the header (<HDR>) of a message to the buffer.
+   * \param header The header.
+   * \param buffer The buffer where to append the header. It is not cleared.
+   */
+  void EncodeHeader(const accm::Header& header, std::string& buffer) const;
+  /*!
+   * \brief Append the body of a message (e.g. the <SVC> of an OBS.R01) to the
+   * buffer.
+   * \param message The message whose body to encode.
+   * \param buffer The buffer where to append the body. It is not cleared.
+   * \return true on success; false if the message type is not supported.
+   */
+  bool EncodeBody(const Message& message, std::string& buffer) const;
+};
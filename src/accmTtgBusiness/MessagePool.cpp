@@ -0,0 +1,89 @@
+#include "MessagePool.h"
+
+namespace {
+Message* CreateMessage(accm::Header::MsgType type) {
+  using MsgType = accm::Header::MsgType;
+  switch (type) {
+    case MsgType::ACK_R01:
+      return new MessageAck();
+    case MsgType::DST_R01:
+      return new MessageDeviceStatus();
+    case MsgType::ESC_R01:
+      return new MessageEscape();
+    case MsgType::EOT_R01:
+      return new MessageEndOfTopic();
+    case MsgType::HEL_R01:
+      return new MessageHello();
+    case MsgType::OBS_R01:
+      return new MessageObservations(true);
+    case MsgType::OBS_R02:
+      return new MessageObservations(false);
+    case MsgType::OPL_R01:
+      return new MessageOperatorList(true);
+    case MsgType::OPL_R02:
+      return new MessageOperatorList(false);
+    case MsgType::PTL_R01:
+      return new MessagePatientList(true);
+    case MsgType::PTL_R02:
+      return new MessagePatientList(false);
+    case MsgType::REQ_R01:
+      return new MessageRequest();
+    case MsgType::END_R01:
+      return new MessageTerminate();
+    default:
+      return nullptr;
+  }
+}
+}  // namespace
+
+void PoolDeleter::operator()(Message* message) const {
+  pool->Release(message);
+}
+
+MessagePool::MessagePool(std::size_t capacity) : capacity_(capacity) {
+  for (FreeList& free_list : free_lists_) {
+    free_list.messages.reserve(capacity_);
+  }
+}
+
+MessagePool::~MessagePool() {
+  for (FreeList& free_list : free_lists_) {
+    for (Message* message : free_list.messages) {
+      delete message;
+    }
+  }
+}
+
+PoolPtr<Message> MessagePool::Acquire(accm::Header::MsgType type) {
+  FreeList& free_list = free_lists_[static_cast<std::size_t>(type)];
+  Message* message = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(free_list.mutex);
+    if (!free_list.messages.empty()) {
+      message = free_list.messages.back();
+      free_list.messages.pop_back();
+    }
+  }
+  if (!message) message = CreateMessage(type);
+  return PoolPtr<Message>(message, PoolDeleter{this});
+}
+
+std::size_t MessagePool::GetIdleCount(accm::Header::MsgType type) const {
+  const FreeList& free_list = free_lists_[static_cast<std::size_t>(type)];
+  std::lock_guard<std::mutex> lock(free_list.mutex);
+  return free_list.messages.size();
+}
+
+void MessagePool::Release(Message* message) {
+  message->Reset();
+  FreeList& free_list =
+      free_lists_[static_cast<std::size_t>(message->GetMessageType())];
+  {
+    std::lock_guard<std::mutex> lock(free_list.mutex);
+    if (free_list.messages.size() < capacity_) {
+      free_list.messages.push_back(message);
+      return;
+    }
+  }
+  delete message;
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "Message.h"
+
+class MessagePool;
+
+/*!
+ * \brief Deleter of the messages acquired from a MessagePool: it gives them
+ * back to the pool.
+ */
+struct PoolDeleter {
+  void operator()(Message* message) const;
+
+  MessagePool* pool = nullptr;
+};
+
+/*!
+ * \brief Owning pointer to a message acquired from a MessagePool.
+ */
+template <typename T>
+using PoolPtr = std::unique_ptr<T, PoolDeleter>;
+
+/*!
+ * \brief The MessagePool class recycles the instances of the Message
+ * subclasses, with one free list per accm::Header::MsgType.
+ *
+ * Released messages are reset (see Message::Reset) and kept for the next
+ * Acquire of the same type, so that steady traffic stops hitting the global
+ * allocator for the message objects. Each free list is reserved up front and
+ * holds at most 'capacity' idle messages; messages released beyond that are
+ * deleted. Acquire and release may happen on different threads. The pool must
+ * outlive the messages acquired from it.
+ */
+class MessagePool {
+ public:
+  /*!
+   * \brief Default number of idle messages kept per type.
+   */
+  static constexpr std::size_t kDefaultCapacity = 1024;
+
+  /*!
+   * \brief Constructor.
+   * \param capacity The maximum number of idle messages kept per type.
+   */
+  explicit MessagePool(std::size_t capacity = kDefaultCapacity);
+  /*!
+   * \brief Destructor. Deletes the idle messages.
+   */
+  ~MessagePool();
+  /*!
+   * \brief Copy constructor is deleted.
+   */
+  MessagePool(const MessagePool&) = delete;
+  /*!
+   * \brief Assignment operator is deleted.
+   */
+  MessagePool& operator=(const MessagePool&) = delete;
+
+  /*!
+   * \brief Get a reset message of the given type.
+   * \param type The message type.
+   * \return The message; nullptr if the message type is not supported.
+   */
+  PoolPtr<Message> Acquire(accm::Header::MsgType type);
+  /*!
+   * \brief Get a reset message of the given type as its concrete class.
+   * \param type The message type. T must be the class implementing it.
+   * \return The message; nullptr if the message type is not supported.
+   */
+  template <typename T>
+  PoolPtr<T> Acquire(accm::Header::MsgType type) {
+    PoolPtr<Message> message = Acquire(type);
+    return PoolPtr<T>(static_cast<T*>(message.release()), PoolDeleter{this});
+  }
+  /*!
+   * \brief Get the number of idle messages of a type.
+   * \param type The message type.
+   * \return The number of idle messages.
+   */
+  std::size_t GetIdleCount(accm::Header::MsgType type) const;
+
+ private:
+  friend struct PoolDeleter;
+
+  struct FreeList {
+    mutable std::mutex mutex;
+    std::vector<Message*> messages;
+  };
+
+  static constexpr std::size_t kTypeCount =
+      static_cast<std::size_t>(accm::Header::MsgType::END_R01) + 1;
+
+  void Release(Message* message);
+
+ private:
+  std::size_t capacity_;
+  std::array<FreeList, kTypeCount> free_lists_;
+};
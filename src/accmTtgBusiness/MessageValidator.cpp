@@ -0,0 +1,384 @@
+#include "MessageValidator.h"
+#include <array>
+#include <charconv>
+#include <cstdlib>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include "AccmReflection.h"
+#include "Poct1Format.h"
+
+namespace {
+using namespace accm::reflection;
+
+///////////////////////////////////
+// Checks
+///////////////////////////////////
+constexpr const char* kMandatory = "is mandatory";
+constexpr const char* kUnknownCode = "is not a valid code";
+constexpr const char* kBadInterval = "is not an ordered numeric interval";
+
+template <typename T>
+bool IsEmpty(const T& value) {
+  if constexpr (std::is_arithmetic_v<T>) {
+    return value == 0;
+  } else if constexpr (std::is_base_of_v<accm::CV, T>) {
+    return value.code.empty();
+  } else {
+    return value.empty();
+  }
+}
+
+template <typename T>
+bool IsEmpty(const std::optional<T>& value) {
+  return !value || IsEmpty(*value);
+}
+
+template <typename E>
+bool IsKnownCode(const accm::CV& value) {
+  E parsed;
+  return value.code.empty() || value.code_set_id ||
+         FromCode(value.code.View(), parsed);
+}
+
+template <typename E, typename T>
+bool IsKnownCode(const std::optional<T>& value) {
+  return !value || IsKnownCode<E>(*value);
+}
+
+bool ParseBound(const std::optional<std::string>& bound, double& value) {
+  if (!bound) return true;
+  char* end = nullptr;
+  value = std::strtod(bound->c_str(), &end);
+  return end != bound->c_str() && *end == '\0';
+}
+
+bool IsOrdered(const std::optional<accm::IVL<std::string>>& interval) {
+  if (!interval) return true;
+  double low = 0;
+  double high = 0;
+  if (!ParseBound(interval->value_low, low) ||
+      !ParseBound(interval->value_high, high)) {
+    return false;
+  }
+  return !interval->value_low || !interval->value_high || low <= high;
+}
+
+template <typename T, auto Member>
+bool Mandatory(const T& object) {
+  return !IsEmpty(object.*Member);
+}
+
+template <typename T, auto Member, typename E>
+bool KnownCode(const T& object) {
+  return IsKnownCode<E>(object.*Member);
+}
+
+template <typename T, auto Member>
+bool OrderedInterval(const T& object) {
+  return IsOrdered(object.*Member);
+}
+
+///////////////////////////////////
+// Rule tables
+///////////////////////////////////
+/*!
+ * \brief A rule on a field of T.
+ */
+template <typename T>
+struct Rule {
+  /*!
+   * \brief POCT1-A name of the field, appended to the path on violation.
+   */
+  const char* field;
+  /*!
+   * \brief Description of the rule.
+   */
+  const char* rule;
+  /*!
+   * \brief The check; false if the rule is broken.
+   */
+  bool (*check)(const T&);
+};
+
+/*!
+ * \brief The rules of a struct. Structs without rules use this one.
+ */
+template <typename T>
+struct RuleTable {
+  static constexpr std::array<Rule<T>, 0> kRules{};
+};
+
+template <>
+struct RuleTable<accm::Header> {
+  using T = accm::Header;
+  static constexpr std::array<Rule<T>, 4> kRules{
+      {{"HDR.control_id", kMandatory, &Mandatory<T, &T::control_id>},
+       {"HDR.version_id", kMandatory, &Mandatory<T, &T::version_id>},
+       {"HDR.creation_dttm", kMandatory, &Mandatory<T, &T::creation_dttm>},
+       {"HDR.message_type", kMandatory, &Mandatory<T, &T::message_type>}}};
+};
+
+template <>
+struct RuleTable<accm::Ack> {
+  using T = accm::Ack;
+  static constexpr std::array<Rule<T>, 3> kRules{
+      {{"ACK.type_cd", kMandatory, &Mandatory<T, &T::type>},
+       {"ACK.type_cd", kUnknownCode, &KnownCode<T, &T::type, T::AckType>},
+       {"ACK.ack_control_id", kMandatory,
+        &Mandatory<T, &T::ack_control_id>}}};
+};
+
+template <>
+struct RuleTable<accm::Device> {
+  using T = accm::Device;
+  static constexpr std::array<Rule<T>, 1> kRules{
+      {{"DEV.device_id", kMandatory, &Mandatory<T, &T::device_id>}}};
+};
+
+template <>
+struct RuleTable<accm::DeviceStatus> {
+  using T = accm::DeviceStatus;
+  static constexpr std::array<Rule<T>, 2> kRules{
+      {{"DST.status_dttm", kMandatory, &Mandatory<T, &T::status_timestamp>},
+       {"DST.condition_cd", kUnknownCode,
+        &KnownCode<T, &T::condition, T::DeviceCondition>}}};
+};
+
+template <>
+struct RuleTable<accm::EndOfTopic> {
+  using T = accm::EndOfTopic;
+  static constexpr std::array<Rule<T>, 2> kRules{
+      {{"EOT.topic_cd", kMandatory, &Mandatory<T, &T::topic>},
+       {"EOT.topic_cd", kUnknownCode, &KnownCode<T, &T::topic, T::Code>}}};
+};
+
+template <>
+struct RuleTable<accm::Escape> {
+  using T = accm::Escape;
+  static constexpr std::array<Rule<T>, 3> kRules{
+      {{"ESC.esc_control_id", kMandatory,
+        &Mandatory<T, &T::esc_control_id>},
+       {"ESC.detail_cd", kMandatory, &Mandatory<T, &T::detail>},
+       {"ESC.detail_cd", kUnknownCode, &KnownCode<T, &T::detail, T::Code>}}};
+};
+
+template <>
+struct RuleTable<accm::Note> {
+  using T = accm::Note;
+  static constexpr std::array<Rule<T>, 1> kRules{
+      {{"NTE.text", kMandatory, &Mandatory<T, &T::text>}}};
+};
+
+template <>
+struct RuleTable<accm::Observation> {
+  using T = accm::Observation;
+  static constexpr std::array<Rule<T>, 7> kRules{
+      {{"OBS.observation_id", kMandatory, &Mandatory<T, &T::observation_id>},
+       {"OBS.qualitative_value", kUnknownCode,
+        &KnownCode<T, &T::qualitative_value, T::Qualitative>},
+       {"OBS.method_cd", kUnknownCode, &KnownCode<T, &T::method, T::Method>},
+       {"OBS.status_cd", kUnknownCode, &KnownCode<T, &T::status, T::Status>},
+       {"OBS.interpretation_cd", kUnknownCode,
+        &KnownCode<T, &T::interpretation, T::Interpretation>},
+       {"OBS.normal_lo-hi_limit", kBadInterval,
+        &OrderedInterval<T, &T::normal_lo_hi_limit>},
+       {"OBS.critical_lo-hi_limit", kBadInterval,
+        &OrderedInterval<T, &T::critical_lo_hi_limit>}}};
+};
+
+template <>
+struct RuleTable<accm::Operator> {
+  using T = accm::Operator;
+  static constexpr std::array<Rule<T>, 1> kRules{
+      {{"OPR.operator_id", kMandatory, &Mandatory<T, &T::operator_id>}}};
+};
+
+template <>
+struct RuleTable<accm::Patient> {
+  using T = accm::Patient;
+  static constexpr std::array<Rule<T>, 2> kRules{
+      {{"PT.patient_id", kMandatory, &Mandatory<T, &T::patient_id>},
+       {"PT.gender_cd", kUnknownCode, &KnownCode<T, &T::gender, T::Gender>}}};
+};
+
+template <>
+struct RuleTable<accm::Request> {
+  using T = accm::Request;
+  static constexpr std::array<Rule<T>, 2> kRules{
+      {{"REQ.request_cd", kMandatory, &Mandatory<T, &T::type>},
+       {"REQ.request_cd", kUnknownCode, &KnownCode<T, &T::type, T::Type>}}};
+};
+
+template <>
+struct RuleTable<accm::Specimen> {
+  using T = accm::Specimen;
+  static constexpr std::array<Rule<T>, 2> kRules{
+      {{"SPC.source_cd", kUnknownCode, &KnownCode<T, &T::source, T::Source>},
+       {"SPC.type_cd", kUnknownCode, &KnownCode<T, &T::type, T::Type>}}};
+};
+
+template <>
+struct RuleTable<accm::Service> {
+  using T = accm::Service;
+  static constexpr std::array<Rule<T>, 6> kRules{
+      {{"SVC.observation_uid", kMandatory,
+        &Mandatory<T, &T::observation_uid>},
+       {"SVC.role_cd", kMandatory, &Mandatory<T, &T::role>},
+       {"SVC.role_cd", kUnknownCode, &KnownCode<T, &T::role, T::Role>},
+       {"SVC.observation_dttm", kMandatory,
+        &Mandatory<T, &T::observation_dttm>},
+       {"SVC.status_cd", kUnknownCode, &KnownCode<T, &T::status, T::Status>},
+       {"SVC.reason_cd", kUnknownCode,
+        &KnownCode<T, &T::reason, T::Reason>}}};
+};
+
+template <>
+struct RuleTable<accm::Terminate> {
+  using T = accm::Terminate;
+  static constexpr std::array<Rule<T>, 2> kRules{
+      {{"TRM.reason_cd", kMandatory, &Mandatory<T, &T::reason>},
+       {"TRM.reason_cd", kUnknownCode, &KnownCode<T, &T::reason, T::Reason>}}};
+};
+
+///////////////////////////////////
+// Traversal
+///////////////////////////////////
+/*!
+ * \brief Validation state: the path of the current element and the
+ * violations found so far.
+ */
+struct Context {
+  void Report(std::string_view field, const char* rule) {
+    Violation& violation = violations.emplace_back();
+    violation.path = path;
+    if (!field.empty()) violation.path.append("/").append(field);
+    violation.rule = rule;
+  }
+  std::size_t Enter(std::string_view name) {
+    std::size_t size = path.size();
+    path.append("/").append(name);
+    return size;
+  }
+  std::size_t Enter(std::string_view name, std::size_t index) {
+    std::size_t size = Enter(name);
+    char digits[20];
+    auto result = std::to_chars(digits, digits + sizeof(digits), index);
+    path.append("[").append(digits, result.ptr - digits).append("]");
+    return size;
+  }
+  void Leave(std::size_t size) { path.resize(size); }
+
+  std::string& path;
+  std::vector<Violation>& violations;
+};
+
+template <typename M>
+void ValidateMember(Context& ctx, std::string_view name, const M& member);
+
+template <typename T>
+void ValidateObject(Context& ctx, const T& object) {
+  for (const Rule<T>& rule : RuleTable<T>::kRules) {
+    if (!rule.check(object)) ctx.Report(rule.field, rule.rule);
+  }
+  ForEachField<T>([&](const auto& field) {
+    if constexpr (std::decay_t<decltype(field)>::kSerialized) {
+      ValidateMember(ctx, field.name, field.Get(object));
+    }
+  });
+}
+
+template <typename M>
+void ValidateMember(Context& ctx, std::string_view name, const M& member) {
+  if constexpr (IsOptional<M>::value) {
+    if (member) ValidateMember(ctx, name, *member);
+  } else if constexpr (IsSequence<M>::value) {
+    if constexpr (IsComposite<typename M::value_type>::value) {
+      std::size_t index = 0;
+      for (const auto& item : member) {
+        std::size_t size = ctx.Enter(name, index++);
+        ValidateObject(ctx, item);
+        ctx.Leave(size);
+      }
+    }
+  } else if constexpr (IsComposite<M>::value) {
+    std::size_t size = ctx.Enter(name);
+    ValidateObject(ctx, member);
+    ctx.Leave(size);
+  }
+}
+
+template <typename Body>
+void ValidateBody(Context& ctx, const Message& message) {
+  using Traits = MessageBodyTraits<Body>;
+  const Body* body =
+      Traits::Get(static_cast<const typename Traits::Class&>(message));
+  if (!body) {
+    ctx.Report(FieldTable<Body>::kTag, "is malformed");
+    return;
+  }
+  ValidateMember(ctx, FieldTable<Body>::kTag, *body);
+}
+
+template <typename Entry>
+void ValidateList(Context& ctx, const Message& message) {
+  using Traits = MessageListTraits<Entry>;
+  ValidateMember(
+      ctx, FieldTable<Entry>::kTag,
+      *Traits::Get(static_cast<const typename Traits::Class&>(message)));
+}
+
+void ValidateBody(Context& ctx, const Message& message) {
+  switch (message.GetMessageType()) {
+    case accm::Header::MsgType::ACK_R01:
+      return ValidateBody<accm::Ack>(ctx, message);
+    case accm::Header::MsgType::DST_R01:
+      return ValidateBody<accm::DeviceStatus>(ctx, message);
+    case accm::Header::MsgType::ESC_R01:
+      return ValidateBody<accm::Escape>(ctx, message);
+    case accm::Header::MsgType::EOT_R01:
+      return ValidateBody<accm::EndOfTopic>(ctx, message);
+    case accm::Header::MsgType::HEL_R01:
+      return ValidateBody<accm::Device>(ctx, message);
+    case accm::Header::MsgType::OBS_R01:
+    case accm::Header::MsgType::OBS_R02:
+      return ValidateBody<accm::Service>(ctx, message);
+    case accm::Header::MsgType::OPL_R01:
+    case accm::Header::MsgType::OPL_R02:
+      return ValidateList<accm::Operator>(ctx, message);
+    case accm::Header::MsgType::PTL_R01:
+    case accm::Header::MsgType::PTL_R02:
+      return ValidateList<accm::Patient>(ctx, message);
+    case accm::Header::MsgType::REQ_R01:
+      return ValidateBody<accm::Request>(ctx, message);
+    case accm::Header::MsgType::END_R01:
+      return ValidateBody<accm::Terminate>(ctx, message);
+    default:
+      ctx.Report("", "is not a supported message type");
+      return;
+  }
+}
+}  // namespace
+
+bool MessageValidator::Validate(const Message& message) {
+  violations_.clear();
+  path_.assign(poct1::GetRootName(message.GetMessageType()));
+  Context ctx{path_, violations_};
+  ValidateMember(ctx, FieldTable<accm::Header>::kTag, *message.GetHeader());
+  ValidateBody(ctx, message);
+  return violations_.empty();
+}
+
+bool MessageValidator::Validate(const MessageVariant& message) {
+  violations_.clear();
+  path_.assign(poct1::GetRootName(message.type));
+  Context ctx{path_, violations_};
+  ValidateMember(ctx, FieldTable<accm::Header>::kTag, message.header);
+  std::visit(
+      [&](const auto& body) {
+        using Body = std::decay_t<decltype(body)>;
+        ValidateMember(ctx, FieldTable<Body>::kTag, body);
+      },
+      message.body);
+  return violations_.empty();
+}
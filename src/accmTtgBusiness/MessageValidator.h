@@ -0,0 +1,72 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "Message.h"
+#include "MessageVariant.h"
+
+/*!
+ * \brief A POCT1-A rule broken by a message.
+ */
+struct Violation {
+  /*!
+   * \brief Path of the offending field, made of the POCT1-A element names
+   * from the root (e.g. "OBS.R01/SVC/OBS[2]/OBS.method_cd").
+   */
+  std::string path;
+  /*!
+   * \brief Description of the rule (e.g. "is mandatory").
+   */
+  std::string rule;
+};
+
+/*!
+ * \brief The MessageValidator class checks messages against the POCT1-A
+ * cardinality and code rules.
+ *
+ * The rules are kept in flat constant tables, one per struct of the accm::
+ * model, each rule being a field name, a description and a check function;
+ * the validator runs the table of every struct reached from the message
+ * through the reflection tables (see AccmReflection.h). Every violation is
+ * reported, not only the first one. Valid messages do not allocate once the
+ * validator is warmed up, so it can be left enabled on every inbound message.
+ *
+ * Codes are checked against the POCT1-A tables unless their CV names another
+ * code system (code_set_id). Empty optional codes are not checked.
+ */
+class MessageValidator {
+ public:
+  /*!
+   * \brief Default constructor.
+   */
+  MessageValidator() = default;
+  /*!
+   * \brief Default destructor.
+   */
+  ~MessageValidator() = default;
+  /*!
+   * \brief Check a message. A lazily decoded OBS body is decoded.
+   * \param message The message to check.
+   * \return true if the message breaks no rule; false otherwise.
+   * \see GetViolations
+   */
+  bool Validate(const Message& message);
+  /*!
+   * \brief Check a MessageVariant.
+   * \param message The message to check.
+   * \return true if the message breaks no rule; false otherwise.
+   * \see GetViolations
+   */
+  bool Validate(const MessageVariant& message);
+  /*!
+   * \brief Get the rules broken by the message given to the last call to
+   * Validate.
+   * \return The violations, in message order.
+   */
+  inline const std::vector<Violation>& GetViolations() const {
+    return violations_;
+  }
+
+ private:
+  std::vector<Violation> violations_;
+  std::string path_;
+};
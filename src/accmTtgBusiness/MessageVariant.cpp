@@ -0,0 +1,104 @@
+#include "MessageVariant.h"
+#include <type_traits>
+
+namespace {
+template <typename Body>
+bool CopyBody(const Message& message, MessageVariant::Body& body) {
+  using Traits = MessageBodyTraits<Body>;
+  const auto& concrete = static_cast<const typename Traits::Class&>(message);
+  const Body* source = Traits::Get(concrete);
+  if (!source) return false;
+  body.emplace<Body>(*source);
+  return true;
+}
+}  // namespace
+
+bool EmplaceBody(accm::Header::MsgType type, MessageVariant::Body& body) {
+  using MsgType = accm::Header::MsgType;
+  switch (type) {
+    case MsgType::ACK_R01:
+      body.emplace<accm::Ack>();
+      return true;
+    case MsgType::DST_R01:
+      body.emplace<accm::DeviceStatus>();
+      return true;
+    case MsgType::ESC_R01:
+      body.emplace<accm::Escape>();
+      return true;
+    case MsgType::EOT_R01:
+      body.emplace<accm::EndOfTopic>();
+      return true;
+    case MsgType::HEL_R01:
+      body.emplace<accm::Device>();
+      return true;
+    case MsgType::OBS_R01:
+    case MsgType::OBS_R02:
+      body.emplace<accm::Service>();
+      return true;
+    case MsgType::REQ_R01:
+      body.emplace<accm::Request>();
+      return true;
+    case MsgType::END_R01:
+      body.emplace<accm::Terminate>();
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool ToVariant(const Message& message, MessageVariant& variant) {
+  using MsgType = accm::Header::MsgType;
+  switch (message.GetMessageType()) {
+    case MsgType::ACK_R01:
+      if (!CopyBody<accm::Ack>(message, variant.body)) return false;
+      break;
+    case MsgType::DST_R01:
+      if (!CopyBody<accm::DeviceStatus>(message, variant.body)) return false;
+      break;
+    case MsgType::ESC_R01:
+      if (!CopyBody<accm::Escape>(message, variant.body)) return false;
+      break;
+    case MsgType::EOT_R01:
+      if (!CopyBody<accm::EndOfTopic>(message, variant.body)) return false;
+      break;
+    case MsgType::HEL_R01:
+      if (!CopyBody<accm::Device>(message, variant.body)) return false;
+      break;
+    case MsgType::OBS_R01:
+    case MsgType::OBS_R02:
+      if (!CopyBody<accm::Service>(message, variant.body)) return false;
+      break;
+    case MsgType::REQ_R01:
+      if (!CopyBody<accm::Request>(message, variant.body)) return false;
+      break;
+    case MsgType::END_R01:
+      if (!CopyBody<accm::Terminate>(message, variant.body)) return false;
+      break;
+    default:
+      return false;
+  }
+  variant.type = message.GetMessageType();
+  variant.header = *message.GetHeader();
+  return true;
+}
+
+std::unique_ptr<Message> ToMessage(MessageVariant&& variant) {
+  std::unique_ptr<Message> message = std::visit(
+      [&](auto& body) -> std::unique_ptr<Message> {
+        using Body = std::decay_t<decltype(body)>;
+        using Traits = MessageBodyTraits<Body>;
+        std::unique_ptr<typename Traits::Class> concrete;
+        if constexpr (std::is_same_v<Body, accm::Service>) {
+          concrete = std::make_unique<MessageObservations>(
+              variant.type == accm::Header::MsgType::OBS_R01);
+        } else {
+          concrete = std::make_unique<typename Traits::Class>();
+        }
+        Traits::Set(*concrete, std::move(body));
+        return concrete;
+      },
+      variant.body);
+  std::string control_id = std::move(variant.header.control_id);
+  message->SetHeader(std::move(variant.header), std::move(control_id));
+  return message;
+}
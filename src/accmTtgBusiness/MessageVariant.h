@@ -0,0 +1,155 @@
+#pragma once
+#include <memory>
+#include <variant>
+#include "Message.h"
+
+/*!
+ * \brief The MessageVariant struct is a closed, value-type representation of
+ * the messages of the Message hierarchy.
+ *
+ * The body is a std::variant over the body structs, so the code handling a
+ * message is selected with std::visit instead of GetMessageType() and a
+ * downcast, and the compiler can inline through the dispatch. Both
+ * representations are interchangeable (see ToVariant and ToMessage), and the
+ * codecs accept either.
+ */
+struct MessageVariant {
+  /*!
+   * \brief The body of the supported messages.
+   */
+  using Body = std::variant<accm::Ack, accm::DeviceStatus, accm::Escape,
+                            accm::EndOfTopic, accm::Device, accm::Service,
+                            accm::Request, accm::Terminate>;
+
+  /*!
+   * \brief The message type. The body alternative always matches it; it is
+   * kept apart because accm::Service is the body of both OBS.R01 and OBS.R02.
+   */
+  accm::Header::MsgType type = accm::Header::MsgType::ACK_R01;
+  /*!
+   * \brief The header.
+   */
+  accm::Header header;
+  /*!
+   * \brief The body.
+   */
+  Body body;
+};
+
+/*!
+ * \brief Mapping between a body struct and the Message subclass holding it:
+ * Class, and the Get/Set accessors of the body. Only specializations are
+ * defined.
+ */
+template <typename Body>
+struct MessageBodyTraits;
+
+template <>
+struct MessageBodyTraits<accm::Ack> {
+  using Class = MessageAck;
+  static const accm::Ack* Get(const Class& message) {
+    return message.GetAck();
+  }
+  static void Set(Class& message, accm::Ack&& body) {
+    message.SetAck(std::move(body));
+  }
+};
+
+template <>
+struct MessageBodyTraits<accm::DeviceStatus> {
+  using Class = MessageDeviceStatus;
+  static const accm::DeviceStatus* Get(const Class& message) {
+    return message.GetDeviceStatus();
+  }
+  static void Set(Class& message, accm::DeviceStatus&& body) {
+    message.SetDeviceStatus(std::move(body));
+  }
+};
+
+template <>
+struct MessageBodyTraits<accm::Escape> {
+  using Class = MessageEscape;
+  static const accm::Escape* Get(const Class& message) {
+    return message.GetEscape();
+  }
+  static void Set(Class& message, accm::Escape&& body) {
+    message.SetEscape(std::move(body));
+  }
+};
+
+template <>
+struct MessageBodyTraits<accm::EndOfTopic> {
+  using Class = MessageEndOfTopic;
+  static const accm::EndOfTopic* Get(const Class& message) {
+    return message.GetEndOfTopic();
+  }
+  static void Set(Class& message, accm::EndOfTopic&& body) {
+    message.SetEndOfTopic(std::move(body));
+  }
+};
+
+template <>
+struct MessageBodyTraits<accm::Device> {
+  using Class = MessageHello;
+  static const accm::Device* Get(const Class& message) {
+    return message.GetDevice();
+  }
+  static void Set(Class& message, accm::Device&& body) {
+    message.SetDevice(std::move(body));
+  }
+};
+
+template <>
+struct MessageBodyTraits<accm::Service> {
+  using Class = MessageObservations;
+  static const accm::Service* Get(const Class& message) {
+    return message.GetService();
+  }
+  static void Set(Class& message, accm::Service&& body) {
+    message.SetService(std::move(body));
+  }
+};
+
+template <>
+struct MessageBodyTraits<accm::Request> {
+  using Class = MessageRequest;
+  static const accm::Request* Get(const Class& message) {
+    return message.GetRequest();
+  }
+  static void Set(Class& message, accm::Request&& body) {
+    message.SetRequest(std::move(body));
+  }
+};
+
+template <>
+struct MessageBodyTraits<accm::Terminate> {
+  using Class = MessageTerminate;
+  static const accm::Terminate* Get(const Class& message) {
+    return message.GetTerminate();
+  }
+  static void Set(Class& message, accm::Terminate&& body) {
+    message.SetTerminate(std::move(body));
+  }
+};
+
+/*!
+ * \brief Select the body alternative of a message type.
+ * \param type The message type.
+ * \param body The body to reset to a default-constructed alternative.
+ * \return true if the message type is supported; false otherwise.
+ */
+bool EmplaceBody(accm::Header::MsgType type, MessageVariant::Body& body);
+/*!
+ * \brief Copy a message into a MessageVariant.
+ * \param message The message to copy.
+ * \param variant Output variant.
+ * \return true on success; false if the message type is not supported or
+ * its lazily decoded body is malformed.
+ */
+bool ToVariant(const Message& message, MessageVariant& variant);
+/*!
+ * \brief Turn a MessageVariant into a message of the Message hierarchy.
+ * \param variant The variant to move from.
+ * \return The message.
+ */
+std::unique_ptr<Message> ToMessage(MessageVariant&& variant);
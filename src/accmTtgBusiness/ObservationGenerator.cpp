@@ -0,0 +1,198 @@
+#include "ObservationGenerator.h"
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <string_view>
+#include <utility>
+#include "SplitMix64.h"
+
+namespace {
+/*!
+ * \brief Seed of the stream of an item (service, patient) of a run.
+ */
+std::uint64_t StreamSeed(std::uint64_t seed, std::uint64_t stream,
+                         std::uint64_t item) {
+  return SplitMix64(seed ^ (stream * 0xd1b54a32d192ed03ULL) ^
+                    (item * 0x9e3779b97f4a7c15ULL))
+      .Next();
+}
+
+constexpr std::uint64_t kServiceStream = 1;
+constexpr std::uint64_t kPatientStream = 2;
+
+constexpr std::array<double, 7> kScales{1, 10, 100, 1000, 1e4, 1e5, 1e6};
+
+const accm::CV kRole("OBS");
+const accm::CV kServiceStatus("NRM");
+const accm::CV kReason("NEW");
+const accm::CV kMethod("M");
+const accm::CV kObservationStatus("A");
+
+constexpr std::size_t kNormal = 0;
+constexpr std::size_t kLow = 1;
+constexpr std::size_t kHigh = 2;
+constexpr std::size_t kLowLow = 3;
+constexpr std::size_t kHighHigh = 4;
+const std::array<accm::CV, 5> kInterpretations{
+    accm::CV("N"), accm::CV("L"), accm::CV("H"), accm::CV("LL"),
+    accm::CV("HH")};
+
+const std::array<accm::CE, 5> kSpecimenTypes{
+    accm::CE("BLD"), accm::CE("BLDA"), accm::CE("BLDV"), accm::CE("SER"),
+    accm::CE("PLAS")};
+
+void AssignFixed(std::string& text, double value, int decimals) {
+  char digits[48];
+  auto result = std::to_chars(digits, digits + sizeof(digits), value,
+                              std::chars_format::fixed, decimals);
+  text.assign(digits, result.ptr - digits);
+}
+
+/*!
+ * \brief Draw a value of an analyte, rounded to its decimals, and its
+ * interpretation (index in kInterpretations).
+ */
+double DrawValue(SplitMix64& random, const Analyte& analyte,
+                 double abnormal_rate, std::size_t& interpretation) {
+  double value;
+  if (random.Uniform() < abnormal_rate) {
+    bool critical = random.Uniform() < 0.2;
+    if (random.Below(2) == 0) {
+      double span = analyte.normal_low - analyte.critical_low;
+      value = critical ? random.Uniform(analyte.critical_low - span,
+                                        analyte.critical_low)
+                       : random.Uniform(analyte.critical_low,
+                                        analyte.normal_low);
+      if (value < 0 && analyte.critical_low >= 0) value = 0;
+    } else {
+      double span = analyte.critical_high - analyte.normal_high;
+      value = critical ? random.Uniform(analyte.critical_high,
+                                        analyte.critical_high + span)
+                       : random.Uniform(analyte.normal_high,
+                                        analyte.critical_high);
+    }
+  } else {
+    double mid = (analyte.normal_low + analyte.normal_high) / 2;
+    double sigma = (analyte.normal_high - analyte.normal_low) / 6;
+    value = mid + random.Normal() * sigma;
+    if (value < analyte.normal_low) value = analyte.normal_low;
+    if (value > analyte.normal_high) value = analyte.normal_high;
+  }
+  double scale = kScales[analyte.decimals];
+  value = std::round(value * scale) / scale;
+
+  if (value < analyte.critical_low) {
+    interpretation = kLowLow;
+  } else if (value < analyte.normal_low) {
+    interpretation = kLow;
+  } else if (value > analyte.critical_high) {
+    interpretation = kHighHigh;
+  } else if (value > analyte.normal_high) {
+    interpretation = kHigh;
+  } else {
+    interpretation = kNormal;
+  }
+  return value;
+}
+
+void FillPatient(std::uint64_t seed, std::uint32_t number,
+                 accm::Patient& patient) {
+  SplitMix64 random(StreamSeed(seed, kPatientStream, number));
+  char digits[10];
+  auto result = std::to_chars(digits, digits + sizeof(digits), number);
+  std::size_t length = result.ptr - digits;
+  patient.patient_id.assign("P");
+  patient.patient_id.append(length < 7 ? 7 - length : 0, '0');
+  patient.patient_id.append(digits, length);
+
+  std::tm birth{};
+  birth.tm_year = 30 + static_cast<int>(random.Below(90));
+  birth.tm_mon = static_cast<int>(random.Below(12));
+  birth.tm_mday = 1 + static_cast<int>(random.Below(28));
+  patient.birth_date = birth;
+  patient.gender = accm::CV(random.Below(2) == 0 ? "F" : "M");
+}
+}  // namespace
+
+ObservationGenerator::ObservationGenerator(std::vector<Analyte> analytes,
+                                           const Options& options)
+    : analytes_(std::move(analytes)), options_(options) {
+  limits_.resize(analytes_.size());
+  for (std::size_t i = 0; i < analytes_.size(); ++i) {
+    Analyte& analyte = analytes_[i];
+    if (analyte.decimals < 0) analyte.decimals = 0;
+    if (analyte.decimals >= static_cast<int>(kScales.size())) {
+      analyte.decimals = static_cast<int>(kScales.size()) - 1;
+    }
+    Limits& limits = limits_[i];
+    limits.normal.closed_low = limits.normal.closed_high = true;
+    limits.normal.value_low.emplace();
+    limits.normal.value_high.emplace();
+    AssignFixed(*limits.normal.value_low, analyte.normal_low,
+                analyte.decimals);
+    AssignFixed(*limits.normal.value_high, analyte.normal_high,
+                analyte.decimals);
+    limits.normal.unit = analyte.unit;
+    limits.critical = limits.normal;
+    AssignFixed(*limits.critical.value_low, analyte.critical_low,
+                analyte.decimals);
+    AssignFixed(*limits.critical.value_high, analyte.critical_high,
+                analyte.decimals);
+  }
+}
+
+std::vector<Analyte> ObservationGenerator::GetDefaultAnalytes() {
+  return {{accm::CE("2744-1"), "[pH]", 7.35, 7.45, 7.2, 7.6, 2},
+          {accm::CE("2019-8"), "mm[Hg]", 35, 45, 20, 70, 1},
+          {accm::CE("2703-7"), "mm[Hg]", 80, 100, 40, 150, 1},
+          {accm::CE("2947-0"), "mmol/L", 135, 145, 120, 160, 0},
+          {accm::CE("6298-4"), "mmol/L", 3.5, 5.1, 2.8, 6.2, 1},
+          {accm::CE("2069-3"), "mmol/L", 98, 107, 80, 120, 0},
+          {accm::CE("2339-0"), "mg/dL", 70, 110, 40, 400, 0}};
+}
+
+void ObservationGenerator::Generate(std::uint64_t index,
+                                    accm::Service& service) const {
+  SplitMix64 random(StreamSeed(options_.seed, kServiceStream, index));
+
+  char uid[44];
+  char* end = std::to_chars(uid, uid + 20, options_.seed).ptr;
+  *end++ = '-';
+  end = std::to_chars(end, uid + sizeof(uid), index).ptr;
+  service.observation_uid.code = accm::Code(std::string_view(uid, end - uid));
+  service.role = kRole;
+  service.status = kServiceStatus;
+  service.reason = kReason;
+  service.observation_dttm =
+      options_.start_time + static_cast<time_t>(index) * options_.interval;
+
+  if (!service.patient) service.patient.emplace();
+  std::uint32_t patient_count = options_.patient_count ? options_.patient_count
+                                                       : 1;
+  FillPatient(options_.seed, random.Below(patient_count), *service.patient);
+
+  if (!service.specimen) service.specimen.emplace();
+  service.specimen->type = kSpecimenTypes[random.Below(kSpecimenTypes.size())];
+  service.specimen->specimen_dttm =
+      service.observation_dttm - static_cast<time_t>(random.Below(600));
+
+  service.observations.resize(analytes_.size());
+  for (std::size_t i = 0; i < analytes_.size(); ++i) {
+    const Analyte& analyte = analytes_[i];
+    accm::Observation& observation = service.observations[i];
+    std::size_t interpretation = 0;
+    double value =
+        DrawValue(random, analyte, options_.abnormal_rate, interpretation);
+
+    observation.observation_id = analyte.id;
+    if (!observation.value) observation.value.emplace();
+    if (!observation.value->value) observation.value->value.emplace();
+    AssignFixed(*observation.value->value, value, analyte.decimals);
+    observation.value->unit = analyte.unit;
+    observation.method = kMethod;
+    observation.status = kObservationStatus;
+    observation.interpretation = kInterpretations[interpretation];
+    observation.normal_lo_hi_limit = limits_[i].normal;
+    observation.critical_lo_hi_limit = limits_[i].critical;
+  }
+}
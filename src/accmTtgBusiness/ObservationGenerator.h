@@ -0,0 +1,118 @@
+#pragma once
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <vector>
+#include "AccmDefinitions.h"
+
+/*!
+ * \brief The definition of an analyte produced by the ObservationGenerator.
+ */
+struct Analyte {
+  /*!
+   * \brief The observation id (e.g. "2947-0" in LOINC).
+   */
+  accm::CE id;
+  /*!
+   * \brief The unit of the values.
+   */
+  std::string unit;
+  /*!
+   * \brief The normal range. Most values are drawn from it.
+   */
+  double normal_low = 0;
+  double normal_high = 0;
+  /*!
+   * \brief The critical (panic) limits, around the normal range.
+   */
+  double critical_low = 0;
+  double critical_high = 0;
+  /*!
+   * \brief Number of decimals of the values.
+   */
+  int decimals = 2;
+};
+
+/*!
+ * \brief The ObservationGenerator class produces synthetic OBS.R01 bodies:
+ * a Service with its Patient, Specimen and one Observation per analyte.
+ *
+ * Service number 'index' is a pure function of the seed and the index: it
+ * is drawn from its own pseudo-random stream, so services can be generated in
+ * any order, and ranges of indexes can be spread over threads, while the
+ * output stays the same bit for bit. The generator does not use the standard
+ * distributions, whose results differ between standard libraries, and only
+ * exactly rounded libm functions (std::round). Patients are drawn from a
+ * fixed population, each patient keeping the same demographics in every
+ * service.
+ *
+ * Generate is const and may be called concurrently. Services are filled in
+ * place, so reusing the same Service (e.g. one per thread) avoids most
+ * allocations.
+ */
+class ObservationGenerator {
+ public:
+  /*!
+   * \brief Generation settings.
+   */
+  struct Options {
+    /*!
+     * \brief The seed. The same seed and analytes give the same services.
+     */
+    std::uint64_t seed = 1;
+    /*!
+     * \brief The size of the patient population.
+     */
+    std::uint32_t patient_count = 1000;
+    /*!
+     * \brief The share of values drawn outside the normal range.
+     */
+    double abnormal_rate = 0.1;
+    /*!
+     * \brief The observation time of service 0.
+     */
+    time_t start_time = 0;
+    /*!
+     * \brief The time between two consecutive services, in seconds.
+     */
+    time_t interval = 1;
+  };
+
+  /*!
+   * \brief Constructor.
+   * \param analytes The analytes of every service, in order.
+   * \param options The generation settings.
+   */
+  ObservationGenerator(std::vector<Analyte> analytes, const Options& options);
+  /*!
+   * \brief Get a blood gas and electrolyte panel, e.g. for simulations
+   * without a configured list of analytes.
+   * \return The analytes, identified by their LOINC codes.
+   */
+  static std::vector<Analyte> GetDefaultAnalytes();
+
+  /*!
+   * \brief Fill a service.
+   * \param index The number of the service.
+   * \param service Output service. It must be default-constructed or have
+   * been filled by a previous call; fields the generator does not set are
+   * left untouched.
+   */
+  void Generate(std::uint64_t index, accm::Service& service) const;
+  /*!
+   * \brief Get the analytes.
+   * \return The analytes.
+   */
+  inline const std::vector<Analyte>& GetAnalytes() const { return analytes_; }
+
+ private:
+  struct Limits {
+    accm::IVL<std::string> normal;
+    accm::IVL<std::string> critical;
+  };
+
+ private:
+  std::vector<Analyte> analytes_;
+  std::vector<Limits> limits_;
+  Options options_;
+};
@@ -0,0 +1,72 @@
+#pragma once
+#include <string_view>
+#include "AccmDefinitions.h"
+
+/*!
+ * \brief Wire-level names shared by the POCT1-A encoder and decoder.
+ */
+namespace poct1 {
+/*!
+ * \brief Get the root element name of a message type.
+ * \param type The message type.
+ * \return The root element name (e.g. "ACK.R01").
+ */
+inline std::string_view GetRootName(accm::Header::MsgType type) {
+  using MsgType = accm::Header::MsgType;
+  switch (type) {
+    case MsgType::REQ_R01:
+      return "REQ.R01";
+    case MsgType::ACK_R01:
+      return "ACK.R01";
+    case MsgType::HEL_R01:
+      return "HEL.R01";
+    case MsgType::OBS_R01:
+      return "OBS.R01";
+    case MsgType::OBS_R02:
+      return "OBS.R02";
+    case MsgType::EVS_R01:
+      return "EVS.R01";
+    case MsgType::DST_R01:
+      return "DST.R01";
+    case MsgType::DTV_R01:
+      return "DTV.R01";
+    case MsgType::DTV_R02:
+      return "DTV.R02";
+    case MsgType::DTV_VENDOR:
+      return "DTV.VENDOR";
+    case MsgType::OPL_R01:
+      return "OPL.R01";
+    case MsgType::OPL_R02:
+      return "OPL.R02";
+    case MsgType::PTL_R01:
+      return "PTL.R01";
+    case MsgType::PTL_R02:
+      return "PTL.R02";
+    case MsgType::EOT_R01:
+      return "EOT.R01";
+    case MsgType::ESC_R01:
+      return "ESC.R01";
+    case MsgType::END_R01:
+      return "END.R01";
+  }
+  return "";
+}
+
+/*!
+ * \brief Get the message type from a root element name.
+ * \param name The root element name (e.g. "ACK.R01").
+ * \param type Output message type.
+ * \return true if the name is a known message type; false otherwise.
+ */
+inline bool ParseRootName(std::string_view name, accm::Header::MsgType& type) {
+  for (int i = static_cast<int>(accm::Header::MsgType::REQ_R01);
+       i <= static_cast<int>(accm::Header::MsgType::END_R01); ++i) {
+    auto candidate = static_cast<accm::Header::MsgType>(i);
+    if (GetRootName(candidate) == name) {
+      type = candidate;
+      return true;
+    }
+  }
+  return false;
+}
+}  // namespace poct1
@@ -0,0 +1,5 @@
+#include "Roster.h"
+
+// The rosters of the OPL.* and PTL.* topics, declared extern in Roster.h.
+template class Roster<accm::Operator>;
+template class Roster<accm::Patient>;
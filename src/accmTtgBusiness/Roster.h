@@ -0,0 +1,220 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "AccmReflection.h"
+#include "Message.h"
+
+/*!
+ * \brief Entry-specific parts of a Roster: the key identifying an entry and
+ * the entry sent to delete it. Only specializations are defined.
+ */
+template <typename Entry>
+struct RosterTraits;
+
+template <>
+struct RosterTraits<accm::Operator> {
+  using Key = accm::Code;
+  static const Key& GetKey(const accm::Operator& entry) {
+    return entry.operator_id.code;
+  }
+  static accm::Operator MakeRemoval(const accm::Operator& entry) {
+    accm::Operator removal;
+    removal.operator_id = entry.operator_id;
+    removal.action = accm::Operator::Action::D;
+    return removal;
+  }
+};
+
+template <>
+struct RosterTraits<accm::Patient> {
+  using Key = std::string;
+  static const Key& GetKey(const accm::Patient& entry) {
+    return entry.patient_id;
+  }
+  static accm::Patient MakeRemoval(const accm::Patient& entry) {
+    accm::Patient removal;
+    removal.patient_id = entry.patient_id;
+    removal.action = accm::Patient::Action::D;
+    return removal;
+  }
+};
+
+/*!
+ * \brief The Roster class keeps the operator or patient list of a device in
+ * memory, indexed by operator or patient ID, and produces the incremental
+ * (R02) updates of that list.
+ *
+ * Two states are kept: the current list, which the incremental messages and
+ * the single-entry edits update in O(changes), and the published list, i.e.
+ * the list as of the last update acknowledged by the device (see Commit). The
+ * keys changed since then are tracked, so GetDelta only compares those entries
+ * against the published list, with accm::reflection::Equal, instead of walking
+ * the whole roster. Entries that were changed and then changed back do not
+ * show up in the delta.
+ *
+ * The entries are stored without their action. A Roster is not thread safe.
+ */
+template <typename Entry>
+class Roster {
+ public:
+  using Key = typename RosterTraits<Entry>::Key;
+  using Action = typename Entry::Action;
+
+  /*!
+   * \brief Default constructor. Both lists are empty.
+   */
+  Roster() = default;
+
+  /*!
+   * \brief Get the number of entries in the current list.
+   * \return The number of entries.
+   */
+  inline std::size_t Size() const { return current_.size(); }
+  /*!
+   * \brief Check if the current list differs from the published one.
+   * \return true if some entry was changed since the last Commit; false
+   * otherwise. An entry changed back to its published value counts as a
+   * change.
+   */
+  inline bool HasChanges() const { return !changed_.empty(); }
+  /*!
+   * \brief Find an entry of the current list.
+   * \param key The operator or patient ID.
+   * \return The entry; nullptr if there is none with that key.
+   */
+  inline const Entry* Find(const Key& key) const {
+    auto it = current_.find(key);
+    return it != current_.end() ? &it->second : nullptr;
+  }
+
+  /*!
+   * \brief Insert an entry in the current list, or replace the one with the
+   * same key.
+   * \param entry The entry to move from. Its action is ignored.
+   */
+  void Insert(Entry entry) {
+    entry.action.reset();
+    Key key = RosterTraits<Entry>::GetKey(entry);
+    changed_.insert(key);
+    current_.insert_or_assign(key, std::move(entry));
+  }
+  /*!
+   * \brief Remove an entry from the current list.
+   * \param key The operator or patient ID.
+   */
+  void Erase(const Key& key) {
+    if (current_.erase(key) != 0) changed_.insert(key);
+  }
+  /*!
+   * \brief Apply the entries of an incremental list: entries whose action is
+   * D are removed, the others are inserted or replaced.
+   * \param entries The entries.
+   */
+  void ApplyIncremental(const std::vector<Entry>& entries) {
+    for (const Entry& entry : entries) {
+      if (entry.action == Action::D) {
+        Erase(RosterTraits<Entry>::GetKey(entry));
+      } else {
+        Insert(entry);
+      }
+    }
+  }
+  /*!
+   * \brief Replace the current list with a complete list.
+   * \param entries The entries.
+   */
+  void ApplyComplete(const std::vector<Entry>& entries) {
+    for (const auto& item : current_) changed_.insert(item.first);
+    current_.clear();
+    current_.reserve(entries.size());
+    for (const Entry& entry : entries) Insert(entry);
+  }
+  /*!
+   * \brief Apply an OPL.* or PTL.* message: R01 replaces the current list, R02
+   * updates it.
+   * \param message The message.
+   */
+  void Apply(const typename MessageListTraits<Entry>::Class& message) {
+    const std::vector<Entry>& entries =
+        *MessageListTraits<Entry>::Get(message);
+    switch (message.GetMessageType()) {
+      case accm::Header::MsgType::OPL_R01:
+      case accm::Header::MsgType::PTL_R01:
+        ApplyComplete(entries);
+        break;
+      default:
+        ApplyIncremental(entries);
+        break;
+    }
+  }
+
+  /*!
+   * \brief Get the current list, e.g. for a complete (R01) update.
+   * \param entries Output entries, appended in no particular order.
+   */
+  void GetComplete(std::vector<Entry>& entries) const {
+    entries.reserve(entries.size() + current_.size());
+    for (const auto& item : current_) entries.push_back(item.second);
+  }
+  /*!
+   * \brief Get the incremental (R02) update turning the published list into
+   * the current one. Inserted and modified entries have action I; removed
+   * entries only carry their ID and action D.
+   * \param delta Output entries, appended in no particular order.
+   * \return The number of entries appended.
+   */
+  std::size_t GetDelta(std::vector<Entry>& delta) const {
+    std::size_t count = delta.size();
+    for (const Key& key : changed_) {
+      auto current = current_.find(key);
+      auto published = published_.find(key);
+      if (current != current_.end()) {
+        if (published == published_.end() ||
+            !accm::reflection::Equal(current->second, published->second)) {
+          delta.push_back(current->second);
+          delta.back().action = Action::I;
+        }
+      } else if (published != published_.end()) {
+        delta.push_back(RosterTraits<Entry>::MakeRemoval(published->second));
+      }
+    }
+    return delta.size() - count;
+  }
+  /*!
+   * \brief Mark the current list as published, once the device acknowledged
+   * the update built by GetDelta or GetComplete.
+   */
+  void Commit() {
+    for (const Key& key : changed_) {
+      auto current = current_.find(key);
+      if (current != current_.end()) {
+        published_.insert_or_assign(key, current->second);
+      } else {
+        published_.erase(key);
+      }
+    }
+    changed_.clear();
+  }
+
+ private:
+  std::unordered_map<Key, Entry> current_;
+  std::unordered_map<Key, Entry> published_;
+  std::unordered_set<Key> changed_;
+};
+
+/*!
+ * \brief Operator list of a device, indexed by operator ID.
+ */
+using OperatorRoster = Roster<accm::Operator>;
+/*!
+ * \brief Patient list of a device, indexed by patient ID.
+ */
+using PatientRoster = Roster<accm::Patient>;
+
+// Instantiated once, in Roster.cpp.
+extern template class Roster<accm::Operator>;
+extern template class Roster<accm::Patient>;
@@ -0,0 +1,122 @@
+#include "SessionCapture.h"
+#include <ctime>
+
+namespace {
+constexpr char kMagic[] = {'A', 'C', 'C', 'M', 'C', 'A', 'P'};
+constexpr char kVersion = 1;
+// Bound of the lengths read, against corrupted files.
+constexpr std::uint64_t kMaxLength = 64 << 20;
+
+void AppendVarint(std::string& buffer, std::uint64_t value) {
+  while (value >= 0x80) {
+    buffer.push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  buffer.push_back(static_cast<char>(value));
+}
+
+bool ReadVarint(std::istream& stream, std::uint64_t& value) {
+  value = 0;
+  for (unsigned shift = 0; shift < 64; shift += 7) {
+    int byte = stream.get();
+    if (byte == std::char_traits<char>::eof()) return false;
+    value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) return true;
+  }
+  return false;
+}
+
+bool ReadString(std::istream& stream, std::string& text) {
+  std::uint64_t length;
+  if (!ReadVarint(stream, length) || length > kMaxLength) return false;
+  text.resize(length);
+  return static_cast<bool>(
+      stream.read(text.data(), static_cast<std::streamsize>(length)));
+}
+}  // namespace
+
+CaptureWriter::~CaptureWriter() { Close(); }
+
+bool CaptureWriter::Open(const std::string& path) {
+  Close();
+  std::lock_guard<std::mutex> lock(mutex_);
+  file_.open(path, std::ios::binary | std::ios::trunc);
+  if (!file_) return false;
+  buffer_.assign(kMagic, sizeof(kMagic));
+  buffer_.push_back(kVersion);
+  AppendVarint(buffer_, static_cast<std::uint64_t>(std::time(nullptr)));
+  file_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+  last_ = std::chrono::steady_clock::now();
+  return static_cast<bool>(file_);
+}
+
+void CaptureWriter::Record(CaptureRecord::Direction direction,
+                           std::string_view message) {
+  std::string_view control_id = FindControlId(message);
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!file_.is_open()) return;
+  auto now = std::chrono::steady_clock::now();
+  auto delta =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(now - last_);
+  buffer_.clear();
+  buffer_.push_back(static_cast<char>(direction));
+  AppendVarint(buffer_, static_cast<std::uint64_t>(delta.count()));
+  AppendVarint(buffer_, control_id.size());
+  buffer_.append(control_id);
+  AppendVarint(buffer_, message.size());
+  last_ = now;
+  file_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+  file_.write(message.data(), static_cast<std::streamsize>(message.size()));
+}
+
+void CaptureWriter::Close() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (file_.is_open()) file_.close();
+}
+
+bool CaptureReader::Open(const std::string& path) {
+  file_.close();
+  file_.clear();
+  time_ = 0;
+  file_.open(path, std::ios::binary);
+  char magic[sizeof(kMagic) + 1];
+  std::uint64_t start_time;
+  if (!file_.read(magic, sizeof(magic)) ||
+      std::string_view(magic, sizeof(kMagic)) !=
+          std::string_view(kMagic, sizeof(kMagic)) ||
+      magic[sizeof(kMagic)] != kVersion || !ReadVarint(file_, start_time)) {
+    file_.close();
+    return false;
+  }
+  start_time_ = static_cast<std::int64_t>(start_time);
+  return true;
+}
+
+bool CaptureReader::Next(CaptureRecord& record) {
+  int direction = file_.get();
+  std::uint64_t delta;
+  if (direction == std::char_traits<char>::eof() ||
+      direction > static_cast<int>(CaptureRecord::Direction::OUTBOUND) ||
+      !ReadVarint(file_, delta) || !ReadString(file_, record.control_id) ||
+      !ReadString(file_, record.message)) {
+    return false;
+  }
+  time_ += static_cast<std::int64_t>(delta);
+  record.direction = static_cast<CaptureRecord::Direction>(direction);
+  record.time = time_;
+  return true;
+}
+
+std::string_view FindControlId(std::string_view xml) {
+  constexpr std::string_view kElement = "<HDR.control_id";
+  std::size_t start = xml.find(kElement);
+  if (start == std::string_view::npos) return {};
+  start = xml.find("V=", start + kElement.size());
+  if (start == std::string_view::npos || start + 2 >= xml.size()) return {};
+  char quote = xml[start + 2];
+  if (quote != '"' && quote != '\'') return {};
+  start += 3;
+  std::size_t end = xml.find(quote, start);
+  if (end == std::string_view::npos) return {};
+  return xml.substr(start, end - start);
+}
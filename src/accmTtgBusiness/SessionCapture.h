@@ -0,0 +1,129 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+/*!
+ * \brief A message of a captured session.
+ */
+struct CaptureRecord {
+  /*!
+   * \brief The direction of a message, seen from the tool.
+   */
+  enum class Direction : std::uint8_t { INBOUND, OUTBOUND };
+
+  Direction direction = Direction::INBOUND;
+  /*!
+   * \brief The time of the message, in nanoseconds from the start of the
+   * capture.
+   */
+  std::int64_t time = 0;
+  /*!
+   * \brief The HDR.control_id of the message; empty if it has none.
+   */
+  std::string control_id;
+  /*!
+   * \brief The XML document of the message.
+   */
+  std::string message;
+};
+
+/*!
+ * \brief The CaptureWriter class records the messages of a session into a
+ * capture file.
+ *
+ * The file starts with the "ACCMCAP" magic, a version byte and the start time
+ * of the capture (seconds since the epoch); then every message is a record:
+ * its direction (one byte), the time since the previous record in
+ * nanoseconds, its control_id and its XML document, the numbers and lengths
+ * being written as base-128 varints. Record may be called from any thread.
+ */
+class CaptureWriter {
+ public:
+  /*!
+   * \brief Default constructor. The writer is closed.
+   */
+  CaptureWriter() = default;
+  /*!
+   * \brief Destructor. Closes the file.
+   */
+  ~CaptureWriter();
+  /*!
+   * \brief Copy constructor is deleted.
+   */
+  CaptureWriter(const CaptureWriter&) = delete;
+  /*!
+   * \brief Assignment operator is deleted.
+   */
+  CaptureWriter& operator=(const CaptureWriter&) = delete;
+
+  /*!
+   * \brief Create the capture file. A previous one is closed.
+   * \param path The path of the file; it is truncated.
+   * \return true on success; false if the file cannot be written.
+   */
+  bool Open(const std::string& path);
+  /*!
+   * \brief Record a message, timestamped now.
+   * \param direction The direction of the message.
+   * \param message The XML document of the message.
+   */
+  void Record(CaptureRecord::Direction direction, std::string_view message);
+  /*!
+   * \brief Flush and close the file.
+   */
+  void Close();
+
+ private:
+  std::mutex mutex_;
+  std::ofstream file_;
+  std::string buffer_;
+  std::chrono::steady_clock::time_point last_;
+};
+
+/*!
+ * \brief The CaptureReader class reads the records of a capture file written
+ * by a CaptureWriter, in order.
+ */
+class CaptureReader {
+ public:
+  /*!
+   * \brief Default constructor. The reader is closed.
+   */
+  CaptureReader() = default;
+
+  /*!
+   * \brief Open a capture file.
+   * \param path The path of the file.
+   * \return true on success; false if the file cannot be read or is not a
+   * capture.
+   */
+  bool Open(const std::string& path);
+  /*!
+   * \brief Read the next record.
+   * \param record Output record. Its buffers are reused.
+   * \return true if a record was read; false at the end of the file or if it
+   * is truncated.
+   */
+  bool Next(CaptureRecord& record);
+  /*!
+   * \brief Get the start time of the capture.
+   * \return The start time in seconds since the epoch.
+   */
+  inline std::int64_t GetStartTime() const { return start_time_; }
+
+ private:
+  std::ifstream file_;
+  std::int64_t start_time_ = 0;
+  std::int64_t time_ = 0;
+};
+
+/*!
+ * \brief Find the HDR.control_id of a POCT1-A document without decoding it.
+ * \param xml The XML document.
+ * \return The control_id; empty if there is none.
+ */
+std::string_view FindControlId(std::string_view xml);
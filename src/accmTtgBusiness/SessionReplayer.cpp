@@ -0,0 +1,111 @@
+#include "SessionReplayer.h"
+#include <utility>
+
+namespace {
+// Poll period while the transport connects or its queue is full.
+constexpr std::chrono::milliseconds kPollPeriod(1);
+constexpr std::chrono::seconds kConnectTimeout(10);
+}  // namespace
+
+SessionReplayer::SessionReplayer(ITransport& transport, const Options& options)
+    : transport_(transport),
+      options_(options),
+      sequence_(options.first_control_id) {
+  decoder_.SetLazyServices(true);
+}
+
+SessionReplayer::~SessionReplayer() { Stop(); }
+
+bool SessionReplayer::Start(const std::string& path) {
+  if (thread_.joinable()) {
+    if (!IsFinished()) return false;
+    thread_.join();
+  }
+  if (!reader_.Open(path)) return false;
+  stopping_ = false;
+  finished_.store(false, std::memory_order_release);
+  sent_.store(0, std::memory_order_relaxed);
+  verbatim_.store(0, std::memory_order_relaxed);
+  failed_.store(false, std::memory_order_relaxed);
+  thread_ = std::thread(&SessionReplayer::Run, this);
+  return true;
+}
+
+void SessionReplayer::Stop() {
+  if (!thread_.joinable()) return;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  wake_.notify_all();
+  thread_.join();
+}
+
+ReplayStats SessionReplayer::GetStats() const {
+  ReplayStats stats;
+  stats.sent = sent_.load(std::memory_order_relaxed);
+  stats.verbatim = verbatim_.load(std::memory_order_relaxed);
+  stats.failed = failed_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+void SessionReplayer::Run() {
+  auto deadline = std::chrono::steady_clock::now() + kConnectTimeout;
+  while (!transport_.IsConnected()) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      failed_.store(true, std::memory_order_relaxed);
+      finished_.store(true, std::memory_order_release);
+      return;
+    }
+    if (!Wait(std::chrono::steady_clock::now() + kPollPeriod)) return;
+  }
+
+  CaptureRecord record;
+  std::int64_t first = -1;
+  auto start = std::chrono::steady_clock::now();
+  while (reader_.Next(record)) {
+    if (record.direction != CaptureRecord::Direction::OUTBOUND) continue;
+    if (options_.speed > 0) {
+      if (first < 0) first = record.time;
+      auto offset = std::chrono::nanoseconds(static_cast<std::int64_t>(
+          static_cast<double>(record.time - first) / options_.speed));
+      if (!Wait(start + offset)) return;
+    }
+    if (!Send(record.message)) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!stopping_) failed_.store(true, std::memory_order_relaxed);
+      break;
+    }
+  }
+  finished_.store(true, std::memory_order_release);
+}
+
+bool SessionReplayer::Wait(std::chrono::steady_clock::time_point until) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return !wake_.wait_until(lock, until, [this]() { return stopping_; });
+}
+
+bool SessionReplayer::Send(const std::string& message) {
+  buffer_.clear();
+  PoolPtr<Message> decoded = decoder_.Decode(message, pool_);
+  if (decoded) {
+    sequence_.Next(control_id_);
+    accm::Header head = *decoded->GetHeader();
+    decoded->SetHeader(std::move(head), control_id_);
+    if (!encoder_.Encode(*decoded, buffer_)) decoded.reset();
+  }
+  if (!decoded) {
+    buffer_ = message;
+    verbatim_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // The transport refuses messages while its queue is full.
+  while (!transport_.Send(buffer_)) {
+    if (!transport_.IsConnected() ||
+        !Wait(std::chrono::steady_clock::now() + kPollPeriod)) {
+      return false;
+    }
+  }
+  sent_.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
@@ -0,0 +1,134 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "ControlIdSequence.h"
+#include "ITransport.h"
+#include "MessageDecoder.h"
+#include "MessageEncoder.h"
+#include "MessagePool.h"
+#include "SessionCapture.h"
+
+/*!
+ * \brief Counters of a SessionReplayer run.
+ */
+struct ReplayStats {
+  /*!
+   * \brief Messages sent.
+   */
+  std::uint64_t sent = 0;
+  /*!
+   * \brief Messages sent as captured, because they could not be decoded to
+   * get a new control_id.
+   */
+  std::uint64_t verbatim = 0;
+  /*!
+   * \brief Whether the replay stopped because the connection was lost.
+   */
+  bool failed = false;
+};
+
+/*!
+ * \brief The SessionReplayer class sends the outbound messages of a capture
+ * (see CaptureWriter) again, on its own thread.
+ *
+ * Every message gets a new control_id from the replayer's own sequence: it is
+ * decoded, given the new id with Message::SetHeader and encoded again; the
+ * observations are decoded lazily, so their <SVC> block is forwarded as
+ * captured. The messages are either sent with the inter-message timing of
+ * the capture, scaled by a speed factor (e.g. 50 times faster), or as fast as
+ * the transport takes them. The inbound messages of the capture are only
+ * the responses of the peer, and are not replayed.
+ */
+class SessionReplayer {
+ public:
+  /*!
+   * \brief Replay settings.
+   */
+  struct Options {
+    /*!
+     * \brief The speed relative to the capture: 1 keeps the original timing,
+     * 50 replays 50 times faster; 0 sends the messages as fast as possible.
+     */
+    double speed = 1;
+    /*!
+     * \brief The first control_id of the replayed messages.
+     */
+    std::uint32_t first_control_id = 1;
+  };
+
+  /*!
+   * \brief Constructor.
+   * \param transport The transport sending the messages. It must outlive
+   * the replayer and be connecting or connected.
+   * \param options The replay settings.
+   */
+  SessionReplayer(ITransport& transport, const Options& options);
+  /*!
+   * \brief Destructor. Stops the replay.
+   */
+  ~SessionReplayer();
+  /*!
+   * \brief Copy constructor is deleted.
+   */
+  SessionReplayer(const SessionReplayer&) = delete;
+  /*!
+   * \brief Assignment operator is deleted.
+   */
+  SessionReplayer& operator=(const SessionReplayer&) = delete;
+
+  /*!
+   * \brief Start replaying a capture, once the transport is connected.
+   * \param path The path of the capture file.
+   * \return true if the replay started; false if the capture cannot be read
+   * or a replay is under way.
+   */
+  bool Start(const std::string& path);
+  /*!
+   * \brief Stop the replay.
+   */
+  void Stop();
+  /*!
+   * \brief Check if every message was sent, or the replay failed.
+   * \return true if the replay is over; false otherwise.
+   */
+  inline bool IsFinished() const {
+    return finished_.load(std::memory_order_acquire);
+  }
+  /*!
+   * \brief Get the counters of the replay.
+   * \return The counters.
+   */
+  ReplayStats GetStats() const;
+
+ private:
+  void Run();
+  bool Wait(std::chrono::steady_clock::time_point until);
+  bool Send(const std::string& message);
+
+ private:
+  ITransport& transport_;
+  Options options_;
+  std::thread thread_;
+  std::atomic<bool> finished_{false};
+  std::atomic<std::uint64_t> sent_{0};
+  std::atomic<std::uint64_t> verbatim_{0};
+  std::atomic<bool> failed_{false};
+
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  bool stopping_ = false;
+
+  // Replay thread only.
+  CaptureReader reader_;
+  MessageDecoder decoder_;
+  MessageEncoder encoder_;
+  MessagePool pool_{2};
+  ControlIdSequence sequence_;
+  std::string control_id_;
+  std::string buffer_;
+};
@@ -0,0 +1,60 @@
+#pragma once
+#include <cstdint>
+
+/*!
+ * \brief The SplitMix64 class is a small pseudo-random generator for the
+ * simulators. Its output only depends on integer arithmetic, so the same seed
+ * gives the same values on every platform and standard library.
+ */
+class SplitMix64 {
+ public:
+  /*!
+   * \brief Constructor.
+   * \param seed The seed.
+   */
+  explicit SplitMix64(std::uint64_t seed) : state_(seed) {}
+
+  /*!
+   * \brief Draw the next value.
+   * \return 64 random bits.
+   */
+  inline std::uint64_t Next() {
+    std::uint64_t z = (state_ += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+  }
+  /*!
+   * \brief Draw a uniform value in [0, 1), with the 53 bits of a double.
+   * \return The value.
+   */
+  inline double Uniform() {
+    return static_cast<double>(Next() >> 11) * 0x1.0p-53;
+  }
+  /*!
+   * \brief Draw a uniform value in [low, high).
+   * \return The value.
+   */
+  inline double Uniform(double low, double high) {
+    return low + (high - low) * Uniform();
+  }
+  /*!
+   * \brief Draw an approximately standard normal value: the Irwin-Hall sum of
+   * four uniforms.
+   * \return The value.
+   */
+  inline double Normal() {
+    double sum = Uniform() + Uniform() + Uniform() + Uniform();
+    return (sum - 2.0) * 1.7320508075688772;
+  }
+  /*!
+   * \brief Draw a uniform integer in [0, bound).
+   * \return The value.
+   */
+  inline std::uint32_t Below(std::uint32_t bound) {
+    return static_cast<std::uint32_t>(((Next() >> 32) * bound) >> 32);
+  }
+
+ private:
+  std::uint64_t state_;
+};
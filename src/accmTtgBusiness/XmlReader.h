@@ -0,0 +1,320 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/*!
+ * \brief The XmlReader class is a minimal pull parser for the subset of XML
+ * used by the POCT1-A protocol.
+ *
+ * The reader walks the given buffer once and never copies it: element names
+ * and attribute values are returned as views into the original buffer, so the
+ * buffer must outlive the reader. Text content, comments, processing
+ * instructions and the document type declaration are skipped, since POCT1-A
+ * carries every value inside the 'V' (and friends) attributes.
+ */
+class XmlReader {
+ public:
+  /*!
+   * \brief The Token enum
+   */
+  enum class Token {
+    START_ELEMENT, /**< An opening (or self-closing) tag was read. */
+    END_ELEMENT,   /**< A closing tag (or the end of a self-closing one). */
+    END_DOCUMENT,  /**< The end of the buffer was reached. */
+    ERROR          /**< Malformed input. \see GetError */
+  };
+
+  /*!
+   * \brief Maximum number of attributes kept for a single element.
+   */
+  static constexpr std::size_t kMaxAttributes = 16;
+  /*!
+   * \brief Maximum element nesting level.
+   */
+  static constexpr std::size_t kMaxDepth = 32;
+
+  /*!
+   * \brief Constructor.
+   * \param buffer The XML document to read. It is not copied.
+   */
+  explicit XmlReader(std::string_view buffer) : buffer_(buffer) {}
+
+  /*!
+   * \brief Advance to the next element boundary.
+   * \return The kind of token read.
+   */
+  Token Next() {
+    if (pending_end_) {
+      pending_end_ = false;
+      name_ = open_[--depth_];
+      return Token::END_ELEMENT;
+    }
+    attribute_count_ = 0;
+    while (pos_ < buffer_.size()) {
+      std::size_t open = buffer_.find('<', pos_);
+      if (open == std::string_view::npos) {
+        pos_ = buffer_.size();
+        break;
+      }
+      pos_ = open;
+      std::string_view rest = buffer_.substr(pos_);
+      if (StartsWith(rest, "<?")) {
+        if (!SkipPast("?>")) return Fail("Unterminated processing instruction");
+      } else if (StartsWith(rest, "<!--")) {
+        if (!SkipPast("-->")) return Fail("Unterminated comment");
+      } else if (StartsWith(rest, "<!")) {
+        if (!SkipPast(">")) return Fail("Unterminated declaration");
+      } else if (StartsWith(rest, "</")) {
+        return ReadEndTag();
+      } else {
+        return ReadStartTag();
+      }
+    }
+    if (depth_ != 0) return Fail("Unexpected end of document");
+    return Token::END_DOCUMENT;
+  }
+
+  /*!
+   * \brief Get the name of the current element.
+   * \return A view into the buffer with the qualified element name.
+   */
+  inline std::string_view GetName() const { return name_; }
+  /*!
+   * \brief Get the raw (still escaped) value of an attribute of the current
+   * start element.
+   * \param name The attribute name.
+   * \param value Output view into the buffer with the attribute's value.
+   * \return true if the attribute exists; false otherwise.
+   */
+  bool GetAttribute(std::string_view name, std::string_view& value) const {
+    for (std::size_t i = 0; i < attribute_count_; ++i) {
+      if (attributes_[i].first == name) {
+        value = attributes_[i].second;
+        return true;
+      }
+    }
+    return false;
+  }
+  /*!
+   * \brief Skip the remainder of the current element, including all of its
+   * descendants. Must be called right after a START_ELEMENT token.
+   * \return true on success; false if the document is malformed.
+   */
+  bool SkipElement() {
+    int depth = 1;
+    while (depth > 0) {
+      switch (Next()) {
+        case Token::START_ELEMENT:
+          ++depth;
+          break;
+        case Token::END_ELEMENT:
+          --depth;
+          break;
+        default:
+          return false;
+      }
+    }
+    return true;
+  }
+  /*!
+   * \brief Get the offset of the byte following the last token read.
+   * \return The offset into the buffer.
+   */
+  inline std::size_t GetPosition() const { return pos_; }
+  /*!
+   * \brief Get the offset where the last token read started.
+   * \return The offset into the buffer.
+   */
+  inline std::size_t GetTokenStart() const { return token_start_; }
+  /*!
+   * \brief Get the current element nesting level.
+   * \return The depth; 0 outside the root element.
+   */
+  inline int GetDepth() const { return depth_; }
+  /*!
+   * \brief Get a description of the last error.
+   * \return The error message; empty if there was no error.
+   */
+  inline std::string_view GetError() const { return error_; }
+
+  /*!
+   * \brief Append the unescaped form of an attribute value to a string.
+   * \param raw The escaped attribute value as returned by GetAttribute.
+   * \param out The string where to append the value.
+   * \return true on success; false if an entity reference is malformed.
+   */
+  static bool AppendUnescaped(std::string_view raw, std::string& out) {
+    std::size_t amp = raw.find('&');
+    while (amp != std::string_view::npos) {
+      out.append(raw.data(), amp);
+      std::size_t semi = raw.find(';', amp);
+      if (semi == std::string_view::npos) return false;
+      std::string_view entity = raw.substr(amp + 1, semi - amp - 1);
+      if (entity == "lt") {
+        out.push_back('<');
+      } else if (entity == "gt") {
+        out.push_back('>');
+      } else if (entity == "amp") {
+        out.push_back('&');
+      } else if (entity == "quot") {
+        out.push_back('"');
+      } else if (entity == "apos") {
+        out.push_back('\'');
+      } else if (!AppendCharReference(entity, out)) {
+        return false;
+      }
+      raw.remove_prefix(semi + 1);
+      amp = raw.find('&');
+    }
+    out.append(raw.data(), raw.size());
+    return true;
+  }
+
+ private:
+  static bool StartsWith(std::string_view text, std::string_view prefix) {
+    return text.substr(0, prefix.size()) == prefix;
+  }
+  static bool IsSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+  }
+  static bool IsNameChar(char c) {
+    return !IsSpace(c) && c != '/' && c != '>' && c != '=' && c != '<';
+  }
+  static bool AppendCharReference(std::string_view entity, std::string& out) {
+    if (entity.size() < 2 || entity[0] != '#') return false;
+    unsigned long code = 0;
+    bool hex = entity[1] == 'x';
+    std::size_t first = hex ? 2 : 1;
+    if (entity.size() == first) return false;
+    for (std::size_t i = first; i < entity.size(); ++i) {
+      char c = entity[i];
+      unsigned digit;
+      if (c >= '0' && c <= '9') {
+        digit = c - '0';
+      } else if (hex && c >= 'a' && c <= 'f') {
+        digit = c - 'a' + 10;
+      } else if (hex && c >= 'A' && c <= 'F') {
+        digit = c - 'A' + 10;
+      } else {
+        return false;
+      }
+      code = code * (hex ? 16 : 10) + digit;
+      if (code > 0x10FFFF) return false;
+    }
+    // Not a character: NUL and the UTF-16 surrogates.
+    if (code == 0 || (code >= 0xD800 && code <= 0xDFFF)) return false;
+    // UTF-8 encoding of the code point.
+    if (code < 0x80) {
+      out.push_back(static_cast<char>(code));
+    } else if (code < 0x800) {
+      out.push_back(static_cast<char>(0xC0 | (code >> 6)));
+      out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    } else if (code < 0x10000) {
+      out.push_back(static_cast<char>(0xE0 | (code >> 12)));
+      out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+      out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    } else {
+      out.push_back(static_cast<char>(0xF0 | (code >> 18)));
+      out.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+      out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+      out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    }
+    return true;
+  }
+  bool SkipPast(std::string_view terminator) {
+    std::size_t end = buffer_.find(terminator, pos_);
+    if (end == std::string_view::npos) return false;
+    pos_ = end + terminator.size();
+    return true;
+  }
+  void SkipSpaces() {
+    while (pos_ < buffer_.size() && IsSpace(buffer_[pos_])) ++pos_;
+  }
+  std::string_view ReadName() {
+    std::size_t start = pos_;
+    while (pos_ < buffer_.size() && IsNameChar(buffer_[pos_])) ++pos_;
+    return buffer_.substr(start, pos_ - start);
+  }
+  Token ReadEndTag() {
+    token_start_ = pos_;
+    pos_ += 2;
+    name_ = ReadName();
+    SkipSpaces();
+    if (name_.empty() || pos_ >= buffer_.size() || buffer_[pos_] != '>') {
+      return Fail("Malformed closing tag");
+    }
+    ++pos_;
+    if (depth_ == 0) return Fail("Unbalanced closing tag");
+    if (open_[depth_ - 1] != name_) return Fail("Mismatched closing tag");
+    --depth_;
+    return Token::END_ELEMENT;
+  }
+  Token ReadStartTag() {
+    token_start_ = pos_;
+    ++pos_;
+    name_ = ReadName();
+    if (name_.empty()) return Fail("Malformed opening tag");
+    while (true) {
+      SkipSpaces();
+      if (pos_ >= buffer_.size()) return Fail("Unterminated opening tag");
+      char c = buffer_[pos_];
+      if (c == '>') {
+        ++pos_;
+        return Open();
+      }
+      if (c == '/') {
+        if (pos_ + 1 >= buffer_.size() || buffer_[pos_ + 1] != '>') {
+          return Fail("Malformed self-closing tag");
+        }
+        pos_ += 2;
+        pending_end_ = true;
+        return Open();
+      }
+      std::string_view attr_name = ReadName();
+      SkipSpaces();
+      if (attr_name.empty() || pos_ >= buffer_.size() || buffer_[pos_] != '=') {
+        return Fail("Malformed attribute");
+      }
+      ++pos_;
+      SkipSpaces();
+      if (pos_ >= buffer_.size()) return Fail("Malformed attribute");
+      char quote = buffer_[pos_];
+      if (quote != '"' && quote != '\'') return Fail("Unquoted attribute");
+      std::size_t end = buffer_.find(quote, pos_ + 1);
+      if (end == std::string_view::npos) return Fail("Unterminated attribute");
+      if (attribute_count_ < kMaxAttributes) {
+        attributes_[attribute_count_++] = {
+            attr_name, buffer_.substr(pos_ + 1, end - pos_ - 1)};
+      }
+      pos_ = end + 1;
+    }
+  }
+  Token Open() {
+    if (static_cast<std::size_t>(depth_) == kMaxDepth) {
+      return Fail("Elements nested too deeply");
+    }
+    open_[depth_++] = name_;
+    return Token::START_ELEMENT;
+  }
+  Token Fail(const char* error) {
+    error_ = error;
+    pos_ = buffer_.size();
+    return Token::ERROR;
+  }
+
+ private:
+  std::string_view buffer_;
+  std::size_t pos_ = 0;
+  std::size_t token_start_ = 0;
+  int depth_ = 0;
+  bool pending_end_ = false;
+  std::string_view name_;
+  // The names of the elements open, outermost first.
+  std::array<std::string_view, kMaxDepth> open_;
+  std::array<std::pair<std::string_view, std::string_view>, kMaxAttributes>
+      attributes_;
+  std::size_t attribute_count_ = 0;
+  std::string_view error_;
+};
@@ -0,0 +1,201 @@
+#pragma once
+#include <charconv>
+#include <ctime>
+#include <string>
+#include <string_view>
+
+/*!
+ * \brief The XmlWriter class appends XML markup to a caller-owned buffer.
+ *
+ * The writer never allocates on its own: everything is appended to the given
+ * string, so a buffer that is cleared and reused between messages keeps its
+ * capacity and stops growing once it has reached the size of the largest
+ * message. Values are escaped straight into the buffer, and numbers and
+ * timestamps are formatted on the stack.
+ */
+class XmlWriter {
+ public:
+  /*!
+   * \brief Constructor.
+   * \param buffer The buffer where to append the markup. It is not cleared.
+   */
+  explicit XmlWriter(std::string& buffer) : buffer_(buffer) {}
+
+  /*!
+   * \brief Append the XML declaration.
+   */
+  inline void Declaration() {
+    buffer_.append("<?xml version=\"1.0\" encoding=\"UTF-8\"?>");
+  }
+  /*!
+   * \brief Append an opening tag without attributes ("<name>").
+   * \param name The element name.
+   */
+  inline void Open(std::string_view name) {
+    buffer_.push_back('<');
+    buffer_.append(name);
+    buffer_.push_back('>');
+  }
+  /*!
+   * \brief Append a closing tag ("</name>").
+   * \param name The element name.
+   */
+  inline void Close(std::string_view name) {
+    buffer_.append("</", 2);
+    buffer_.append(name);
+    buffer_.push_back('>');
+  }
+  /*!
+   * \brief Start an opening tag that will receive attributes ("<name").
+   * \param name The element name.
+   * \see EndEmpty
+   * \see EndStart
+   */
+  inline void Start(std::string_view name) {
+    buffer_.push_back('<');
+    buffer_.append(name);
+  }
+  /*!
+   * \brief Terminate a tag started with Start as a self-closing one.
+   */
+  inline void EndEmpty() { buffer_.append("/>", 2); }
+  /*!
+   * \brief Terminate a tag started with Start as an opening tag.
+   */
+  inline void EndStart() { buffer_.push_back('>'); }
+
+  /*!
+   * \brief Append a text attribute.
+   * \param name The attribute name.
+   * \param value The unescaped value.
+   */
+  inline void Attribute(std::string_view name, std::string_view value) {
+    StartAttribute(name);
+    AppendEscaped(value);
+    EndAttribute();
+  }
+  /*!
+   * \brief Append an integer attribute.
+   * \param name The attribute name.
+   * \param value The value.
+   */
+  inline void Attribute(std::string_view name, long long value) {
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    StartAttribute(name);
+    buffer_.append(digits, result.ptr - digits);
+    EndAttribute();
+  }
+  /*!
+   * \brief Append a date attribute formatted as "YYYY-MM-DD".
+   * \param name The attribute name.
+   * \param date The date. Only the date fields are used.
+   */
+  inline void AttributeDate(std::string_view name, const std::tm& date) {
+    char text[10];
+    FormatDate(date, text);
+    StartAttribute(name);
+    buffer_.append(text, sizeof(text));
+    EndAttribute();
+  }
+  /*!
+   * \brief Append a timestamp attribute formatted as ISO 8601 in UTC
+   * ("YYYY-MM-DDThh:mm:ss+00:00").
+   * \param name The attribute name.
+   * \param value The timestamp.
+   */
+  inline void AttributeDateTime(std::string_view name, time_t value) {
+    std::tm date;
+    gmtime_r(&value, &date);
+    char text[25];
+    FormatDate(date, text);
+    text[10] = 'T';
+    FormatTwoDigits(date.tm_hour, text + 11);
+    text[13] = ':';
+    FormatTwoDigits(date.tm_min, text + 14);
+    text[16] = ':';
+    FormatTwoDigits(date.tm_sec, text + 17);
+    std::char_traits<char>::copy(text + 19, "+00:00", 6);
+    StartAttribute(name);
+    buffer_.append(text, sizeof(text));
+    EndAttribute();
+  }
+
+  /*!
+   * \brief Start an attribute whose value is written piecewise.
+   * \param name The attribute name.
+   * \see AppendEscaped
+   * \see EndAttribute
+   */
+  inline void StartAttribute(std::string_view name) {
+    buffer_.push_back(' ');
+    buffer_.append(name);
+    buffer_.append("=\"", 2);
+  }
+  /*!
+   * \brief Append text to the attribute started with StartAttribute,
+   * escaping the markup characters.
+   * \param value The unescaped text.
+   */
+  void AppendEscaped(std::string_view value) {
+    std::size_t start = 0;
+    for (std::size_t i = 0; i < value.size(); ++i) {
+      const char* entity = nullptr;
+      switch (value[i]) {
+        case '<':
+          entity = "&lt;";
+          break;
+        case '>':
+          entity = "&gt;";
+          break;
+        case '&':
+          entity = "&amp;";
+          break;
+        case '"':
+          entity = "&quot;";
+          break;
+        case '\'':
+          entity = "&apos;";
+          break;
+        default:
+          continue;
+      }
+      buffer_.append(value.data() + start, i - start);
+      buffer_.append(entity);
+      start = i + 1;
+    }
+    buffer_.append(value.data() + start, value.size() - start);
+  }
+  /*!
+   * \brief Append markup that is already well-formed, as is.
+   * \param markup The markup.
+   */
+  inline void AppendMarkup(std::string_view markup) { buffer_.append(markup); }
+  /*!
+   * \brief Append a single character that needs no escaping.
+   * \param c The character.
+   */
+  inline void AppendRaw(char c) { buffer_.push_back(c); }
+  /*!
+   * \brief Terminate the attribute started with StartAttribute.
+   */
+  inline void EndAttribute() { buffer_.push_back('"'); }
+
+ private:
+  static void FormatTwoDigits(int value, char* out) {
+    out[0] = static_cast<char>('0' + value / 10);
+    out[1] = static_cast<char>('0' + value % 10);
+  }
+  static void FormatDate(const std::tm& date, char* out) {
+    int year = date.tm_year + 1900;
+    FormatTwoDigits(year / 100, out);
+    FormatTwoDigits(year % 100, out + 2);
+    out[4] = '-';
+    FormatTwoDigits(date.tm_mon + 1, out + 5);
+    out[7] = '-';
+    FormatTwoDigits(date.tm_mday, out + 8);
+  }
+
+ private:
+  std::string& buffer_;
+};
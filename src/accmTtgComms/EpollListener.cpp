@@ -0,0 +1,117 @@
+#include "EpollListener.h"
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#include "SocketTransport.h"
+
+namespace {
+constexpr int kBacklog = 4096;
+// How long the socket is not watched after an accept error, in nanoseconds.
+constexpr std::int64_t kPauseTime = 100000000;
+
+int OpenSpare() { return open("/dev/null", O_RDONLY | O_CLOEXEC); }
+}  // namespace
+
+EpollListener::EpollListener(EventLoop& loop)
+    : loop_(loop), timers_(loop), spare_(OpenSpare()) {}
+
+EpollListener::~EpollListener() {
+  Close();
+  timers_.Stop();
+  if (spare_ >= 0) close(spare_);
+}
+
+bool EpollListener::Listen(const std::string& ip, std::uint16_t port,
+                           AcceptHandler handler) {
+  Close();
+
+  sockaddr_in address;
+  if (!SocketTransport::ParseAddress(ip, port, address, last_error_)) {
+    return false;
+  }
+  int descriptor =
+      socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (descriptor < 0) {
+    last_error_ = SocketTransport::ErrnoText("Cannot create the socket", errno);
+    return false;
+  }
+  int on = 1;
+  setsockopt(descriptor, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+  socklen_t length = sizeof(address);
+  if (bind(descriptor, reinterpret_cast<sockaddr*>(&address),
+           sizeof(address)) != 0 ||
+      listen(descriptor, kBacklog) != 0 ||
+      getsockname(descriptor, reinterpret_cast<sockaddr*>(&address),
+                  &length) != 0) {
+    last_error_ = SocketTransport::ErrnoText("Cannot listen", errno);
+    close(descriptor);
+    return false;
+  }
+
+  last_error_.clear();
+  port_.store(ntohs(address.sin_port), std::memory_order_release);
+  loop_.Invoke([this, descriptor, &handler]() {
+    socket_ = descriptor;
+    handler_ = std::move(handler);
+    loop_.Add(socket_, EPOLLIN, this);
+  });
+  return true;
+}
+
+void EpollListener::Close() {
+  port_.store(0, std::memory_order_release);
+  loop_.Invoke([this]() {
+    if (socket_ < 0) return;
+    loop_.Remove(socket_);
+    close(socket_);
+    socket_ = -1;
+    handler_ = nullptr;
+    paused_ = false;
+  });
+}
+
+void EpollListener::OnEvents(unsigned) {
+  while (socket_ >= 0 && !paused_) {
+    int descriptor =
+        accept4(socket_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (descriptor >= 0) {
+      handler_(descriptor);
+      continue;
+    }
+    if ((errno == EMFILE || errno == ENFILE) && Refuse()) continue;
+    if (errno == EINTR || errno == ECONNABORTED) continue;
+    if (errno == EAGAIN || errno == EWOULDBLOCK) return;
+    // The socket stays readable, so the loop would spin on it.
+    Pause();
+    return;
+  }
+}
+
+// Leaves errno to the accept error if no connection was taken.
+bool EpollListener::Refuse() {
+  if (spare_ < 0) return false;
+  close(spare_);
+  int descriptor = accept4(socket_, nullptr, nullptr, SOCK_CLOEXEC);
+  int error = errno;
+  if (descriptor >= 0) {
+    close(descriptor);
+    refused_.fetch_add(1, std::memory_order_relaxed);
+  }
+  spare_ = OpenSpare();
+  errno = error;
+  return descriptor >= 0;
+}
+
+void EpollListener::Pause() {
+  paused_ = true;
+  loop_.Modify(socket_, 0, this);
+  timers_.Schedule(TimerQueue::Now() + kPauseTime, [this]() {
+    // Closed meanwhile, or closed and listening again.
+    if (!paused_ || socket_ < 0) return;
+    paused_ = false;
+    loop_.Modify(socket_, EPOLLIN, this);
+  });
+}
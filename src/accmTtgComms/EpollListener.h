@@ -0,0 +1,100 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include "EventLoop.h"
+#include "TimerQueue.h"
+
+/*!
+ * \brief The EpollListener class accepts TCP connections on an EventLoop.
+ *
+ * Every accepted connection is handed, as a non-blocking socket, to the
+ * accept handler, which typically attaches it to a SocketTransport (see
+ * SocketTransport::Attach). The handler runs on the loop thread and must not
+ * block.
+ *
+ * Out of descriptors, the listener frees a spare one to take the next
+ * connection and close it at once, so that the peer sees it refused instead
+ * of waiting in the backlog. On other accept errors, or with no spare left,
+ * it stops watching the socket for a moment rather than spinning on it.
+ */
+class EpollListener : private EventLoop::Handler {
+ public:
+  /*!
+   * \brief Function taking an accepted socket. It owns the socket.
+   */
+  using AcceptHandler = std::function<void(int descriptor)>;
+
+  /*!
+   * \brief Constructor.
+   * \param loop The loop. It must be running and outlive the listener.
+   */
+  explicit EpollListener(EventLoop& loop);
+  /*!
+   * \brief Destructor. Stops listening.
+   */
+  ~EpollListener() override;
+  /*!
+   * \brief Copy constructor is deleted.
+   */
+  EpollListener(const EpollListener&) = delete;
+  /*!
+   * \brief Assignment operator is deleted.
+   */
+  EpollListener& operator=(const EpollListener&) = delete;
+
+  /*!
+   * \brief Start listening. A previous listening socket is closed.
+   * \param ip The local IPv4 address.
+   * \param port The TCP port; 0 picks a free one (see GetPort).
+   * \param handler The function taking the accepted sockets.
+   * \return true if the listener accepts connections; false otherwise.
+   * \see GetLastError
+   */
+  bool Listen(const std::string& ip, std::uint16_t port,
+              AcceptHandler handler);
+  /*!
+   * \brief Stop listening. The accepted connections are not affected.
+   */
+  void Close();
+  /*!
+   * \brief Get the port listened to.
+   * \return The port; 0 if not listening.
+   */
+  inline std::uint16_t GetPort() const {
+    return port_.load(std::memory_order_acquire);
+  }
+  /*!
+   * \brief Get the reason why the last call to Listen failed.
+   * \return The error description.
+   */
+  inline const std::string& GetLastError() const { return last_error_; }
+  /*!
+   * \brief Get the number of connections closed as soon as accepted, for
+   * lack of descriptors.
+   * \return The count.
+   */
+  inline std::uint64_t GetRefusedCount() const {
+    return refused_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  void OnEvents(unsigned events) override;
+  bool Refuse();
+  void Pause();
+
+ private:
+  EventLoop& loop_;
+  std::string last_error_;
+  std::atomic<std::uint16_t> port_{0};
+  std::atomic<std::uint64_t> refused_{0};
+  TimerQueue timers_;
+
+  // Loop thread only, once listening.
+  int socket_ = -1;
+  AcceptHandler handler_;
+  // Reserved for Refuse; -1 if it could not be reopened.
+  int spare_;
+  bool paused_ = false;
+};
@@ -0,0 +1,195 @@
+#include "EpollTransport.h"
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdint>
+#include <utility>
+
+namespace {
+constexpr std::size_t kReadSize = 64 << 10;
+constexpr std::size_t kMaxVectors = 64;
+}  // namespace
+
+EpollTransport::EpollTransport(std::size_t max_queued)
+    : SocketTransport(max_queued),
+      own_loop_(std::make_unique<EventLoop>()),
+      loop_(own_loop_.get()) {}
+
+EpollTransport::EpollTransport(EventLoop& loop, std::size_t max_queued)
+    : SocketTransport(max_queued), loop_(&loop) {}
+
+EpollTransport::~EpollTransport() { Disconnect(); }
+
+void EpollTransport::SetReceiver(Receiver receiver) {
+  receiver_ = std::move(receiver);
+}
+
+void EpollTransport::SetClosedHandler(ClosedHandler handler) {
+  closed_handler_ = std::move(handler);
+}
+
+bool EpollTransport::Connect(const std::string& ip, std::uint16_t port) {
+  Disconnect();
+
+  sockaddr_in address;
+  if (!ParseAddress(ip, port, address, last_error_)) return false;
+  if (!StartOwnLoop(own_loop_.get(), -1, last_error_)) return false;
+
+  int descriptor =
+      socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (descriptor < 0) {
+    last_error_ = ErrnoText("Cannot create the socket", errno);
+    return false;
+  }
+  PrepareSocket(descriptor);
+  if (connect(descriptor, reinterpret_cast<sockaddr*>(&address),
+              sizeof(address)) != 0 &&
+      errno != EINPROGRESS) {
+    last_error_ = ErrnoText("Cannot connect", errno);
+    close(descriptor);
+    return false;
+  }
+
+  Open(descriptor, false);
+  return true;
+}
+
+bool EpollTransport::Attach(int descriptor) {
+  Disconnect();
+  if (!StartOwnLoop(own_loop_.get(), descriptor, last_error_)) return false;
+  PrepareSocket(descriptor);
+  Open(descriptor, true);
+  return true;
+}
+
+void EpollTransport::Open(int descriptor, bool connected) {
+  OpenQueue();
+  last_error_.clear();
+  loop_->Post([this, descriptor, connected]() {
+    socket_ = descriptor;
+    framer_.Reset();
+    sending_.Clear();
+    connected_.store(connected, std::memory_order_release);
+    // EPOLLOUT reports the completion of a connection; messages queued
+    // meanwhile are written then.
+    watching_output_ = true;
+    loop_->Add(socket_, EPOLLIN | EPOLLOUT, this);
+  });
+}
+
+void EpollTransport::Disconnect() {
+  CloseQueue();
+  loop_->Invoke([this]() { Shutdown(); });
+}
+
+void EpollTransport::OnQueued() {
+  loop_->Post([this]() {
+    if (socket_ >= 0 && IsConnected()) Flush();
+  });
+}
+
+void EpollTransport::OnEvents(unsigned events) {
+  if (socket_ < 0) return;
+  if (!IsConnected() || (events & EPOLLERR)) {
+    int error = 0;
+    socklen_t length = sizeof(error);
+    getsockopt(socket_, SOL_SOCKET, SO_ERROR, &error, &length);
+    if (error != 0) {
+      Close(ErrnoText(IsConnected() ? "Connection lost" : "Cannot connect",
+                      error));
+      return;
+    }
+    connected_.store(true, std::memory_order_release);
+  }
+  if ((events & EPOLLIN) && !Read()) return;
+  if (events & EPOLLHUP) {
+    Close("Connection closed by the peer");
+    return;
+  }
+  if (events & EPOLLOUT) Flush();
+}
+
+bool EpollTransport::Flush() {
+  while (true) {
+    if (sending_.IsWritten()) {
+      // Take everything queued since the last write, keeping both buffers.
+      sending_.Clear();
+      TakeQueued(sending_);
+      if (sending_.IsWritten()) {
+        WatchOutput(false);
+        return true;
+      }
+    }
+
+    iovec vectors[kMaxVectors];
+    msghdr header{};
+    header.msg_iov = vectors;
+    header.msg_iovlen = sending_.Gather(vectors, kMaxVectors);
+    ssize_t written = sendmsg(socket_, &header, MSG_NOSIGNAL);
+    if (written < 0) {
+      if (errno == EINTR) continue;
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        WatchOutput(true);
+        return true;
+      }
+      Close(ErrnoText("Cannot send", errno));
+      return false;
+    }
+    sending_.Consume(static_cast<std::size_t>(written));
+  }
+}
+
+bool EpollTransport::Read() {
+  char buffer[kReadSize];
+  while (true) {
+    ssize_t count = recv(socket_, buffer, sizeof(buffer), 0);
+    if (count == 0) {
+      Close("Connection closed by the peer");
+      return false;
+    }
+    if (count < 0) {
+      if (errno == EINTR) continue;
+      if (errno == EAGAIN || errno == EWOULDBLOCK) return true;
+      Close(ErrnoText("Cannot receive", errno));
+      return false;
+    }
+
+    framer_.Append(std::string_view(buffer, static_cast<std::size_t>(count)));
+    std::string_view message;
+    while (framer_.Next(message)) {
+      if (receiver_) receiver_(message);
+      // The receiver may have disconnected.
+      if (socket_ < 0) return false;
+    }
+    if (framer_.HasError()) {
+      Close("Malformed POCT1-A stream");
+      return false;
+    }
+    if (static_cast<std::size_t>(count) < sizeof(buffer)) return true;
+  }
+}
+
+void EpollTransport::Shutdown() {
+  connected_.store(false, std::memory_order_release);
+  if (socket_ >= 0) {
+    loop_->Remove(socket_);
+    DrainAndClose(socket_);
+    socket_ = -1;
+  }
+  // Release the shared segments.
+  sending_.Clear();
+  CloseQueue();
+}
+
+void EpollTransport::Close(const std::string& reason) {
+  Shutdown();
+  if (closed_handler_) closed_handler_(reason);
+}
+
+void EpollTransport::WatchOutput(bool watch) {
+  if (watch == watching_output_) return;
+  loop_->Modify(socket_, watch ? EPOLLIN | EPOLLOUT : EPOLLIN, this);
+  watching_output_ = watch;
+}
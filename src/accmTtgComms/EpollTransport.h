@@ -0,0 +1,133 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include "EventLoop.h"
+#include "Poct1Framer.h"
+#include "SendQueue.h"
+#include "SocketTransport.h"
+
+/*!
+ * \brief The EpollTransport class carries POCT1-A messages over a TCP
+ * connection, driven by an EventLoop.
+ *
+ * Connect only starts a non-blocking connection and returns; the loop thread
+ * completes it, reads the socket, splits the stream into messages (see
+ * Poct1Framer) and hands each one to the receiver. Neither the caller of Send
+ * nor the GUI thread ever waits for the socket: Send appends the message to
+ * an outbound queue and wakes the loop, which writes everything queued so far
+ * with as few system calls as possible. Messages sent while a write is in
+ * flight are batched into the next one.
+ *
+ * The queue is written with vectored writes (sendmsg), so a message may be
+ * sent as segments: the copied ones are packed into one buffer, while static
+ * and shared ones (e.g. a serialized body shared by many connections) are
+ * written from where they are (see SendQueue).
+ *
+ * Transports may share a loop (see EventLoopPool), so that a few threads
+ * serve many connections; a transport built without a loop runs its own. The
+ * receiver and the closed handler run on the loop thread and must not block;
+ * the transport must not be destroyed on its loop thread.
+ */
+class EpollTransport : public SocketTransport, private EventLoop::Handler {
+ public:
+  /*!
+   * \brief Constructor of a transport running its own loop.
+   * \param max_queued Maximum number of bytes waiting to be written.
+   */
+  explicit EpollTransport(std::size_t max_queued = kDefaultMaxQueued);
+  /*!
+   * \brief Constructor of a transport running on a shared loop.
+   * \param loop The loop. It must be running and outlive the transport.
+   * \param max_queued Maximum number of bytes waiting to be written.
+   */
+  explicit EpollTransport(EventLoop& loop,
+                          std::size_t max_queued = kDefaultMaxQueued);
+  /*!
+   * \brief Destructor. Closes the connection.
+   */
+  ~EpollTransport() override;
+  /*!
+   * \brief Copy constructor is deleted.
+   */
+  EpollTransport(const EpollTransport&) = delete;
+  /*!
+   * \brief Assignment operator is deleted.
+   */
+  EpollTransport& operator=(const EpollTransport&) = delete;
+
+  /*!
+   * \brief Set the function called with every inbound message. Must be called
+   * before Connect.
+   * \param receiver The function.
+   */
+  void SetReceiver(Receiver receiver) override;
+  /*!
+   * \brief Set the function called when the connection fails or drops. Must
+   * be called before Connect.
+   * \param handler The function.
+   */
+  void SetClosedHandler(ClosedHandler handler) override;
+
+  /*!
+   * \brief Start connecting to a peer. A previous connection is closed.
+   * \param ip The IPv4 address of the peer.
+   * \param port The TCP port of the peer.
+   * \return true if the connection is under way; false otherwise.
+   * \see GetLastError
+   */
+  bool Connect(const std::string& ip, std::uint16_t port) override;
+  /*!
+   * \brief Take over a connected socket, e.g. accepted by an EpollListener.
+   * A previous connection is closed.
+   * \param descriptor The non-blocking socket. The transport closes it.
+   * \return true if the transport carries the connection; false otherwise.
+   * \see GetLastError
+   */
+  bool Attach(int descriptor) override;
+  /*!
+   * \brief Close the connection. Unsent messages are dropped. May be called
+   * from the receiver; the closed handler is not called.
+   */
+  void Disconnect() override;
+  /*!
+   * \brief Check if the connection is established.
+   * \return true if the connection is established; false otherwise.
+   */
+  inline bool IsConnected() const override {
+    return connected_.load(std::memory_order_acquire);
+  }
+
+  /*!
+   * \brief Get the reason why the last call to Connect failed.
+   * \return The error description.
+   */
+  inline const std::string& GetLastError() const override {
+    return last_error_;
+  }
+
+ private:
+  void OnQueued() override;
+  void Open(int descriptor, bool connected);
+  void OnEvents(unsigned events) override;
+  bool Flush();
+  bool Read();
+  void Shutdown();
+  void Close(const std::string& reason);
+  void WatchOutput(bool watch);
+
+ private:
+  std::unique_ptr<EventLoop> own_loop_;
+  EventLoop* loop_;
+  Receiver receiver_;
+  ClosedHandler closed_handler_;
+  std::string last_error_;
+  std::atomic<bool> connected_{false};
+
+  // Loop thread only, once connecting.
+  int socket_ = -1;
+  SendQueue sending_;
+  bool watching_output_ = false;
+  Poct1Framer framer_;
+};
@@ -0,0 +1,157 @@
+#include "EventLoop.h"
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdint>
+#include <future>
+#include "IoRing.h"
+
+namespace {
+constexpr int kMaxEvents = 64;
+constexpr unsigned kRingEntries = 4096;
+constexpr unsigned kRingBufferCount = 512;
+constexpr unsigned kRingBufferSize = 8 << 10;
+
+thread_local const EventLoop* current_loop = nullptr;
+
+void CloseDescriptor(int& descriptor) {
+  if (descriptor >= 0) close(descriptor);
+  descriptor = -1;
+}
+}  // namespace
+
+EventLoop::EventLoop(Backend backend) : backend_(backend) {}
+
+EventLoop::~EventLoop() { Stop(); }
+
+bool EventLoop::Start() {
+  if (running_.load(std::memory_order_acquire)) return true;
+  epoll_ = epoll_create1(EPOLL_CLOEXEC);
+  wake_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  epoll_event event{};
+  event.events = EPOLLIN;
+  event.data.ptr = nullptr;
+  if (epoll_ < 0 || wake_ < 0 ||
+      epoll_ctl(epoll_, EPOLL_CTL_ADD, wake_, &event) != 0) {
+    CloseDescriptor(epoll_);
+    CloseDescriptor(wake_);
+    return false;
+  }
+  if (backend_ == Backend::IO_URING) {
+    ring_ = std::make_unique<IoRing>();
+    event.data.ptr = static_cast<Handler*>(ring_.get());
+    if (!ring_->Open(kRingEntries, kRingBufferCount, kRingBufferSize) ||
+        epoll_ctl(epoll_, EPOLL_CTL_ADD, ring_->GetDescriptor(), &event) !=
+            0) {
+      ring_.reset();
+    }
+  }
+  running_.store(true, std::memory_order_release);
+  thread_ = std::thread(&EventLoop::Run, this);
+  return true;
+}
+
+void EventLoop::Stop() {
+  if (!thread_.joinable()) return;
+  running_.store(false, std::memory_order_release);
+  Wake();
+  thread_.join();
+  ring_.reset();
+  CloseDescriptor(epoll_);
+  CloseDescriptor(wake_);
+}
+
+bool EventLoop::IsLoopThread() const { return current_loop == this; }
+
+bool EventLoop::Add(int descriptor, unsigned events, Handler* handler) {
+  epoll_event event{};
+  event.events = events;
+  event.data.ptr = handler;
+  return epoll_ctl(epoll_, EPOLL_CTL_ADD, descriptor, &event) == 0;
+}
+
+bool EventLoop::Modify(int descriptor, unsigned events, Handler* handler) {
+  epoll_event event{};
+  event.events = events;
+  event.data.ptr = handler;
+  return epoll_ctl(epoll_, EPOLL_CTL_MOD, descriptor, &event) == 0;
+}
+
+void EventLoop::Remove(int descriptor) {
+  epoll_ctl(epoll_, EPOLL_CTL_DEL, descriptor, nullptr);
+}
+
+void EventLoop::Post(Task task) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  bool wake = tasks_.empty();
+  tasks_.push_back(std::move(task));
+  if (wake) Wake();
+}
+
+void EventLoop::Invoke(const Task& task) {
+  if (IsLoopThread() || !running_.load(std::memory_order_acquire)) {
+    task();
+    return;
+  }
+  std::promise<void> done;
+  Post([&task, &done]() {
+    task();
+    done.set_value();
+  });
+  done.get_future().wait();
+}
+
+void EventLoop::Run() {
+  current_loop = this;
+  epoll_event events[kMaxEvents];
+  while (running_.load(std::memory_order_acquire)) {
+    // The operations prepared since the last wait, in one system call.
+    if (ring_) ring_->Submit();
+    int count = epoll_wait(epoll_, events, kMaxEvents, -1);
+    if (count < 0 && errno != EINTR) break;
+    for (int i = 0; i < count; ++i) {
+      auto* handler = static_cast<Handler*>(events[i].data.ptr);
+      if (handler) {
+        handler->OnEvents(events[i].events);
+      } else {
+        std::uint64_t value;
+        ssize_t result = read(wake_, &value, sizeof(value));
+        static_cast<void>(result);
+      }
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      running_tasks_.swap(tasks_);
+    }
+    for (Task& task : running_tasks_) task();
+    running_tasks_.clear();
+  }
+  current_loop = nullptr;
+}
+
+void EventLoop::Wake() {
+  // Fails only when the counter is already signaled.
+  std::uint64_t one = 1;
+  ssize_t result = write(wake_, &one, sizeof(one));
+  static_cast<void>(result);
+}
+
+EventLoopPool::EventLoopPool(std::size_t size, EventLoop::Backend backend) {
+  if (size == 0) size = 1;
+  loops_.reserve(size);
+  for (std::size_t i = 0; i < size; ++i) {
+    loops_.push_back(std::make_unique<EventLoop>(backend));
+    loops_.back()->Start();
+  }
+}
+
+EventLoop& EventLoopPool::Next() {
+  return *loops_[next_.fetch_add(1, std::memory_order_relaxed) %
+                 loops_.size()];
+}
+
+void EventLoopPool::Stop() {
+  for (auto& loop : loops_) loop->Stop();
+}
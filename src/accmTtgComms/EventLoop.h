@@ -0,0 +1,188 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class IoRing;
+
+/*!
+ * \brief The EventLoop class runs an epoll loop on its own thread and
+ * dispatches the readiness events of many descriptors to their handlers.
+ *
+ * One loop serves any number of connections, so a few loops (see
+ * EventLoopPool) are enough for thousands of them. Tasks can be posted to the
+ * loop from any thread; they run on the loop thread, after the events of the
+ * current wake-up, which is where the state of the handlers is changed.
+ *
+ * A loop may also run an io_uring instance (see IoRing), whose descriptor it
+ * watches like any other; the operations prepared on the loop thread are
+ * submitted once per wake-up, right before waiting. If the kernel lacks
+ * io_uring, the loop falls back to epoll alone.
+ */
+class EventLoop {
+ public:
+  /*!
+   * \brief Receiver of the events of a descriptor. It is called on the loop
+   * thread.
+   */
+  class Handler {
+   public:
+    virtual ~Handler() = default;
+    /*!
+     * \brief Handle the events of the descriptor.
+     * \param events The epoll events (EPOLLIN, EPOLLOUT, ...).
+     */
+    virtual void OnEvents(unsigned events) = 0;
+  };
+  using Task = std::function<void()>;
+  /*!
+   * \brief The I/O backend of the loop.
+   */
+  enum class Backend {
+    EPOLL,    //!< Readiness events only.
+    IO_URING  //!< Readiness events and an IoRing.
+  };
+
+  /*!
+   * \brief Constructor. The loop is not running.
+   * \param backend The I/O backend requested.
+   */
+  explicit EventLoop(Backend backend = Backend::EPOLL);
+  /*!
+   * \brief Destructor. Stops the loop.
+   */
+  ~EventLoop();
+  /*!
+   * \brief Copy constructor is deleted.
+   */
+  EventLoop(const EventLoop&) = delete;
+  /*!
+   * \brief Assignment operator is deleted.
+   */
+  EventLoop& operator=(const EventLoop&) = delete;
+
+  /*!
+   * \brief Start the loop thread.
+   * \return true if the loop runs; false if epoll is not available.
+   */
+  bool Start();
+  /*!
+   * \brief Stop the loop thread. Pending tasks are run first. Must not be
+   * called from the loop thread.
+   */
+  void Stop();
+  /*!
+   * \brief Check if the caller runs on the loop thread.
+   * \return true on the loop thread; false otherwise.
+   */
+  bool IsLoopThread() const;
+  /*!
+   * \brief Get the I/O backend in use.
+   * \return IO_URING if the loop runs an IoRing; EPOLL otherwise, also
+   * before Start.
+   */
+  inline Backend GetBackend() const {
+    return ring_ ? Backend::IO_URING : Backend::EPOLL;
+  }
+  /*!
+   * \brief Get the io_uring instance of the loop, to be used on the loop
+   * thread only.
+   * \return The ring; null if the backend in use is epoll.
+   */
+  inline IoRing* GetRing() const { return ring_.get(); }
+
+  /*!
+   * \brief Watch a descriptor. May be called from any thread.
+   * \param descriptor The descriptor.
+   * \param events The epoll events to watch.
+   * \param handler The handler of the events. It must outlive the watch.
+   * \return true on success; false otherwise.
+   */
+  bool Add(int descriptor, unsigned events, Handler* handler);
+  /*!
+   * \brief Change the events watched on a descriptor.
+   * \param descriptor The descriptor.
+   * \param events The epoll events to watch.
+   * \param handler The handler of the events.
+   * \return true on success; false otherwise.
+   */
+  bool Modify(int descriptor, unsigned events, Handler* handler);
+  /*!
+   * \brief Stop watching a descriptor. Events already collected for it in the
+   * current wake-up are still delivered, so the handler must only be
+   * destroyed from a task posted afterwards or once the loop is stopped.
+   * \param descriptor The descriptor.
+   */
+  void Remove(int descriptor);
+  /*!
+   * \brief Run a task on the loop thread. May be called from any thread.
+   * \param task The task.
+   */
+  void Post(Task task);
+  /*!
+   * \brief Run a task on the loop thread and wait for it; runs it directly
+   * when called from the loop thread or when the loop is not running.
+   * \param task The task.
+   */
+  void Invoke(const Task& task);
+
+ private:
+  void Run();
+  void Wake();
+
+ private:
+  Backend backend_;
+  int epoll_ = -1;
+  int wake_ = -1;
+  std::unique_ptr<IoRing> ring_;
+  std::thread thread_;
+  std::atomic<bool> running_{false};
+
+  std::mutex mutex_;
+  std::vector<Task> tasks_;
+  // Loop thread only: the tasks being run, keeping the capacity.
+  std::vector<Task> running_tasks_;
+};
+
+/*!
+ * \brief The EventLoopPool class is a fixed set of running EventLoops over
+ * which connections are spread.
+ */
+class EventLoopPool {
+ public:
+  /*!
+   * \brief Constructor. Starts the loops.
+   * \param size The number of loops; at least one.
+   * \param backend The I/O backend requested for the loops.
+   */
+  explicit EventLoopPool(
+      std::size_t size, EventLoop::Backend backend = EventLoop::Backend::EPOLL);
+  /*!
+   * \brief Get the number of loops.
+   * \return The number of loops.
+   */
+  inline std::size_t Size() const { return loops_.size(); }
+  /*!
+   * \brief Get a loop, in turn.
+   * \return The loop.
+   */
+  EventLoop& Next();
+  /*!
+   * \brief Get a loop by index.
+   * \param index The index, below Size().
+   * \return The loop.
+   */
+  inline EventLoop& Get(std::size_t index) { return *loops_[index]; }
+  /*!
+   * \brief Stop every loop.
+   */
+  void Stop();
+
+ private:
+  std::vector<std::unique_ptr<EventLoop>> loops_;
+  std::atomic<std::size_t> next_{0};
+};
@@ -0,0 +1,216 @@
+#include "IoRing.h"
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+namespace {
+constexpr unsigned kRequiredFeatures =
+    IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_FAST_POLL;
+constexpr unsigned char kRequiredOperations[] = {
+    IORING_OP_RECV, IORING_OP_SENDMSG, IORING_OP_CONNECT,
+    IORING_OP_ASYNC_CANCEL};
+constexpr unsigned kMaxProbedOperations = 256;
+constexpr unsigned kMaxBuffers = 32768;
+
+void* Map(std::size_t size, int descriptor, off_t offset) {
+  void* address = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE, descriptor, offset);
+  return address == MAP_FAILED ? nullptr : address;
+}
+
+void* MapAnonymous(std::size_t size) {
+  void* address = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  return address == MAP_FAILED ? nullptr : address;
+}
+
+bool SupportsOperations(int ring) {
+  std::vector<char> storage(sizeof(io_uring_probe) +
+                            kMaxProbedOperations * sizeof(io_uring_probe_op));
+  auto* probe = reinterpret_cast<io_uring_probe*>(storage.data());
+  if (syscall(__NR_io_uring_register, ring, IORING_REGISTER_PROBE, probe,
+              kMaxProbedOperations) != 0) {
+    return false;
+  }
+  for (unsigned char operation : kRequiredOperations) {
+    if (operation >= probe->ops_len ||
+        !(probe->ops[operation].flags & IO_URING_OP_SUPPORTED)) {
+      return false;
+    }
+  }
+  return true;
+}
+}  // namespace
+
+IoRing::~IoRing() { Close(); }
+
+bool IoRing::IsSupported() {
+  static const bool supported = []() {
+    IoRing ring;
+    return ring.Open(8, 1, 4096);
+  }();
+  return supported;
+}
+
+bool IoRing::Open(unsigned entries, unsigned buffer_count,
+                  unsigned buffer_size) {
+  Close();
+  if (buffer_count == 0 || buffer_count > kMaxBuffers ||
+      (buffer_count & (buffer_count - 1)) != 0 || buffer_size == 0) {
+    return false;
+  }
+
+  io_uring_params params{};
+  params.flags = IORING_SETUP_CQSIZE | IORING_SETUP_CLAMP;
+  params.cq_entries = entries * 4;
+  ring_ = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+  if (ring_ < 0) {
+    ring_ = -1;
+    return false;
+  }
+  if ((params.features & kRequiredFeatures) != kRequiredFeatures ||
+      !SupportsOperations(ring_)) {
+    Close();
+    return false;
+  }
+
+  // One mapping holds both queues (IORING_FEAT_SINGLE_MMAP).
+  rings_size_ = std::max<std::size_t>(
+      params.sq_off.array + params.sq_entries * sizeof(unsigned),
+      params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+  rings_ = Map(rings_size_, ring_, IORING_OFF_SQ_RING);
+  sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  sqes_ = static_cast<io_uring_sqe*>(Map(sqes_size_, ring_, IORING_OFF_SQES));
+  if (!rings_ || !sqes_) {
+    Close();
+    return false;
+  }
+  char* base = static_cast<char*>(rings_);
+  sq_head_ = reinterpret_cast<unsigned*>(base + params.sq_off.head);
+  sq_tail_ = reinterpret_cast<unsigned*>(base + params.sq_off.tail);
+  sq_flags_ = reinterpret_cast<unsigned*>(base + params.sq_off.flags);
+  sq_array_ = reinterpret_cast<unsigned*>(base + params.sq_off.array);
+  sq_mask_ = *reinterpret_cast<unsigned*>(base + params.sq_off.ring_mask);
+  sq_entries_ = params.sq_entries;
+  tail_ = *sq_tail_;
+  cq_head_ = reinterpret_cast<unsigned*>(base + params.cq_off.head);
+  cq_tail_ = reinterpret_cast<unsigned*>(base + params.cq_off.tail);
+  cqes_ = reinterpret_cast<io_uring_cqe*>(base + params.cq_off.cqes);
+  cq_mask_ = *reinterpret_cast<unsigned*>(base + params.cq_off.ring_mask);
+  // Entry i of the queue is always operation i.
+  for (unsigned i = 0; i < sq_entries_; ++i) sq_array_[i] = i;
+
+  buffer_ring_size_ = buffer_count * sizeof(io_uring_buf);
+  buffer_ring_ =
+      static_cast<io_uring_buf_ring*>(MapAnonymous(buffer_ring_size_));
+  buffers_size_ = static_cast<std::size_t>(buffer_count) * buffer_size;
+  buffers_ = static_cast<char*>(MapAnonymous(buffers_size_));
+  if (!buffer_ring_ || !buffers_) {
+    Close();
+    return false;
+  }
+  io_uring_buf_reg registration{};
+  registration.ring_addr = reinterpret_cast<std::uintptr_t>(buffer_ring_);
+  registration.ring_entries = buffer_count;
+  registration.bgid = kBufferGroup;
+  if (syscall(__NR_io_uring_register, ring_, IORING_REGISTER_PBUF_RING,
+              &registration, 1) != 0) {
+    Close();
+    return false;
+  }
+  buffer_size_ = buffer_size;
+  buffer_mask_ = buffer_count - 1;
+  buffer_tail_ = 0;
+  for (unsigned id = 0; id < buffer_count; ++id) ReleaseBuffer(id);
+  multishot_receive_ = true;
+  return true;
+}
+
+io_uring_sqe* IoRing::Prepare(Completion* completion) {
+  if (ring_ < 0) return nullptr;
+  if (tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_) {
+    Submit();
+    if (tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_) {
+      return nullptr;
+    }
+  }
+  io_uring_sqe* operation = &sqes_[tail_ & sq_mask_];
+  std::memset(operation, 0, sizeof(*operation));
+  operation->user_data = reinterpret_cast<std::uintptr_t>(completion);
+  ++tail_;
+  return operation;
+}
+
+void IoRing::Submit() {
+  if (ring_ < 0) return;
+  // Also the operations left by a previous call.
+  unsigned count = tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+  if (count == 0) return;
+  __atomic_store_n(sq_tail_, tail_, __ATOMIC_RELEASE);
+  // EAGAIN and EBUSY leave them queued for the next call.
+  Enter(count, 0);
+}
+
+void IoRing::Reap() {
+  while (ring_ >= 0) {
+    unsigned head = *cq_head_;
+    unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    if (head == tail) {
+      // Completions kept by the kernel while the queue was full.
+      if (!(__atomic_load_n(sq_flags_, __ATOMIC_RELAXED) &
+            IORING_SQ_CQ_OVERFLOW) ||
+          Enter(0, IORING_ENTER_GETEVENTS) < 0 ||
+          __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE) == tail) {
+        return;
+      }
+      continue;
+    }
+    io_uring_cqe completion = cqes_[head & cq_mask_];
+    // The completion may prepare operations or close the ring.
+    __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+    if (completion.user_data != 0) {
+      reinterpret_cast<Completion*>(completion.user_data)
+          ->OnCompletion(completion.res, completion.flags);
+    }
+  }
+}
+
+void IoRing::ReleaseBuffer(unsigned id) {
+  // The entries start at the ring itself: in C++, the flexible array of
+  // io_uring_buf_ring is shifted. Field by field, since the tail overlays the
+  // first entry.
+  io_uring_buf& buffer = reinterpret_cast<io_uring_buf*>(
+      buffer_ring_)[buffer_tail_ & buffer_mask_];
+  buffer.addr = reinterpret_cast<std::uintptr_t>(GetBuffer(id));
+  buffer.len = buffer_size_;
+  buffer.bid = static_cast<std::uint16_t>(id);
+  ++buffer_tail_;
+  __atomic_store_n(&buffer_ring_->tail, buffer_tail_, __ATOMIC_RELEASE);
+}
+
+void IoRing::OnEvents(unsigned) { Reap(); }
+
+int IoRing::Enter(unsigned to_submit, unsigned flags) {
+  while (true) {
+    long result = syscall(__NR_io_uring_enter, ring_, to_submit, 0, flags,
+                          nullptr, 0);
+    if (result >= 0 || errno != EINTR) return static_cast<int>(result);
+  }
+}
+
+void IoRing::Close() {
+  if (ring_ >= 0) close(ring_);
+  ring_ = -1;
+  if (rings_) munmap(rings_, rings_size_);
+  rings_ = nullptr;
+  if (sqes_) munmap(sqes_, sqes_size_);
+  sqes_ = nullptr;
+  if (buffer_ring_) munmap(buffer_ring_, buffer_ring_size_);
+  buffer_ring_ = nullptr;
+  if (buffers_) munmap(buffers_, buffers_size_);
+  buffers_ = nullptr;
+}
@@ -0,0 +1,162 @@
+#pragma once
+#include <linux/io_uring.h>
+#include <cstddef>
+#include <cstdint>
+#include "EventLoop.h"
+
+/*!
+ * \brief The IoRing class is the io_uring instance of an EventLoop: the
+ * operations prepared during an iteration of the loop, for any number of
+ * connections, are submitted together by one system call, and their
+ * completions are dispatched when the ring descriptor, watched by the loop,
+ * is readable.
+ *
+ * It is built on the raw system calls (io_uring_setup, io_uring_enter and
+ * io_uring_register), so it needs no library; Open fails if the kernel lacks
+ * an operation or feature used by UringTransport (Linux 5.19 or later), and
+ * the loop then falls back to epoll. Received data lands in a ring of
+ * buffers registered with the kernel (provided buffers), picked only when
+ * data arrives, so idle connections hold no buffer. Everything but
+ * IsSupported runs on the loop thread.
+ */
+class IoRing : public EventLoop::Handler {
+ public:
+  /*!
+   * \brief Receiver of the completion of an operation, whose address is the
+   * user_data of the operation. It is called on the loop thread.
+   */
+  class Completion {
+   public:
+    virtual ~Completion() = default;
+    /*!
+     * \brief Handle the completion.
+     * \param result The result: a byte count, or a negative errno.
+     * \param flags The completion flags (IORING_CQE_F_*).
+     */
+    virtual void OnCompletion(int result, unsigned flags) = 0;
+  };
+
+  /*!
+   * \brief The group of the receive buffers (IOSQE_BUFFER_SELECT).
+   */
+  static constexpr std::uint16_t kBufferGroup = 0;
+
+  /*!
+   * \brief Constructor. The ring is not open.
+   */
+  IoRing() = default;
+  /*!
+   * \brief Destructor. Closes the ring, which cancels the operations in
+   * flight; their completions are not dispatched.
+   */
+  ~IoRing() override;
+  /*!
+   * \brief Copy constructor is deleted.
+   */
+  IoRing(const IoRing&) = delete;
+  /*!
+   * \brief Assignment operator is deleted.
+   */
+  IoRing& operator=(const IoRing&) = delete;
+
+  /*!
+   * \brief Check once if the kernel supports the rings; may be called from
+   * any thread.
+   * \return true if a ring can be open; false otherwise.
+   */
+  static bool IsSupported();
+
+  /*!
+   * \brief Create the ring and register the receive buffers.
+   * \param entries The size of the submission queue; the completion queue
+   * is 4 times larger.
+   * \param buffer_count The number of receive buffers, a power of 2.
+   * \param buffer_size The size of a receive buffer.
+   * \return true if the ring is open; false if the kernel lacks support.
+   */
+  bool Open(unsigned entries, unsigned buffer_count, unsigned buffer_size);
+  /*!
+   * \brief Get the ring descriptor, readable when completions are waiting.
+   * \return The descriptor; -1 if the ring is not open.
+   */
+  inline int GetDescriptor() const { return ring_; }
+
+  /*!
+   * \brief Get an operation to fill, submitted by the next Submit. The
+   * queued operations are submitted first if the queue is full.
+   * \param completion The receiver of the completion; null to ignore it.
+   * \return The operation, cleared; null if the queue stays full.
+   */
+  io_uring_sqe* Prepare(Completion* completion);
+  /*!
+   * \brief Submit the operations prepared, with one system call.
+   */
+  void Submit();
+  /*!
+   * \brief Dispatch the completions waiting.
+   */
+  void Reap();
+
+  /*!
+   * \brief Get a receive buffer picked by the kernel.
+   * \param id The buffer id, from the completion flags.
+   * \return The buffer.
+   */
+  inline const char* GetBuffer(unsigned id) const {
+    return buffers_ + static_cast<std::size_t>(id) * buffer_size_;
+  }
+  /*!
+   * \brief Give a receive buffer back to the kernel once its data is used.
+   * \param id The buffer id.
+   */
+  void ReleaseBuffer(unsigned id);
+
+  /*!
+   * \brief Check if a receive may keep completing (IORING_RECV_MULTISHOT),
+   * which needs Linux 6.0.
+   * \return true unless the kernel rejected it.
+   */
+  inline bool HasMultishotReceive() const { return multishot_receive_; }
+  /*!
+   * \brief Record that the kernel rejected a multishot receive (EINVAL).
+   */
+  inline void DisableMultishotReceive() { multishot_receive_ = false; }
+
+ private:
+  void OnEvents(unsigned events) override;
+  int Enter(unsigned to_submit, unsigned flags);
+  void Close();
+
+ private:
+  int ring_ = -1;
+  void* rings_ = nullptr;
+  std::size_t rings_size_ = 0;
+  io_uring_sqe* sqes_ = nullptr;
+  std::size_t sqes_size_ = 0;
+
+  // Submission queue.
+  unsigned* sq_head_ = nullptr;
+  unsigned* sq_tail_ = nullptr;
+  unsigned* sq_flags_ = nullptr;
+  unsigned* sq_array_ = nullptr;
+  unsigned sq_mask_ = 0;
+  unsigned sq_entries_ = 0;
+  // The tail including the operations prepared but not yet submitted.
+  unsigned tail_ = 0;
+
+  // Completion queue.
+  unsigned* cq_head_ = nullptr;
+  unsigned* cq_tail_ = nullptr;
+  io_uring_cqe* cqes_ = nullptr;
+  unsigned cq_mask_ = 0;
+
+  // Receive buffers.
+  io_uring_buf_ring* buffer_ring_ = nullptr;
+  std::size_t buffer_ring_size_ = 0;
+  char* buffers_ = nullptr;
+  std::size_t buffers_size_ = 0;
+  unsigned buffer_size_ = 0;
+  unsigned buffer_mask_ = 0;
+  std::uint16_t buffer_tail_ = 0;
+  bool multishot_receive_ = true;
+};
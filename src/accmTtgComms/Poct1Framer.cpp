@@ -0,0 +1,127 @@
+#include "Poct1Framer.h"
+
+namespace {
+inline bool IsSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+}  // namespace
+
+void Poct1Framer::Append(std::string_view data) {
+  if (begin_ != 0) {
+    buffer_.erase(0, begin_);
+    scan_ -= begin_;
+    begin_ = 0;
+  }
+  buffer_.append(data);
+}
+
+bool Poct1Framer::Next(std::string_view& message) {
+  if (error_) return false;
+  std::size_t end;
+  if ((close_tag_.empty() && !FindRoot()) || !FindEnd(end)) {
+    if (buffer_.size() - begin_ > max_message_size_) error_ = true;
+    return false;
+  }
+
+  std::size_t start = begin_;
+  while (IsSpace(buffer_[start])) ++start;
+  message = std::string_view(buffer_).substr(start, end - start);
+  begin_ = scan_ = end;
+  close_tag_.clear();
+  self_closing_ = false;
+  return true;
+}
+
+void Poct1Framer::Reset() {
+  buffer_.clear();
+  begin_ = scan_ = 0;
+  close_tag_.clear();
+  self_closing_ = false;
+  error_ = false;
+}
+
+bool Poct1Framer::FindRoot() {
+  std::string_view data(buffer_);
+  std::size_t pos = scan_;
+  while (true) {
+    while (pos < data.size() && IsSpace(data[pos])) ++pos;
+    scan_ = pos;
+    if (data.size() - pos < 4) return false;
+    if (data[pos] != '<') {
+      error_ = true;
+      return false;
+    }
+
+    // XML declaration, processing instructions, comments and DOCTYPE.
+    if (data[pos + 1] == '?' || data[pos + 1] == '!') {
+      std::string_view terminator = data[pos + 1] == '?' ? "?>"
+                                    : data.substr(pos, 4) == "<!--" ? "-->"
+                                                                    : ">";
+      std::size_t found = data.find(terminator, pos + 2);
+      if (found == std::string_view::npos) return false;
+      pos = found + terminator.size();
+      continue;
+    }
+
+    std::size_t name_end = pos + 1;
+    while (name_end < data.size() && !IsSpace(data[name_end]) &&
+           data[name_end] != '>' && data[name_end] != '/') {
+      ++name_end;
+    }
+    if (name_end == data.size()) return false;
+    if (name_end == pos + 1) {
+      error_ = true;
+      return false;
+    }
+
+    // The end of the start tag, skipping the attribute values.
+    char quote = 0;
+    std::size_t tag_end = name_end;
+    for (; tag_end < data.size(); ++tag_end) {
+      char c = data[tag_end];
+      if (quote) {
+        if (c == quote) quote = 0;
+      } else if (c == '"' || c == '\'') {
+        quote = c;
+      } else if (c == '>') {
+        break;
+      }
+    }
+    if (tag_end == data.size()) return false;
+    close_tag_.assign("</");
+    close_tag_.append(data.substr(pos + 1, name_end - pos - 1));
+    self_closing_ = data[tag_end - 1] == '/';
+    scan_ = tag_end + 1;
+    return true;
+  }
+}
+
+bool Poct1Framer::FindEnd(std::size_t& end) {
+  if (self_closing_) {
+    end = scan_;
+    return true;
+  }
+  while (true) {
+    std::size_t found = buffer_.find(close_tag_, scan_);
+    if (found == std::string::npos) {
+      // The close tag may be cut: resume right before the last bytes.
+      if (buffer_.size() >= scan_ + close_tag_.size()) {
+        scan_ = buffer_.size() - close_tag_.size() + 1;
+      }
+      return false;
+    }
+    // The name may be followed by spaces before the '>'.
+    std::size_t pos = found + close_tag_.size();
+    while (pos < buffer_.size() && IsSpace(buffer_[pos])) ++pos;
+    if (pos == buffer_.size()) {
+      scan_ = found;
+      return false;
+    }
+    if (buffer_[pos] == '>') {
+      end = pos + 1;
+      return true;
+    }
+    // A longer name with the same prefix.
+    scan_ = found + 1;
+  }
+}
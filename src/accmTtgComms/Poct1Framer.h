@@ -0,0 +1,71 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/*!
+ * \brief The Poct1Framer class splits a POCT1-A byte stream into messages.
+ *
+ * POCT1-A sends the XML documents back to back on the connection, without a
+ * length prefix. A message starts with an optional XML declaration and its
+ * root element (e.g. <OBS.R01>), and ends with the matching close tag, or
+ * with the root start tag itself if it is self-closing; the root names are
+ * never nested inside a message, so the close tag is the end of the document.
+ * Received bytes are scanned once: the search for the close tag resumes where
+ * the previous call stopped.
+ */
+class Poct1Framer {
+ public:
+  /*!
+   * \brief Default maximum size of a message, in bytes.
+   */
+  static constexpr std::size_t kDefaultMaxMessageSize = 16 << 20;
+
+  /*!
+   * \brief Constructor.
+   * \param max_message_size Messages longer than this are an error.
+   */
+  explicit Poct1Framer(std::size_t max_message_size = kDefaultMaxMessageSize)
+      : max_message_size_(max_message_size) {}
+
+  /*!
+   * \brief Append received bytes. Invalidates the messages returned by Next.
+   * \param data The bytes.
+   */
+  void Append(std::string_view data);
+  /*!
+   * \brief Extract the next complete message.
+   * \param message Output message. It remains valid until the next call to
+   * Append or Reset.
+   * \return true if a message was extracted; false if more bytes are needed
+   * or the stream is broken.
+   * \see HasError
+   */
+  bool Next(std::string_view& message);
+  /*!
+   * \brief Check if the stream is broken: bytes outside of an element or a
+   * message exceeding the maximum size. The connection should be closed.
+   * \return true if the stream is broken; false otherwise.
+   */
+  inline bool HasError() const { return error_; }
+  /*!
+   * \brief Drop the buffered bytes and clear the error, e.g. on reconnection.
+   */
+  void Reset();
+
+ private:
+  bool FindRoot();
+  bool FindEnd(std::size_t& end);
+
+ private:
+  std::size_t max_message_size_;
+  std::string buffer_;
+  // Start of the unconsumed bytes.
+  std::size_t begin_ = 0;
+  // Where to resume scanning; for the close tag once close_tag_ is set.
+  std::size_t scan_ = 0;
+  // "</" and the root name, without the '>' that may follow spaces.
+  std::string close_tag_;
+  bool self_closing_ = false;
+  bool error_ = false;
+};
@@ -0,0 +1,60 @@
+#include "SendQueue.h"
+
+void SendQueue::Append(std::string_view data) {
+  if (data.empty()) return;
+  // Consecutive copies make one piece.
+  if (!pieces_.empty() && !pieces_.back().data &&
+      pieces_.back().offset + pieces_.back().size == copied_.size()) {
+    pieces_.back().size += data.size();
+  } else {
+    pieces_.push_back({nullptr, copied_.size(), data.size(), nullptr});
+  }
+  copied_.append(data);
+  bytes_ += data.size();
+}
+
+void SendQueue::Append(const ITransport::Segment& segment) {
+  if (!segment.owner && !segment.is_static) {
+    Append(segment.data);
+    return;
+  }
+  if (segment.data.empty()) return;
+  pieces_.push_back(
+      {segment.data.data(), 0, segment.data.size(), segment.owner});
+  bytes_ += segment.data.size();
+}
+
+void SendQueue::Clear() {
+  copied_.clear();
+  pieces_.clear();
+  bytes_ = 0;
+  next_piece_ = 0;
+  piece_offset_ = 0;
+}
+
+std::size_t SendQueue::Gather(iovec* vectors, std::size_t count) const {
+  std::size_t filled = 0;
+  for (std::size_t i = next_piece_; i < pieces_.size() && filled < count;
+       ++i) {
+    const Piece& piece = pieces_[i];
+    const char* data = piece.data ? piece.data : copied_.data() + piece.offset;
+    std::size_t skip = i == next_piece_ ? piece_offset_ : 0;
+    vectors[filled].iov_base = const_cast<char*>(data + skip);
+    vectors[filled].iov_len = piece.size - skip;
+    ++filled;
+  }
+  return filled;
+}
+
+void SendQueue::Consume(std::size_t bytes) {
+  while (bytes > 0) {
+    std::size_t left = pieces_[next_piece_].size - piece_offset_;
+    if (bytes < left) {
+      piece_offset_ += bytes;
+      return;
+    }
+    bytes -= left;
+    ++next_piece_;
+    piece_offset_ = 0;
+  }
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <sys/uio.h>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "ITransport.h"
+
+/*!
+ * \brief The SendQueue class holds the bytes waiting to be written on a
+ * connection, as pieces for vectored writes.
+ *
+ * Copied bytes are packed into one buffer, consecutive copies making one
+ * piece; static and shared segments are pieces of their own, written from
+ * where they are, a shared one keeping its owner alive until the queue is
+ * cleared. The queue also tracks how much of it was written. A SendQueue is
+ * not thread safe.
+ */
+class SendQueue {
+ public:
+  /*!
+   * \brief Append a copy of bytes.
+   * \param data The bytes.
+   */
+  void Append(std::string_view data);
+  /*!
+   * \brief Append a segment.
+   * \param segment The segment; copied unless static or shared.
+   */
+  void Append(const ITransport::Segment& segment);
+  /*!
+   * \brief Remove everything, releasing the shared segments but keeping the
+   * capacity.
+   */
+  void Clear();
+
+  /*!
+   * \brief Get the number of bytes appended since the last Clear.
+   * \return The number of bytes.
+   */
+  inline std::size_t GetBytes() const { return bytes_; }
+  /*!
+   * \brief Check if everything appended was written.
+   * \return true if nothing is left to write; false otherwise.
+   */
+  inline bool IsWritten() const { return next_piece_ == pieces_.size(); }
+  /*!
+   * \brief Describe the bytes left to write.
+   * \param vectors Output vectors.
+   * \param count The maximum number of vectors.
+   * \return The number of vectors filled.
+   */
+  std::size_t Gather(iovec* vectors, std::size_t count) const;
+  /*!
+   * \brief Record that bytes were written, in order.
+   * \param bytes The number of bytes, at most the bytes left to write.
+   */
+  void Consume(std::size_t bytes);
+
+ private:
+  // A run of bytes, at 'offset' in copied_ if 'data' is null.
+  struct Piece {
+    const char* data;
+    std::size_t offset;
+    std::size_t size;
+    std::shared_ptr<const std::string> owner;
+  };
+
+  std::string copied_;
+  std::vector<Piece> pieces_;
+  std::size_t bytes_ = 0;
+  // Position of the next byte to write.
+  std::size_t next_piece_ = 0;
+  std::size_t piece_offset_ = 0;
+};
@@ -0,0 +1,120 @@
+#include "SocketTransport.h"
+#include "EpollTransport.h"
+#include "IoRing.h"
+#include "UringTransport.h"
+#include <arpa/inet.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+namespace {
+constexpr std::size_t kDrainSize = 64 << 10;
+}  // namespace
+
+std::unique_ptr<SocketTransport> SocketTransport::Create(
+    EventLoop& loop, std::size_t max_queued) {
+  if (loop.GetRing()) {
+    return std::make_unique<UringTransport>(loop, max_queued);
+  }
+  return std::make_unique<EpollTransport>(loop, max_queued);
+}
+
+std::unique_ptr<SocketTransport> SocketTransport::Create(
+    EventLoop::Backend backend, std::size_t max_queued) {
+  if (backend == EventLoop::Backend::IO_URING && IoRing::IsSupported()) {
+    return std::make_unique<UringTransport>(max_queued);
+  }
+  return std::make_unique<EpollTransport>(max_queued);
+}
+
+std::string SocketTransport::ErrnoText(const char* what, int error) {
+  return std::string(what) + ": " + std::strerror(error);
+}
+
+bool SocketTransport::ParseAddress(const std::string& ip, std::uint16_t port,
+                                   sockaddr_in& address, std::string& error) {
+  address = sockaddr_in{};
+  address.sin_family = AF_INET;
+  address.sin_port = htons(port);
+  if (inet_pton(AF_INET, ip.c_str(), &address.sin_addr) != 1) {
+    error = "Invalid IPv4 address: " + ip;
+    return false;
+  }
+  return true;
+}
+
+bool SocketTransport::Send(std::string_view message) {
+  bool wake;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!Queued(message.size(), wake)) return false;
+    queued_.Append(message);
+  }
+  if (wake) OnQueued();
+  return true;
+}
+
+bool SocketTransport::Send(const Segment* segments, std::size_t count) {
+  std::size_t bytes = 0;
+  for (std::size_t i = 0; i < count; ++i) bytes += segments[i].data.size();
+  bool wake;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!Queued(bytes, wake)) return false;
+    for (std::size_t i = 0; i < count; ++i) queued_.Append(segments[i]);
+  }
+  if (wake) OnQueued();
+  return true;
+}
+
+void SocketTransport::OpenQueue() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  queued_.Clear();
+  accepting_ = true;
+}
+
+void SocketTransport::CloseQueue() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  accepting_ = false;
+  queued_.Clear();
+}
+
+void SocketTransport::TakeQueued(SendQueue& sending) {
+  // Swapping keeps the buffers of both queues.
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::swap(sending, queued_);
+}
+
+bool SocketTransport::Queued(std::size_t bytes, bool& wake) {
+  if (!accepting_ || queued_.GetBytes() + bytes > max_queued_) return false;
+  // Later messages join this batch until the loop takes it.
+  wake = queued_.GetBytes() == 0;
+  return true;
+}
+
+bool SocketTransport::StartOwnLoop(EventLoop* own_loop, int descriptor,
+                                   std::string& error) {
+  if (!own_loop || own_loop->Start()) return true;
+  error = ErrnoText("Cannot start the event loop", errno);
+  if (descriptor >= 0) close(descriptor);
+  return false;
+}
+
+void SocketTransport::PrepareSocket(int descriptor) {
+  // Messages are batched here; Nagle would only delay them.
+  int on = 1;
+  setsockopt(descriptor, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+}
+
+void SocketTransport::DrainAndClose(int descriptor, bool shut_down) {
+  // Closing with unread input resets the connection, which drops what the
+  // peer did not read yet, e.g. a last END.R01.
+  char buffer[kDrainSize];
+  while (recv(descriptor, buffer, sizeof(buffer), MSG_DONTWAIT) > 0) {
+  }
+  if (shut_down) shutdown(descriptor, SHUT_RDWR);
+  close(descriptor);
+}
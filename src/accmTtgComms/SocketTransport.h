@@ -0,0 +1,161 @@
+#pragma once
+#include <netinet/in.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include "EventLoop.h"
+#include "ITransport.h"
+#include "SendQueue.h"
+
+/*!
+ * \brief The SocketTransport class carries POCT1-A messages over a TCP
+ * connection driven by an EventLoop: it is an EpollTransport, or a
+ * UringTransport when the loop runs io_uring.
+ *
+ * Create picks the implementation matching the I/O backend of the loop, so
+ * the code using it runs on either, the backend being chosen at startup.
+ *
+ * The outbound queue is common to both: Send appends the message to it under
+ * a lock and, if the queue was empty, asks the implementation to wake its
+ * loop, which takes everything queued so far in one batch (see TakeQueued).
+ * Messages sent while a write is in flight thus join the next one. So are the
+ * socket chores: address parsing, socket options and closing.
+ */
+class SocketTransport : public ITransport {
+ public:
+  /*!
+   * \brief Default maximum number of bytes waiting to be written. Send fails
+   * beyond that.
+   */
+  static constexpr std::size_t kDefaultMaxQueued = 16 << 20;
+
+  /*!
+   * \brief Create a transport running on a shared loop.
+   * \param loop The loop. It must be running and outlive the transport.
+   * \param max_queued Maximum number of bytes waiting to be written.
+   * \return A UringTransport if the loop runs io_uring; an EpollTransport
+   * otherwise.
+   */
+  static std::unique_ptr<SocketTransport> Create(
+      EventLoop& loop, std::size_t max_queued = kDefaultMaxQueued);
+  /*!
+   * \brief Create a transport running its own loop.
+   * \param backend The I/O backend requested.
+   * \param max_queued Maximum number of bytes waiting to be written.
+   * \return A UringTransport if io_uring was requested and is supported; an
+   * EpollTransport otherwise.
+   */
+  static std::unique_ptr<SocketTransport> Create(
+      EventLoop::Backend backend, std::size_t max_queued = kDefaultMaxQueued);
+  /*!
+   * \brief Describe a failed system call.
+   * \param what What failed, e.g. "Cannot connect".
+   * \param error The errno value.
+   * \return The description, e.g. "Cannot connect: Connection refused".
+   */
+  static std::string ErrnoText(const char* what, int error);
+  /*!
+   * \brief Build the socket address of an IPv4 address and port.
+   * \param ip The IPv4 address, in dotted notation.
+   * \param port The TCP port.
+   * \param address Receives the socket address.
+   * \param error Receives the error description if the address is invalid.
+   * \return true if the address is valid; false otherwise.
+   */
+  static bool ParseAddress(const std::string& ip, std::uint16_t port,
+                           sockaddr_in& address, std::string& error);
+
+  /*!
+   * \brief Take over a connected socket, e.g. accepted by an EpollListener.
+   * A previous connection is closed.
+   * \param descriptor The non-blocking socket. The transport closes it.
+   * \return true if the transport carries the connection; false otherwise.
+   * \see GetLastError
+   */
+  virtual bool Attach(int descriptor) = 0;
+  /*!
+   * \brief Get the reason why the last call to Connect or Attach failed.
+   * \return The error description.
+   */
+  virtual const std::string& GetLastError() const = 0;
+
+  /*!
+   * \brief Queue a message. May be called from any thread, also before the
+   * connection is established.
+   * \param message The message.
+   * \return true if the message was queued; false if the transport is not
+   * connecting or connected, or too many bytes are waiting.
+   */
+  bool Send(std::string_view message) override;
+  /*!
+   * \brief Queue a message made of segments, written in order. May be called
+   * from any thread, also before the connection is established.
+   * \param segments The segments.
+   * \param count The number of segments.
+   * \return true if the message was queued; false if the transport is not
+   * connecting or connected, or too many bytes are waiting.
+   */
+  bool Send(const Segment* segments, std::size_t count) override;
+
+ protected:
+  /*!
+   * \brief Constructor.
+   * \param max_queued Maximum number of bytes waiting to be written.
+   */
+  explicit SocketTransport(std::size_t max_queued) : max_queued_(max_queued) {}
+
+  /*!
+   * \brief Called by Send, from any thread, when a message was queued while
+   * the queue was empty: the loop should take the batch.
+   */
+  virtual void OnQueued() = 0;
+  /*!
+   * \brief Empty the queue and accept messages, for a new connection.
+   */
+  void OpenQueue();
+  /*!
+   * \brief Empty the queue and refuse messages until the next OpenQueue.
+   */
+  void CloseQueue();
+  /*!
+   * \brief Take everything queued since the last call.
+   * \param sending Receives the messages. It must be cleared; it gets the
+   * buffers of the queue, which gets its own.
+   */
+  void TakeQueued(SendQueue& sending);
+
+  /*!
+   * \brief Start the loop owned by the transport, if any.
+   * \param own_loop The loop; nullptr for a shared loop, already running.
+   * \param descriptor A socket to close on failure; -1 for none.
+   * \param error Receives the error description on failure.
+   * \return true if the loop runs; false otherwise.
+   */
+  static bool StartOwnLoop(EventLoop* own_loop, int descriptor,
+                           std::string& error);
+  /*!
+   * \brief Set the options of a connection socket.
+   * \param descriptor The socket.
+   */
+  static void PrepareSocket(int descriptor);
+  /*!
+   * \brief Close a connection socket, reading its unread input first.
+   * \param descriptor The socket.
+   * \param shut_down Whether to shut the connection down before closing, so
+   * that the operations still pending on the socket fail.
+   */
+  static void DrainAndClose(int descriptor, bool shut_down = false);
+
+ private:
+  bool Queued(std::size_t bytes, bool& wake);
+
+ private:
+  std::size_t max_queued_;
+  // Messages queued by Send, taken by the loop thread.
+  std::mutex mutex_;
+  SendQueue queued_;
+  bool accepting_ = false;
+};
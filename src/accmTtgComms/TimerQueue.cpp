@@ -0,0 +1,75 @@
+#include "TimerQueue.h"
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include <algorithm>
+#include <ctime>
+#include <utility>
+
+namespace {
+constexpr std::int64_t kNanosecondsPerSecond = 1000000000;
+
+// Min-heap order: the earliest, then the first scheduled, on top.
+struct Later {
+  template <typename Entry>
+  bool operator()(const Entry& a, const Entry& b) const {
+    return a.due != b.due ? a.due > b.due : a.sequence > b.sequence;
+  }
+};
+}  // namespace
+
+TimerQueue::TimerQueue(EventLoop& loop)
+    : loop_(loop),
+      timer_(timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)) {
+  if (timer_ >= 0) loop_.Add(timer_, EPOLLIN, this);
+}
+
+TimerQueue::~TimerQueue() {
+  if (timer_ >= 0) close(timer_);
+}
+
+std::int64_t TimerQueue::Now() {
+  timespec time{};
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return time.tv_sec * kNanosecondsPerSecond + time.tv_nsec;
+}
+
+void TimerQueue::Schedule(std::int64_t due, Task task) {
+  heap_.push_back({due, sequence_++, std::move(task)});
+  std::push_heap(heap_.begin(), heap_.end(), Later());
+  if (armed_ == 0 || due < armed_) Arm(due);
+}
+
+void TimerQueue::Stop() {
+  loop_.Invoke([this]() {
+    if (timer_ >= 0) loop_.Remove(timer_);
+    heap_.clear();
+    armed_ = 0;
+  });
+}
+
+void TimerQueue::OnEvents(unsigned) {
+  std::uint64_t expirations;
+  ssize_t result = read(timer_, &expirations, sizeof(expirations));
+  static_cast<void>(result);
+  armed_ = 0;
+  std::int64_t now = Now();
+  while (!heap_.empty() && heap_.front().due <= now) {
+    std::pop_heap(heap_.begin(), heap_.end(), Later());
+    Task task = std::move(heap_.back().task);
+    heap_.pop_back();
+    // The task may schedule others.
+    task();
+  }
+  if (!heap_.empty()) Arm(heap_.front().due);
+}
+
+void TimerQueue::Arm(std::int64_t due) {
+  itimerspec spec{};
+  // 0 would disarm the timer.
+  due = std::max<std::int64_t>(due, 1);
+  spec.it_value.tv_sec = due / kNanosecondsPerSecond;
+  spec.it_value.tv_nsec = due % kNanosecondsPerSecond;
+  timerfd_settime(timer_, TFD_TIMER_ABSTIME, &spec, nullptr);
+  armed_ = due;
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "EventLoop.h"
+
+/*!
+ * \brief The TimerQueue class runs tasks at given times on an EventLoop.
+ *
+ * The tasks are kept in a binary heap ordered by due time, and a timerfd
+ * watched by the loop is armed for the earliest one, so the loop only wakes
+ * up when a task is due. Tasks due at the same time run in the order they
+ * were scheduled. Times are CLOCK_MONOTONIC nanoseconds (see Now).
+ */
+class TimerQueue : private EventLoop::Handler {
+ public:
+  using Task = EventLoop::Task;
+
+  /*!
+   * \brief Constructor.
+   * \param loop The loop running the tasks. It must outlive the queue.
+   */
+  explicit TimerQueue(EventLoop& loop);
+  /*!
+   * \brief Destructor. The queue must be stopped, or its loop not running.
+   */
+  ~TimerQueue() override;
+  /*!
+   * \brief Copy constructor is deleted.
+   */
+  TimerQueue(const TimerQueue&) = delete;
+  /*!
+   * \brief Assignment operator is deleted.
+   */
+  TimerQueue& operator=(const TimerQueue&) = delete;
+
+  /*!
+   * \brief Get the current time of the timers.
+   * \return The CLOCK_MONOTONIC time in nanoseconds.
+   */
+  static std::int64_t Now();
+
+  /*!
+   * \brief Run a task once the time is 'due'. Loop thread only.
+   * \param due The time, from Now.
+   * \param task The task.
+   */
+  void Schedule(std::int64_t due, Task task);
+  /*!
+   * \brief Drop the pending tasks and stop the timer, e.g. before the
+   * objects the tasks refer to are destroyed. May be called from any thread.
+   */
+  void Stop();
+  /*!
+   * \brief Get the loop running the tasks.
+   * \return The loop.
+   */
+  inline EventLoop& GetLoop() const { return loop_; }
+
+ private:
+  struct Entry {
+    std::int64_t due;
+    std::uint64_t sequence;
+    Task task;
+  };
+
+  void OnEvents(unsigned events) override;
+  void Arm(std::int64_t due);
+
+ private:
+  EventLoop& loop_;
+  int timer_;
+
+  // Loop thread only.
+  std::vector<Entry> heap_;
+  std::uint64_t sequence_ = 0;
+  std::int64_t armed_ = 0;
+};
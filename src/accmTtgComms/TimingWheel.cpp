@@ -0,0 +1,225 @@
+#include "TimingWheel.h"
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include <algorithm>
+#include "TimerQueue.h"
+
+namespace {
+constexpr std::int64_t kNanosecondsPerSecond = 1000000000;
+}  // namespace
+
+TimingWheel::TimingWheel(EventLoop& loop, std::int64_t resolution)
+    : loop_(loop),
+      resolution_(std::max<std::int64_t>(resolution, 1)),
+      origin_(TimerQueue::Now()),
+      timer_(timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)) {
+  for (Level& level : levels_) {
+    for (Link& slot : level) slot.prev = slot.next = &slot;
+  }
+  if (timer_ >= 0) loop_.Add(timer_, EPOLLIN, this);
+}
+
+TimingWheel::~TimingWheel() {
+  for (Level& level : levels_) {
+    for (Link& slot : level) Drain(slot);
+  }
+  if (timer_ >= 0) close(timer_);
+}
+
+void TimingWheel::Schedule(Timer& timer, std::int64_t due) {
+  if (stopped_) return;
+  timer.Cancel();
+  timer.wheel_ = this;
+  // Rounded up: a timer never expires early.
+  timer.expiry_ = TickOf(due + resolution_ - 1);
+  ++pending_;
+  Insert(timer);
+  // A timer beyond level 0 needs the next cascade at the latest.
+  std::uint64_t wake = timer.expiry_ - std::min(timer.expiry_, tick_) < kSlots
+                           ? std::max(timer.expiry_, tick_)
+                           : NextCascade();
+  if (armed_ == kNotArmed || wake < armed_) ArmAt(wake);
+}
+
+void TimingWheel::Cancel(Timer& timer) {
+  if (timer.wheel_ != this) return;
+  timer.prev->next = timer.next;
+  timer.next->prev = timer.prev;
+  timer.prev = timer.next = nullptr;
+  timer.wheel_ = nullptr;
+  --pending_;
+}
+
+void TimingWheel::Stop() {
+  loop_.Invoke([this]() {
+    if (timer_ >= 0) loop_.Remove(timer_);
+    for (Level& level : levels_) {
+      for (Link& slot : level) Drain(slot);
+    }
+    pending_ = 0;
+    stopped_ = true;
+    armed_ = kNotArmed;
+  });
+}
+
+void TimingWheel::OnEvents(unsigned) {
+  std::uint64_t expirations;
+  ssize_t result = read(timer_, &expirations, sizeof(expirations));
+  static_cast<void>(result);
+  armed_ = kNotArmed;
+  Advance(TickOf(TimerQueue::Now()));
+  Arm();
+}
+
+void TimingWheel::Insert(Timer& timer) {
+  // An overdue timer expires on the next tick processed.
+  std::uint64_t expiry = std::max(timer.expiry_, tick_);
+  std::uint64_t delta = expiry - tick_;
+  unsigned level = 0;
+  while (level + 1 < kLevels && delta >> (kSlotBits * (level + 1)) != 0) {
+    ++level;
+  }
+  if (level == kLevels - 1) {
+    // Beyond the wheel, the timer is inserted again when its slot expires.
+    constexpr std::uint64_t kMaxDelta =
+        (std::uint64_t{1} << (kSlotBits * kLevels)) - 1;
+    expiry = tick_ + std::min(delta, kMaxDelta);
+  }
+  std::uint64_t index = (expiry >> (kSlotBits * level)) & kSlotMask;
+  Link& slot = levels_[level][index];
+  timer.prev = slot.prev;
+  timer.next = &slot;
+  slot.prev->next = &timer;
+  slot.prev = &timer;
+  if (level == 0) busy_[index / 64] |= std::uint64_t{1} << (index % 64);
+}
+
+void TimingWheel::Advance(std::uint64_t tick) {
+  while (tick_ <= tick && !stopped_) {
+    if (pending_ == 0) {
+      // Nothing to cascade or expire on the way.
+      tick_ = tick + 1;
+      return;
+    }
+    std::uint64_t index = tick_ & kSlotMask;
+    if (index == 0) Cascade(1);
+    std::uint64_t busy = NextBusy(index);
+    if (busy != index) {
+      // Over the empty slots, up to the next cascade at most.
+      tick_ = std::min(tick_ + (busy - index), tick + 1);
+      continue;
+    }
+    // The callbacks may schedule timers in this very slot: it is emptied
+    // first, and they go to the next tick.
+    Link& slot = levels_[0][index];
+    busy_[index / 64] &= ~(std::uint64_t{1} << (index % 64));
+    Link expired;
+    expired.next = slot.next;
+    expired.prev = slot.prev;
+    expired.next->prev = expired.prev->next = &expired;
+    slot.prev = slot.next = &slot;
+    ++tick_;
+    Expire(expired);
+  }
+}
+
+void TimingWheel::Cascade(unsigned level) {
+  std::uint64_t index = (tick_ >> (kSlotBits * level)) & kSlotMask;
+  if (index == 0 && level + 1 < kLevels) Cascade(level + 1);
+  Link& slot = levels_[level][index];
+  while (slot.next != &slot) {
+    auto& timer = static_cast<Timer&>(*slot.next);
+    slot.next = timer.next;
+    slot.next->prev = &slot;
+    Insert(timer);
+  }
+}
+
+void TimingWheel::Expire(Link& expired) {
+  while (expired.next != &expired) {
+    auto& timer = static_cast<Timer&>(*expired.next);
+    expired.next = timer.next;
+    expired.next->prev = &expired;
+    if (timer.expiry_ >= tick_) {
+      // Beyond the wheel when it was scheduled.
+      Insert(timer);
+      continue;
+    }
+    timer.prev = timer.next = nullptr;
+    timer.wheel_ = nullptr;
+    --pending_;
+    // The callback may cancel, schedule or destroy any timer, this one
+    // included, or stop the wheel.
+    if (timer.callback_) timer.callback_();
+    if (stopped_) {
+      Drain(expired);
+      return;
+    }
+  }
+}
+
+void TimingWheel::Drain(Link& list) {
+  while (list.next != &list) {
+    auto& timer = static_cast<Timer&>(*list.next);
+    list.next = timer.next;
+    list.next->prev = &list;
+    timer.prev = timer.next = nullptr;
+    timer.wheel_ = nullptr;
+  }
+}
+
+void TimingWheel::Arm() {
+  if (pending_ == 0 || stopped_) {
+    if (armed_ != kNotArmed) {
+      itimerspec spec{};
+      timerfd_settime(timer_, TFD_TIMER_ABSTIME, &spec, nullptr);
+      armed_ = kNotArmed;
+    }
+    return;
+  }
+  // The next busy slot of level 0, or else the next cascade.
+  std::uint64_t index = tick_ & kSlotMask;
+  std::uint64_t busy = NextBusy(index);
+  ArmAt(busy < kSlots ? tick_ + (busy - index) : NextCascade());
+}
+
+std::uint64_t TimingWheel::NextBusy(std::uint64_t index) {
+  while (index < kSlots) {
+    std::uint64_t word = busy_[index / 64] >> (index % 64);
+    if (word == 0) {
+      index = (index / 64 + 1) * 64;
+      continue;
+    }
+    index += __builtin_ctzll(word);
+    Link& slot = levels_[0][index];
+    if (slot.next != &slot) return index;
+    // Its timers were cancelled.
+    busy_[index / 64] &= ~(std::uint64_t{1} << (index % 64));
+    ++index;
+  }
+  return kSlots;
+}
+
+void TimingWheel::ArmAt(std::uint64_t tick) {
+  if (tick == armed_) return;
+  // 0 would disarm the timer.
+  std::int64_t due = std::max<std::int64_t>(
+      origin_ + static_cast<std::int64_t>(tick) * resolution_, 1);
+  itimerspec spec{};
+  spec.it_value.tv_sec = due / kNanosecondsPerSecond;
+  spec.it_value.tv_nsec = due % kNanosecondsPerSecond;
+  timerfd_settime(timer_, TFD_TIMER_ABSTIME, &spec, nullptr);
+  armed_ = tick;
+}
+
+std::uint64_t TimingWheel::NextCascade() const {
+  // tick_ itself if it was not processed yet.
+  return (tick_ + kSlotMask) & ~kSlotMask;
+}
+
+std::uint64_t TimingWheel::TickOf(std::int64_t time) const {
+  return time > origin_
+             ? static_cast<std::uint64_t>((time - origin_) / resolution_)
+             : 0;
+}
@@ -0,0 +1,179 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include "EventLoop.h"
+
+/*!
+ * \brief The TimingWheel class runs large numbers of timers on an EventLoop,
+ * e.g. one acknowledgment timeout per message in flight, with O(1) schedule
+ * and cancel.
+ *
+ * Time is cut in ticks of 'resolution'. The wheel has 4 levels of 256 slots:
+ * level 0 holds the timers due in the next 256 ticks, one slot per tick;
+ * level 1 the timers due in the next 2^16 ticks, one slot per 256 ticks, and
+ * so on up to 2^32 ticks (about 49 days at 1 ms); later timers are due then.
+ * Every 256 ticks the next slot of level 1 is cascaded into level 0 (and
+ * every 2^16 ticks, the next slot of level 2 into level 1...), so a timer is
+ * moved at most 3 times before it expires.
+ *
+ * The timers are intrusive: a Timer is a node of its slot list, owned by its
+ * user, so scheduling and cancelling neither allocates nor searches. A timer
+ * never expires early; it expires at most one tick late, plus the loop
+ * latency. The loop wakes up (on a timerfd) for the next busy slot of level
+ * 0, or the next cascade if level 0 is empty, and not at all when no timer is
+ * pending; empty slots are skipped with a bitmap. Times are TimerQueue::Now
+ * nanoseconds. Everything but Stop runs on the loop thread.
+ */
+class TimingWheel : private EventLoop::Handler {
+ private:
+  // A node of a circular slot list; a slot is its own sentinel node.
+  struct Link {
+    Link* prev = nullptr;
+    Link* next = nullptr;
+  };
+
+ public:
+  /*!
+   * \brief The Timer class is a timer of a TimingWheel. It is cancelled on
+   * destruction, so its user may simply own it.
+   */
+  class Timer : private Link {
+   public:
+    using Callback = std::function<void()>;
+
+    /*!
+     * \brief Constructor.
+     * \param callback The function called when the timer expires.
+     */
+    explicit Timer(Callback callback = nullptr)
+        : callback_(std::move(callback)) {}
+    /*!
+     * \brief Destructor. Cancels the timer.
+     */
+    ~Timer() { Cancel(); }
+    /*!
+     * \brief Copy constructor is deleted.
+     */
+    Timer(const Timer&) = delete;
+    /*!
+     * \brief Assignment operator is deleted.
+     */
+    Timer& operator=(const Timer&) = delete;
+
+    /*!
+     * \brief Set the function called when the timer expires.
+     * \param callback The function.
+     */
+    inline void SetCallback(Callback callback) {
+      callback_ = std::move(callback);
+    }
+    /*!
+     * \brief Check if the timer is scheduled and did not expire yet.
+     * \return true if it is pending; false otherwise.
+     */
+    inline bool IsPending() const { return wheel_ != nullptr; }
+    /*!
+     * \brief Cancel the timer if it is pending.
+     */
+    inline void Cancel() {
+      if (wheel_) wheel_->Cancel(*this);
+    }
+
+   private:
+    friend class TimingWheel;
+
+    TimingWheel* wheel_ = nullptr;
+    std::uint64_t expiry_ = 0;
+    Callback callback_;
+  };
+
+  /*!
+   * \brief Constructor.
+   * \param loop The loop running the timers. It must outlive the wheel.
+   * \param resolution The length of a tick in nanoseconds.
+   */
+  explicit TimingWheel(EventLoop& loop, std::int64_t resolution = 1000000);
+  /*!
+   * \brief Destructor. The wheel must be stopped, or its loop not running.
+   * The pending timers are cancelled.
+   */
+  ~TimingWheel() override;
+  /*!
+   * \brief Copy constructor is deleted.
+   */
+  TimingWheel(const TimingWheel&) = delete;
+  /*!
+   * \brief Assignment operator is deleted.
+   */
+  TimingWheel& operator=(const TimingWheel&) = delete;
+
+  /*!
+   * \brief Expire a timer once the time is 'due'; if it is pending, it is
+   * rescheduled. Loop thread only; ignored once the wheel is stopped.
+   * \param timer The timer. It must stay alive until it expires or is
+   * cancelled.
+   * \param due The time, from TimerQueue::Now.
+   */
+  void Schedule(Timer& timer, std::int64_t due);
+  /*!
+   * \brief Cancel a timer if it is pending. Loop thread only.
+   * \param timer The timer.
+   */
+  void Cancel(Timer& timer);
+  /*!
+   * \brief Cancel the pending timers and stop the wheel, e.g. before the
+   * objects the timers refer to are destroyed. May be called from any thread.
+   */
+  void Stop();
+  /*!
+   * \brief Get the number of pending timers. Loop thread only.
+   * \return The number of timers.
+   */
+  inline std::size_t GetPendingCount() const { return pending_; }
+  /*!
+   * \brief Get the loop running the timers.
+   * \return The loop.
+   */
+  inline EventLoop& GetLoop() const { return loop_; }
+
+ private:
+  static constexpr unsigned kLevels = 4;
+  static constexpr unsigned kSlotBits = 8;
+  static constexpr std::uint64_t kSlots = 1 << kSlotBits;
+  static constexpr std::uint64_t kSlotMask = kSlots - 1;
+  static constexpr std::uint64_t kNotArmed = UINT64_MAX;
+
+  using Level = std::array<Link, kSlots>;
+
+  void OnEvents(unsigned events) override;
+  void Insert(Timer& timer);
+  void Advance(std::uint64_t tick);
+  void Cascade(unsigned level);
+  void Expire(Link& expired);
+  void Drain(Link& list);
+  void Arm();
+  // The first busy slot of level 0 from 'index' on; kSlots if none.
+  std::uint64_t NextBusy(std::uint64_t index);
+  void ArmAt(std::uint64_t tick);
+  std::uint64_t NextCascade() const;
+  std::uint64_t TickOf(std::int64_t time) const;
+
+ private:
+  EventLoop& loop_;
+  const std::int64_t resolution_;
+  const std::int64_t origin_;
+  int timer_;
+
+  // Loop thread only.
+  std::array<Level, kLevels> levels_;
+  // Busy slots of level 0; a bit may be stale once its timers are cancelled.
+  std::array<std::uint64_t, kSlots / 64> busy_{};
+  // The next tick to process.
+  std::uint64_t tick_ = 0;
+  // The tick the timerfd is armed for.
+  std::uint64_t armed_ = kNotArmed;
+  std::size_t pending_ = 0;
+  bool stopped_ = false;
+};
@@ -0,0 +1,278 @@
+#include "UringTransport.h"
+#include <unistd.h>
+#include <cerrno>
+#include <cstdint>
+#include <thread>
+#include <utility>
+
+UringTransport::UringTransport(std::size_t max_queued)
+    : SocketTransport(max_queued),
+      own_loop_(std::make_unique<EventLoop>(EventLoop::Backend::IO_URING)),
+      loop_(own_loop_.get()) {}
+
+UringTransport::UringTransport(EventLoop& loop, std::size_t max_queued)
+    : SocketTransport(max_queued), loop_(&loop) {}
+
+UringTransport::~UringTransport() {
+  Disconnect();
+  // The kernel writes to the operations until they complete.
+  bool in_flight = true;
+  while (true) {
+    loop_->Invoke([this, &in_flight]() {
+      if (!loop_->GetRing()) {
+        // Cancelled with the ring.
+        connect_.pending = receive_.pending = send_.pending = false;
+      }
+      in_flight = InFlight();
+    });
+    if (!in_flight) break;
+    std::this_thread::yield();
+  }
+}
+
+void UringTransport::SetReceiver(Receiver receiver) {
+  receiver_ = std::move(receiver);
+}
+
+void UringTransport::SetClosedHandler(ClosedHandler handler) {
+  closed_handler_ = std::move(handler);
+}
+
+bool UringTransport::Connect(const std::string& ip, std::uint16_t port) {
+  Disconnect();
+
+  sockaddr_in address;
+  if (!ParseAddress(ip, port, address, last_error_)) return false;
+  if (!StartLoop(-1)) return false;
+
+  // The ring connects it, never blocking: on a non-blocking socket, a
+  // connection completed at once may be reported as EISCONN.
+  int descriptor = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (descriptor < 0) {
+    last_error_ = ErrnoText("Cannot create the socket", errno);
+    return false;
+  }
+  PrepareSocket(descriptor);
+  Open(descriptor, &address);
+  return true;
+}
+
+bool UringTransport::Attach(int descriptor) {
+  Disconnect();
+  if (!StartLoop(descriptor)) return false;
+  PrepareSocket(descriptor);
+  Open(descriptor, nullptr);
+  return true;
+}
+
+bool UringTransport::StartLoop(int descriptor) {
+  if (!StartOwnLoop(own_loop_.get(), descriptor, last_error_)) return false;
+  if (loop_->GetRing()) return true;
+  last_error_ = "The event loop does not run io_uring";
+  if (descriptor >= 0) close(descriptor);
+  return false;
+}
+
+void UringTransport::Open(int descriptor, const sockaddr_in* address) {
+  OpenQueue();
+  last_error_.clear();
+  bool connects = address != nullptr;
+  sockaddr_in peer = connects ? *address : sockaddr_in{};
+  loop_->Post([this, descriptor, connects, peer]() {
+    next_socket_ = descriptor;
+    next_connects_ = connects;
+    next_address_ = peer;
+    Start();
+  });
+}
+
+void UringTransport::Start() {
+  if (next_socket_ < 0 || InFlight()) return;
+  socket_ = next_socket_;
+  next_socket_ = -1;
+  framer_.Reset();
+  sending_.Clear();
+  if (!next_connects_) {
+    connected_.store(true, std::memory_order_release);
+    Receive();
+    Flush();
+    return;
+  }
+  // Read by the kernel until the connection completes.
+  address_ = next_address_;
+  io_uring_sqe* operation = Prepare(connect_);
+  if (!operation) return;
+  operation->opcode = IORING_OP_CONNECT;
+  operation->addr = reinterpret_cast<std::uintptr_t>(&address_);
+  operation->off = sizeof(address_);
+}
+
+void UringTransport::Disconnect() {
+  CloseQueue();
+  loop_->Invoke([this]() { Shutdown(); });
+}
+
+void UringTransport::OnQueued() {
+  loop_->Post([this]() {
+    if (socket_ >= 0 && IsConnected()) Flush();
+  });
+}
+
+void UringTransport::Complete(Operation& operation, int result,
+                              unsigned flags) {
+  if (!(flags & IORING_CQE_F_MORE)) operation.pending = false;
+  (this->*operation.on_completion)(result, flags);
+  // The next connection may be waiting for this operation.
+  Start();
+}
+
+io_uring_sqe* UringTransport::Prepare(Operation& operation) {
+  io_uring_sqe* prepared = loop_->GetRing()->Prepare(&operation);
+  if (!prepared) {
+    Close("The submission queue is full");
+    return nullptr;
+  }
+  operation.pending = true;
+  prepared->fd = socket_;
+  return prepared;
+}
+
+void UringTransport::Receive() {
+  IoRing* ring = loop_->GetRing();
+  io_uring_sqe* operation = Prepare(receive_);
+  if (!operation) return;
+  operation->opcode = IORING_OP_RECV;
+  operation->flags = IOSQE_BUFFER_SELECT;
+  operation->buf_group = IoRing::kBufferGroup;
+  // Completes with every chunk of data until cancelled.
+  if (ring->HasMultishotReceive()) operation->ioprio = IORING_RECV_MULTISHOT;
+}
+
+void UringTransport::Flush() {
+  // The send in flight flushes again once it completes.
+  if (send_.pending) return;
+  if (sending_.IsWritten()) {
+    // Take everything queued since the last send, keeping both buffers.
+    sending_.Clear();
+    TakeQueued(sending_);
+    if (sending_.IsWritten()) return;
+  }
+
+  header_ = msghdr{};
+  header_.msg_iov = vectors_;
+  header_.msg_iovlen = sending_.Gather(vectors_, kMaxVectors);
+  io_uring_sqe* operation = Prepare(send_);
+  if (!operation) return;
+  operation->opcode = IORING_OP_SENDMSG;
+  operation->addr = reinterpret_cast<std::uintptr_t>(&header_);
+  operation->len = 1;
+  operation->msg_flags = MSG_NOSIGNAL;
+}
+
+void UringTransport::OnConnected(int result, unsigned) {
+  if (socket_ < 0) return;
+  if (result < 0 && result != -EISCONN) {
+    Close(ErrnoText("Cannot connect", -result));
+    return;
+  }
+  connected_.store(true, std::memory_order_release);
+  Receive();
+  // Messages queued meanwhile.
+  if (socket_ >= 0) Flush();
+}
+
+void UringTransport::OnReceived(int result, unsigned flags) {
+  IoRing* ring = loop_->GetRing();
+  if (flags & IORING_CQE_F_BUFFER) {
+    // The framer copies the data, so the buffer goes back at once.
+    unsigned id = flags >> IORING_CQE_BUFFER_SHIFT;
+    if (socket_ >= 0 && result > 0) {
+      framer_.Append(std::string_view(ring->GetBuffer(id),
+                                      static_cast<std::size_t>(result)));
+    }
+    ring->ReleaseBuffer(id);
+  }
+  if (socket_ < 0) return;
+  if (result == -EINVAL && !receive_.pending && ring->HasMultishotReceive()) {
+    // Before Linux 6.0: one receive at a time.
+    ring->DisableMultishotReceive();
+    Receive();
+    return;
+  }
+  if (result == -ENOBUFS || result == -EINTR || result == -EAGAIN) {
+    // Every buffer is in use: wait for the ones being released.
+    if (!receive_.pending) Receive();
+    return;
+  }
+  if (result == 0) {
+    Close("Connection closed by the peer");
+    return;
+  }
+  if (result < 0) {
+    Close(ErrnoText("Cannot receive", -result));
+    return;
+  }
+
+  std::string_view message;
+  while (framer_.Next(message)) {
+    if (receiver_) receiver_(message);
+    // The receiver may have disconnected.
+    if (socket_ < 0) return;
+  }
+  if (framer_.HasError()) {
+    Close("Malformed POCT1-A stream");
+    return;
+  }
+  if (!receive_.pending) Receive();
+}
+
+void UringTransport::OnSent(int result, unsigned) {
+  if (socket_ < 0) {
+    // Release the shared segments, kept while the kernel read them.
+    sending_.Clear();
+    return;
+  }
+  if (result < 0 && result != -EINTR && result != -EAGAIN) {
+    Close(ErrnoText("Cannot send", -result));
+    return;
+  }
+  if (result > 0) sending_.Consume(static_cast<std::size_t>(result));
+  Flush();
+}
+
+bool UringTransport::InFlight() const {
+  return connect_.pending || receive_.pending || send_.pending;
+}
+
+void UringTransport::Shutdown() {
+  connected_.store(false, std::memory_order_release);
+  if (next_socket_ >= 0) {
+    close(next_socket_);
+    next_socket_ = -1;
+  }
+  if (socket_ >= 0) {
+    IoRing* ring = loop_->GetRing();
+    bool cancelled = true;
+    for (Operation* operation : {&connect_, &receive_, &send_}) {
+      if (!operation->pending) continue;
+      io_uring_sqe* cancel = ring ? ring->Prepare(nullptr) : nullptr;
+      if (!cancel) {
+        cancelled = false;
+        continue;
+      }
+      cancel->opcode = IORING_OP_ASYNC_CANCEL;
+      cancel->addr = reinterpret_cast<std::uintptr_t>(operation);
+    }
+    // Without a cancel, the operations fail once the socket is shut down.
+    DrainAndClose(socket_, !cancelled);
+    socket_ = -1;
+  }
+  // Release the shared segments, unless the kernel still reads them.
+  if (!send_.pending) sending_.Clear();
+  CloseQueue();
+}
+
+void UringTransport::Close(const std::string& reason) {
+  Shutdown();
+  if (closed_handler_) closed_handler_(reason);
+}
@@ -0,0 +1,165 @@
+#pragma once
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include "EventLoop.h"
+#include "IoRing.h"
+#include "Poct1Framer.h"
+#include "SendQueue.h"
+#include "SocketTransport.h"
+
+/*!
+ * \brief The UringTransport class carries POCT1-A messages over a TCP
+ * connection through the io_uring instance of an EventLoop (see IoRing).
+ *
+ * It behaves like EpollTransport, but instead of waiting for readiness and
+ * then calling recv and sendmsg, it keeps operations in flight in the ring:
+ * one receive that completes with every chunk of data, picked from the
+ * buffers registered by the ring, and at most one vectored send of everything
+ * queued so far. The operations of all the connections of a loop are
+ * submitted together, once per wake-up, so many devices cost a few system
+ * calls instead of several each.
+ *
+ * The loop must run io_uring; SocketTransport::Create falls back to an
+ * EpollTransport otherwise. The receiver and the closed handler run on the
+ * loop thread and must not block; the transport must not be destroyed on its
+ * loop thread.
+ */
+class UringTransport : public SocketTransport {
+ public:
+  /*!
+   * \brief Constructor of a transport running its own loop.
+   * \param max_queued Maximum number of bytes waiting to be written.
+   */
+  explicit UringTransport(std::size_t max_queued = kDefaultMaxQueued);
+  /*!
+   * \brief Constructor of a transport running on a shared loop.
+   * \param loop The loop. It must run io_uring and outlive the transport.
+   * \param max_queued Maximum number of bytes waiting to be written.
+   */
+  explicit UringTransport(EventLoop& loop,
+                          std::size_t max_queued = kDefaultMaxQueued);
+  /*!
+   * \brief Destructor. Closes the connection and waits for the operations in
+   * flight to complete.
+   */
+  ~UringTransport() override;
+  /*!
+   * \brief Copy constructor is deleted.
+   */
+  UringTransport(const UringTransport&) = delete;
+  /*!
+   * \brief Assignment operator is deleted.
+   */
+  UringTransport& operator=(const UringTransport&) = delete;
+
+  /*!
+   * \brief Set the function called with every inbound message. Must be called
+   * before Connect.
+   * \param receiver The function.
+   */
+  void SetReceiver(Receiver receiver) override;
+  /*!
+   * \brief Set the function called when the connection fails or drops. Must
+   * be called before Connect.
+   * \param handler The function.
+   */
+  void SetClosedHandler(ClosedHandler handler) override;
+
+  /*!
+   * \brief Start connecting to a peer. A previous connection is closed.
+   * \param ip The IPv4 address of the peer.
+   * \param port The TCP port of the peer.
+   * \return true if the connection is under way; false otherwise.
+   * \see GetLastError
+   */
+  bool Connect(const std::string& ip, std::uint16_t port) override;
+  /*!
+   * \brief Take over a connected socket, e.g. accepted by an EpollListener.
+   * A previous connection is closed.
+   * \param descriptor The non-blocking socket. The transport closes it.
+   * \return true if the transport carries the connection; false otherwise.
+   * \see GetLastError
+   */
+  bool Attach(int descriptor) override;
+  /*!
+   * \brief Close the connection. Unsent messages are dropped. May be called
+   * from the receiver; the closed handler is not called.
+   */
+  void Disconnect() override;
+  /*!
+   * \brief Check if the connection is established.
+   * \return true if the connection is established; false otherwise.
+   */
+  inline bool IsConnected() const override {
+    return connected_.load(std::memory_order_acquire);
+  }
+
+  /*!
+   * \brief Get the reason why the last call to Connect or Attach failed.
+   * \return The error description.
+   */
+  inline const std::string& GetLastError() const override {
+    return last_error_;
+  }
+
+ private:
+  // An operation in flight; the kernel refers to it until it completes.
+  struct Operation : IoRing::Completion {
+    using Handler = void (UringTransport::*)(int result, unsigned flags);
+    Operation(UringTransport* owner, Handler handler)
+        : transport(owner), on_completion(handler) {}
+    void OnCompletion(int result, unsigned flags) override {
+      transport->Complete(*this, result, flags);
+    }
+
+    UringTransport* transport;
+    Handler on_completion;
+    bool pending = false;
+  };
+
+  static constexpr std::size_t kMaxVectors = 64;
+
+  bool StartLoop(int descriptor);
+  void OnQueued() override;
+  void Open(int descriptor, const sockaddr_in* address);
+  void Start();
+  void Complete(Operation& operation, int result, unsigned flags);
+  io_uring_sqe* Prepare(Operation& operation);
+  void Receive();
+  void Flush();
+  void OnConnected(int result, unsigned flags);
+  void OnReceived(int result, unsigned flags);
+  void OnSent(int result, unsigned flags);
+  bool InFlight() const;
+  void Shutdown();
+  void Close(const std::string& reason);
+
+ private:
+  std::unique_ptr<EventLoop> own_loop_;
+  EventLoop* loop_;
+  Receiver receiver_;
+  ClosedHandler closed_handler_;
+  std::string last_error_;
+  std::atomic<bool> connected_{false};
+
+  // Loop thread only. A new connection starts once the operations of the
+  // previous one completed.
+  int next_socket_ = -1;
+  bool next_connects_ = false;
+  sockaddr_in next_address_{};
+  int socket_ = -1;
+  sockaddr_in address_{};
+  Operation connect_{this, &UringTransport::OnConnected};
+  Operation receive_{this, &UringTransport::OnReceived};
+  Operation send_{this, &UringTransport::OnSent};
+  // Written by the send in flight.
+  SendQueue sending_;
+  msghdr header_{};
+  iovec vectors_[kMaxVectors];
+  Poct1Framer framer_;
+};
@@ -0,0 +1,97 @@
+#include "WorkStealingPool.h"
+#include <utility>
+
+namespace {
+thread_local const WorkStealingPool* current_pool = nullptr;
+thread_local std::size_t current_index = 0;
+}  // namespace
+
+WorkStealingPool::WorkStealingPool(std::size_t size) {
+  if (size == 0) size = std::thread::hardware_concurrency();
+  if (size == 0) size = 1;
+  queues_.reserve(size);
+  for (std::size_t i = 0; i < size; ++i) {
+    queues_.push_back(std::make_unique<Queue>());
+  }
+  threads_.reserve(size);
+  for (std::size_t i = 0; i < size; ++i) {
+    threads_.emplace_back(&WorkStealingPool::Run, this, i);
+  }
+}
+
+WorkStealingPool::~WorkStealingPool() { Stop(); }
+
+int WorkStealingPool::GetThreadIndex() const {
+  return current_pool == this ? static_cast<int>(current_index) : -1;
+}
+
+void WorkStealingPool::Post(Task task) {
+  if (stopping_.load(std::memory_order_acquire)) return;
+  std::size_t index =
+      current_pool == this
+          ? current_index
+          : next_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+  {
+    Queue& queue = *queues_[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.tasks.push_back(std::move(task));
+  }
+  queued_.fetch_add(1);
+  if (sleeping_.load() > 0) {
+    // The sleeping thread holds the lock until it waits.
+    std::lock_guard<std::mutex> lock(idle_mutex_);
+    idle_.notify_one();
+  }
+}
+
+void WorkStealingPool::Stop() {
+  if (threads_.empty()) return;
+  stopping_.store(true, std::memory_order_release);
+  {
+    std::lock_guard<std::mutex> lock(idle_mutex_);
+    idle_.notify_all();
+  }
+  for (std::thread& thread : threads_) thread.join();
+  threads_.clear();
+}
+
+void WorkStealingPool::Run(std::size_t index) {
+  current_pool = this;
+  current_index = index;
+  Task task;
+  while (true) {
+    if (Take(index, task)) {
+      task();
+      task = nullptr;
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(idle_mutex_);
+    if (stopping_.load(std::memory_order_acquire) && queued_.load() == 0) {
+      break;
+    }
+    sleeping_.fetch_add(1);
+    idle_.wait(lock, [this]() {
+      return queued_.load() > 0 || stopping_.load(std::memory_order_acquire);
+    });
+    sleeping_.fetch_sub(1);
+  }
+  current_pool = nullptr;
+}
+
+bool WorkStealingPool::Take(std::size_t index, Task& task) {
+  for (std::size_t i = 0; i < queues_.size(); ++i) {
+    Queue& queue = *queues_[(index + i) % queues_.size()];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) continue;
+    if (i == 0) {
+      task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+    } else {
+      task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+    }
+    queued_.fetch_sub(1);
+    return true;
+  }
+  return false;
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*!
+ * \brief The WorkStealingPool class runs short tasks on a fixed set of
+ * threads, by default one per core.
+ *
+ * Every thread has its own queue: a task posted from a pool thread goes to
+ * the queue of that thread, and a task posted from elsewhere to the queues in
+ * turn. A thread runs the tasks of its queue in order and, once it is empty,
+ * steals the latest task of another queue, so a long task only delays the
+ * tasks queued behind it until an idle thread takes them. Idle threads sleep
+ * until a task is posted.
+ *
+ * Tasks should be short and must not block: work made of many steps posts
+ * its next step rather than looping, so that it takes turns with the rest.
+ */
+class WorkStealingPool {
+ public:
+  using Task = std::function<void()>;
+
+  /*!
+   * \brief Constructor. Starts the threads.
+   * \param size The number of threads; 0 for one per core.
+   */
+  explicit WorkStealingPool(std::size_t size = 0);
+  /*!
+   * \brief Destructor. Stops the threads.
+   */
+  ~WorkStealingPool();
+  /*!
+   * \brief Copy constructor is deleted.
+   */
+  WorkStealingPool(const WorkStealingPool&) = delete;
+  /*!
+   * \brief Assignment operator is deleted.
+   */
+  WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+  /*!
+   * \brief Get the number of threads.
+   * \return The number of threads.
+   */
+  inline std::size_t Size() const { return queues_.size(); }
+  /*!
+   * \brief Get the index of the calling thread in the pool.
+   * \return The index, below Size(); -1 if the caller is not a thread of the
+   * pool.
+   */
+  int GetThreadIndex() const;
+
+  /*!
+   * \brief Run a task on a thread of the pool. May be called from any thread;
+   * what the caller did before is visible to the task.
+   * \param task The task. It is dropped if the pool is stopping.
+   */
+  void Post(Task task);
+  /*!
+   * \brief Stop the threads. The tasks queued are run first; those they post
+   * are dropped. Must not be called from a thread of the pool.
+   */
+  void Stop();
+
+ private:
+  // The tasks of a thread: it takes the oldest, thieves the latest.
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  void Run(std::size_t index);
+  bool Take(std::size_t index, Task& task);
+
+ private:
+  std::vector<std::unique_ptr<Queue>> queues_;
+  std::vector<std::thread> threads_;
+  std::atomic<std::size_t> next_{0};
+  // Tasks in the queues; sequentially consistent with sleeping_, so that a
+  // thread never sleeps while a task waits.
+  std::atomic<std::size_t> queued_{0};
+  std::atomic<std::size_t> sleeping_{0};
+  std::atomic<bool> stopping_{false};
+  std::mutex idle_mutex_;
+  std::condition_variable idle_;
+};
@@ -67,6 +67,20 @@ bool DbManager::CheckUser(QString user, QString pass) {
     qDebug() << "DB Error!! Select User: " << query.lastError();
   return success;
 }
+bool DbManager::GetCommsConf(QString& ip, int& port) {
+  bool success = false;
+  QSqlQuery query;
+  query.prepare("SELECT ip, port FROM commsConf ORDER BY id LIMIT 1");
+  if (query.exec()) {
+    if (query.next()) {
+      ip = query.value(0).toString();
+      port = query.value(1).toInt();
+      success = true;
+    }
+  } else
+    qDebug() << "DB Error!! Select comms conf: " << query.lastError();
+  return success;
+}
 QString DbManager::EncryptPass(QString pass) {
   // Need salty salt :D
   return QString(
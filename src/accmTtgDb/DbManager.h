@@ -10,6 +10,7 @@ class DbManager : public IDb {
   void StartUp() override;
   bool AddUser(QString user, QString pass) override;
   bool CheckUser(QString user, QString pass) override;
+  bool GetCommsConf(QString& ip, int& port) override;
 
  private:
   void CreateUsersTable();